@@ -481,7 +481,7 @@ int handle_data_set_list(InvocationContext &context)
   std::vector<ZDSEntry> entries;
 
   const auto num_attr_fields = 10;
-  bool emit_csv = context.get<bool>("response-format-csv", false);
+  const auto output_mode = context.output_mode();
   rc = zds_list_data_sets(&zds, dsn, entries, attributes);
   if (RTNCD_SUCCESS == rc || RTNCD_WARNING == rc)
   {
@@ -491,7 +491,11 @@ int handle_data_set_list(InvocationContext &context)
 
     for (auto &entry : entries)
     {
-      if (emit_csv)
+      if (output_mode == InvocationContext::OutputMode_Structured)
+      {
+        entries_array->push(build_ds_object(entry, attributes));
+      }
+      else if (output_mode == InvocationContext::OutputMode_Csv)
       {
         fields.push_back(entry.name);
         if (attributes)
@@ -533,15 +537,15 @@ int handle_data_set_list(InvocationContext &context)
           context.output_stream() << std::left << std::setw(44) << entry.name << std::endl;
         }
       }
-
-      const auto ds_obj = build_ds_object(entry, attributes);
-      entries_array->push(ds_obj);
     }
 
-    const auto result = obj();
-    result->set("items", entries_array);
-    result->set("returnedRows", i64(entries.size()));
-    context.set_object(result);
+    if (output_mode == InvocationContext::OutputMode_Structured)
+    {
+      const auto result = obj();
+      result->set("items", entries_array);
+      result->set("returnedRows", i64(entries.size()));
+      context.set_object(result);
+    }
   }
   if (RTNCD_WARNING == rc)
   {
@@ -575,7 +579,7 @@ int handle_data_set_list_members(InvocationContext &context)
   long long max_entries = context.get<long long>("max-entries", 0);
   bool warn = context.get<bool>("warn", true);
   bool attributes = context.get<bool>("attributes", false);
-  bool emit_csv = context.get<bool>("response-format-csv", false);
+  const auto output_mode = context.output_mode();
   std::string pattern = context.get<std::string>("pattern", "");
 
   ZDS zds{};
@@ -592,7 +596,11 @@ int handle_data_set_list_members(InvocationContext &context)
     const auto entries_array = arr();
     for (std::vector<ZDSMem>::iterator it = members.begin(); it != members.end(); ++it)
     {
-      if (emit_csv)
+      if (output_mode == InvocationContext::OutputMode_Structured)
+      {
+        entries_array->push(build_member_object(*it, attributes));
+      }
+      else if (output_mode == InvocationContext::OutputMode_Csv)
       {
         fields.push_back(it->name);
 
@@ -636,14 +644,15 @@ int handle_data_set_list_members(InvocationContext &context)
           context.output_stream() << std::left << std::setw(12) << it->name << std::endl;
         }
       }
+    }
 
-      const auto entry = build_member_object(*it, attributes);
-      entries_array->push(entry);
+    if (output_mode == InvocationContext::OutputMode_Structured)
+    {
+      const auto result = obj();
+      result->set("items", entries_array);
+      result->set("returnedRows", i64(members.size()));
+      context.set_object(result);
     }
-    const auto result = obj();
-    result->set("items", entries_array);
-    result->set("returnedRows", i64(members.size()));
-    context.set_object(result);
   }
   if (RTNCD_WARNING == rc)
   {
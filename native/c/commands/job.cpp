@@ -15,6 +15,7 @@
 #include "../zjb.hpp"
 #include "../zusf.hpp"
 #include "../zut.hpp"
+#include "../zbase64.h"
 #include <regex.h>
 
 using namespace ast;
@@ -68,12 +69,12 @@ int handle_job_list(InvocationContext &context)
 
   if (RTNCD_SUCCESS == rc || RTNCD_WARNING == rc)
   {
-    bool emit_csv = context.get<bool>("response-format-csv", false);
+    const auto output_mode = context.output_mode();
     const auto entries_array = arr();
 
     for (const auto &job : jobs)
     {
-      if (emit_csv)
+      if (output_mode == InvocationContext::OutputMode_Csv)
       {
         std::vector<std::string> fields;
         fields.reserve(5);
@@ -83,10 +84,12 @@ int handle_job_list(InvocationContext &context)
         fields.push_back(job.status);
         fields.push_back(job.retcode);
         context.output_stream() << zut_format_as_csv(fields) << std::endl;
+        continue;
       }
-      else
+      if (output_mode == InvocationContext::OutputMode_Text)
       {
         context.output_stream() << job.jobid << " " << job.jobname << " " << job.owner << " " << std::left << std::setw(7) << job.status << " " << job.retcode << std::endl;
+        continue;
       }
 
       const auto entry = obj();
@@ -112,9 +115,12 @@ int handle_job_list(InvocationContext &context)
       entries_array->push(entry);
     }
 
-    const auto result = obj();
-    result->set("items", entries_array);
-    context.set_object(result);
+    if (output_mode == InvocationContext::OutputMode_Structured)
+    {
+      const auto result = obj();
+      result->set("items", entries_array);
+      context.set_object(result);
+    }
   }
   if (RTNCD_WARNING == rc)
   {
@@ -150,25 +156,28 @@ int handle_job_list_files(InvocationContext &context)
   rc = zjb_list_dds(&zjb, jobid, job_dds);
   if (RTNCD_SUCCESS == rc || RTNCD_WARNING == rc)
   {
-    bool emit_csv = context.get<bool>("response-format-csv", false);
+    const auto output_mode = context.output_mode();
     std::vector<std::string> fields;
     fields.reserve(5);
     const auto entries_array = arr();
 
     for (const auto &dd : job_dds)
     {
-      fields.push_back(dd.ddn);
-      fields.push_back(dd.dsn);
-      fields.push_back(std::to_string(dd.key));
-      fields.push_back(dd.stepname);
-      fields.push_back(dd.procstep);
-      if (emit_csv)
+      if (output_mode == InvocationContext::OutputMode_Csv)
       {
+        fields.push_back(dd.ddn);
+        fields.push_back(dd.dsn);
+        fields.push_back(std::to_string(dd.key));
+        fields.push_back(dd.stepname);
+        fields.push_back(dd.procstep);
         context.output_stream() << zut_format_as_csv(fields) << std::endl;
+        fields.clear();
+        continue;
       }
-      else
+      if (output_mode == InvocationContext::OutputMode_Text)
       {
         context.output_stream() << std::left << std::setw(9) << dd.ddn << " " << dd.dsn << " " << std::setw(4) << dd.key << " " << dd.stepname << " " << dd.procstep << std::endl;
+        continue;
       }
 
       const auto entry = obj();
@@ -184,9 +193,12 @@ int handle_job_list_files(InvocationContext &context)
       entries_array->push(entry);
     }
 
-    const auto result = obj();
-    result->set("items", entries_array);
-    context.set_object(result);
+    if (output_mode == InvocationContext::OutputMode_Structured)
+    {
+      const auto result = obj();
+      result->set("items", entries_array);
+      context.set_object(result);
+    }
   }
 
   if (RTNCD_WARNING == rc)
@@ -361,6 +373,100 @@ int handle_job_view_file_by_id(InvocationContext &context)
   return RTNCD_SUCCESS;
 }
 
+int handle_job_view_all_files(InvocationContext &context)
+{
+  int rc = 0;
+  ZJB zjb{};
+  std::string jobid = context.get<std::string>("jobid", "");
+  long long max_bytes = context.get<long long>("max-bytes", 0);
+  bool warn = context.get<bool>("warn", true);
+
+  if (context.has("encoding"))
+  {
+    zut_prepare_encoding(context.get<std::string>("encoding", ""), &zjb.encoding_opts);
+  }
+  if (context.has("local-encoding"))
+  {
+    const auto source_encoding = context.get<std::string>("local-encoding", "");
+    if (!source_encoding.empty() && source_encoding.size() < sizeof(zjb.encoding_opts.source_codepage))
+    {
+      memcpy(zjb.encoding_opts.source_codepage, source_encoding.data(), source_encoding.length() + 1);
+    }
+  }
+
+  const auto output_mode = context.output_mode();
+  const bool response_format_bytes = context.has("encoding") && context.get<bool>("response-format-bytes", false);
+  const auto entries_array = arr();
+
+  rc = zjb_read_all_jobs_output(&zjb, jobid, max_bytes > 0 ? static_cast<size_t>(max_bytes) : 0,
+                                [&](const ZJobDD &dd, std::string &content, bool truncated) -> int
+                                {
+                                  std::string ddname = dd.ddn;
+                                  zut_rtrim(ddname);
+                                  std::string stepname = dd.stepname;
+                                  zut_rtrim(stepname);
+
+                                  if (output_mode != InvocationContext::OutputMode_Structured)
+                                  {
+                                    context.output_stream() << "==> " << (stepname.empty() ? "" : stepname + ".") << ddname << " (" << dd.key << ") <=="
+                                                            << (truncated ? " not read, max bytes reached" : "") << std::endl;
+                                    if (response_format_bytes)
+                                    {
+                                      zut_print_string_as_bytes(content, &context.output_stream());
+                                    }
+                                    else
+                                    {
+                                      context.output_stream() << content;
+                                    }
+                                    return 0;
+                                  }
+
+                                  const auto entry = obj();
+                                  entry->set("id", i64(dd.key));
+                                  entry->set("ddname", str(ddname));
+                                  entry->set("stepname", str(stepname));
+                                  std::string trimmed_name = dd.procstep;
+                                  entry->set("procstep", str(zut_rtrim(trimmed_name)));
+                                  trimmed_name = dd.dsn;
+                                  entry->set("dsname", str(zut_rtrim(trimmed_name)));
+                                  entry->set("data", str(zbase64::encode(content)));
+                                  entry->set("truncated", boolean(truncated));
+                                  // Release each file once it is encoded, so that at most one is held as raw bytes
+                                  std::string().swap(content);
+                                  entries_array->push(entry);
+                                  return 0;
+                                });
+
+  if (RTNCD_SUCCESS == rc || RTNCD_WARNING == rc)
+  {
+    if (output_mode == InvocationContext::OutputMode_Structured)
+    {
+      const auto result = obj();
+      result->set("items", entries_array);
+      const bool truncated = RTNCD_WARNING == rc && (ZJB_RSNCD_MAX_BYTES_REACHED == zjb.diag.detail_rc || ZJB_RSNCD_MAX_JOBS_REACHED == zjb.diag.detail_rc);
+      result->set("truncated", boolean(truncated));
+      context.set_object(result);
+    }
+  }
+
+  if (RTNCD_WARNING == rc)
+  {
+    if (warn)
+    {
+      context.error_stream() << "Warning: " << zjb.diag.e_msg << std::endl;
+    }
+  }
+
+  if (RTNCD_SUCCESS != rc && RTNCD_WARNING != rc)
+  {
+    context.error_stream() << "Error: could not view job files for: '" << jobid << "' rc: '" << rc << "'" << std::endl;
+    context.error_stream() << "  Details: " << zjb.diag.e_msg << std::endl;
+    return RTNCD_FAILURE;
+  }
+
+  return (!warn && rc == RTNCD_WARNING) ? RTNCD_SUCCESS : rc;
+}
+
 int handle_job_view_jcl(InvocationContext &context)
 {
   int rc = 0;
@@ -841,6 +947,18 @@ void register_commands(parser::Command &root_command)
   job_view_file_by_id_cmd->set_handler(handle_job_view_file_by_id);
   job_group->add_command(job_view_file_by_id_cmd);
 
+  // View-all-files subcommand
+  auto job_view_all_files_cmd = command_ptr(new Command("view-all-files", "view the output of all job files"));
+  job_view_all_files_cmd->add_alias("vaf");
+  job_view_all_files_cmd->add_positional_arg(JOB_ID);
+  job_view_all_files_cmd->add_keyword_arg("max-bytes", make_aliases("--max-bytes", "--mb"), "stop reading at the first job file that would bring the total output over this many bytes; it and later files are listed as not read", ArgType_Single, false);
+  job_view_all_files_cmd->add_keyword_arg(ENCODING);
+  job_view_all_files_cmd->add_keyword_arg(LOCAL_ENCODING);
+  job_view_all_files_cmd->add_keyword_arg(RESPONSE_FORMAT_BYTES);
+  job_view_all_files_cmd->add_keyword_arg(WARN);
+  job_view_all_files_cmd->set_handler(handle_job_view_all_files);
+  job_group->add_command(job_view_all_files_cmd);
+
   // View-jcl subcommand
   auto job_view_jcl_cmd = command_ptr(new Command("view-jcl", "view job jcl from input jobid"));
   job_view_jcl_cmd->add_alias("vj");
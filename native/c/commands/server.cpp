@@ -9,6 +9,7 @@
  *
  */
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <csignal>
@@ -20,15 +21,20 @@
 #include <stdexcept>
 #include <string>
 #include <thread>
+#include <vector>
 #include <unistd.h>
 #include "core.hpp"
 #include "server.hpp"
+#include "../zjb.hpp"
 #include "../zjson.hpp"
 #include "../zusf.hpp"
 #include "../server/rpc_server.hpp"
 #include "../server/rpc_commands.hpp"
 #include "../server/dispatcher.hpp"
+#include "../server/fifo_pool.hpp"
+#include "../server/frame.hpp"
 #include "../server/logger.hpp"
+#include "../server/response_writer.hpp"
 #include "../server/worker.hpp"
 
 using namespace parser;
@@ -73,6 +79,8 @@ void ZServer::request_shutdown()
           if (worker_pool) {
               worker_pool->shutdown();
           }
+          FifoPool::get_instance().shutdown();
+          ResponseWriter::get_instance().stop();
           close(STDIN_FILENO); });
 }
 
@@ -140,7 +148,7 @@ void ZServer::log_worker_count()
                   int32_t count = worker_pool->get_available_workers_count();
                   LOG_DEBUG("Available workers: %d/%lld", count, options.num_workers);
                   std::this_thread::sleep_for(std::chrono::milliseconds(500));
-                  if (count == options.num_workers) {
+                  if (count >= static_cast<int32_t>(worker_pool->get_min_workers())) {
                       break;
                   }
               }
@@ -154,7 +162,7 @@ void ZServer::run(const server::Options &opts)
   options = opts;
 
   server::Logger::init_logger(options.exec_dir.c_str(), options.verbose);
-  LOG_INFO("Starting zowex server with %lld workers and %lld seconds until request timeout (verbose=%s)", options.num_workers, options.request_timeout, options.verbose ? "true" : "false");
+  LOG_INFO("Starting zowex server with up to %lld workers (%lld reserved for interactive requests) and %lld seconds until request timeout (verbose=%s)", options.num_workers, std::min(options.interactive_workers, options.num_workers - 1), options.request_timeout, options.verbose ? "true" : "false");
 
   setup_signal_handlers();
 
@@ -163,21 +171,75 @@ void ZServer::run(const server::Options &opts)
   LOG_DEBUG("Registering command handlers");
   register_all_commands(dispatcher);
 
-  worker_pool.reset(new WorkerPool(options.num_workers, std::chrono::seconds(options.request_timeout)));
+  worker_pool.reset(new WorkerPool(options.num_workers, std::chrono::seconds(options.request_timeout), options.interactive_workers,
+                                   options.min_workers, std::chrono::seconds(options.worker_idle_timeout)));
+  LOG_DEBUG("Worker pool keeps %zu workers while idle and retires extra workers after %lld seconds idle", worker_pool->get_min_workers(), options.worker_idle_timeout);
+
+  // A FIFO lease outlives its request only if the request was abandoned after timing out
+  FifoPool::get_instance().configure(FifoPool::DEFAULT_MAX_IDLE, std::chrono::seconds(2 * options.request_timeout));
+  FifoPool::get_instance().prefill(FifoPool::DEFAULT_PREFILL);
+  // Likewise, frames are sent just ahead of their request, so a payload still waiting after that long has lost it
+  FrameChannel::get_instance().configure(std::chrono::seconds(2 * options.request_timeout));
+  JobDDCache::get_instance().configure(static_cast<size_t>(options.spool_cache_jobs), static_cast<size_t>(options.spool_cache_dds),
+                                       std::chrono::seconds(options.spool_cache_active_ttl), std::chrono::seconds(options.spool_cache_complete_ttl));
+  LOG_DEBUG("Spool file cache keeps up to %lld jobs and %lld spool files, for %lld seconds while a job is active and %lld seconds once it has finished",
+            options.spool_cache_jobs, options.spool_cache_dds, options.spool_cache_active_ttl, options.spool_cache_complete_ttl);
 
   std::atexit([]()
               { get_instance().request_shutdown(); });
 
   log_worker_count();
   print_ready_message();
+  ResponseWriter::get_instance().start();
 
   LOG_DEBUG("Entering main input processing loop");
   std::string line{};
-  while (std::getline(std::cin, line) && !shutdown_requested)
+  while (!shutdown_requested)
   {
+    if (std::cin.peek() == frame::MARKER)
+    {
+      // Raw data of a request that follows; held until a worker runs the request
+      if (!FrameChannel::get_instance().read_frame(std::cin))
+      {
+        LOG_ERROR("Input stream ended inside a binary frame");
+        break;
+      }
+      continue;
+    }
+
+    if (!std::getline(std::cin, line))
+      break;
+
     if (!line.empty())
     {
-      worker_pool->distribute_request(line);
+      RpcServer &server = RpcServer::get_instance();
+      if (RpcServer::is_batch(line))
+      {
+        // Every request of a batch runs on its own; the responses are written together once all are answered
+        std::vector<std::string> requests;
+        std::vector<std::string> notifications;
+        auto batch = server.split_batch(line, static_cast<size_t>(options.max_batch_size), std::chrono::seconds(options.batch_timeout), requests,
+                                        notifications);
+        if (batch)
+        {
+          std::vector<SchedulingClass> scheduling;
+          scheduling.reserve(requests.size());
+          for (const auto &request : requests)
+            scheduling.push_back(server.get_scheduling_class(request));
+          worker_pool->distribute_batch(std::move(batch), std::move(requests), scheduling);
+        }
+
+        // Notifications run alongside the requests but are never answered
+        for (auto &notification : notifications)
+        {
+          const SchedulingClass scheduling = server.get_scheduling_class(notification);
+          worker_pool->distribute_notification(std::move(notification), scheduling);
+        }
+        continue;
+      }
+
+      const SchedulingClass scheduling = server.get_scheduling_class(line);
+      worker_pool->distribute_request(std::move(line), scheduling);
     }
   }
 
@@ -198,6 +260,15 @@ static int handle_server(plugin::InvocationContext &context)
   opts.num_workers = context.get<long long>("num-workers", opts.num_workers);
   opts.verbose = context.get<bool>("verbose", opts.verbose);
   opts.request_timeout = context.get<long long>("request-timeout", opts.request_timeout);
+  opts.interactive_workers = context.get<long long>("interactive-workers", opts.interactive_workers);
+  opts.min_workers = context.get<long long>("min-workers", opts.min_workers);
+  opts.worker_idle_timeout = context.get<long long>("worker-idle-timeout", opts.worker_idle_timeout);
+  opts.max_batch_size = context.get<long long>("max-batch-size", opts.max_batch_size);
+  opts.batch_timeout = context.get<long long>("batch-timeout", opts.batch_timeout);
+  opts.spool_cache_jobs = context.get<long long>("spool-cache-jobs", opts.spool_cache_jobs);
+  opts.spool_cache_dds = context.get<long long>("spool-cache-dds", opts.spool_cache_dds);
+  opts.spool_cache_active_ttl = context.get<long long>("spool-cache-active-ttl", opts.spool_cache_active_ttl);
+  opts.spool_cache_complete_ttl = context.get<long long>("spool-cache-complete-ttl", opts.spool_cache_complete_ttl);
   opts.exec_dir = ZServer::get_instance().get_exec_dir();
 
   const auto *num_workers_env = getenv("ZOWEX_NUM_WORKERS");
@@ -238,6 +309,48 @@ static int handle_server(plugin::InvocationContext &context)
     return 1;
   }
 
+  if (opts.interactive_workers < 0)
+  {
+    context.error_stream() << "Number of interactive workers must not be negative" << std::endl;
+    return 1;
+  }
+
+  if (opts.min_workers <= 0)
+  {
+    context.error_stream() << "Minimum number of workers must be greater than 0" << std::endl;
+    return 1;
+  }
+
+  if (opts.worker_idle_timeout <= 0)
+  {
+    context.error_stream() << "Worker idle timeout must be greater than 0 seconds" << std::endl;
+    return 1;
+  }
+
+  if (opts.max_batch_size <= 0)
+  {
+    context.error_stream() << "Maximum batch size must be greater than 0" << std::endl;
+    return 1;
+  }
+
+  if (opts.batch_timeout <= 0)
+  {
+    context.error_stream() << "Batch timeout must be greater than 0 seconds" << std::endl;
+    return 1;
+  }
+
+  if (opts.spool_cache_jobs < 0 || opts.spool_cache_dds < 0)
+  {
+    context.error_stream() << "Spool cache bounds must not be negative" << std::endl;
+    return 1;
+  }
+
+  if (opts.spool_cache_active_ttl < 0 || opts.spool_cache_complete_ttl < 0)
+  {
+    context.error_stream() << "Spool cache TTLs must not be negative" << std::endl;
+    return 1;
+  }
+
   try
   {
     ZServer::get_instance().run(opts);
@@ -257,7 +370,7 @@ void register_commands(Command &root_command)
   auto server_cmd = std::make_shared<Command>("server", "start the Zowe Remote SSH I/O server");
   server_cmd->add_keyword_arg("num-workers",
                               make_aliases("-w", "--num-workers"),
-                              "number of worker threads",
+                              "maximum number of worker threads",
                               ArgType_Single, false,
                               ArgValue(10LL));
   server_cmd->add_keyword_arg("verbose",
@@ -270,6 +383,51 @@ void register_commands(Command &root_command)
                               "request timeout in seconds before a worker is restarted",
                               ArgType_Single, false,
                               ArgValue(60LL));
+  server_cmd->add_keyword_arg("interactive-workers",
+                              make_aliases("-i", "--interactive-workers"),
+                              "number of workers reserved for interactive requests (at most num-workers - 1)",
+                              ArgType_Single, false,
+                              ArgValue(2LL));
+  server_cmd->add_keyword_arg("min-workers",
+                              make_aliases("-m", "--min-workers"),
+                              "number of worker threads kept running while idle (at least interactive-workers + 1)",
+                              ArgType_Single, false,
+                              ArgValue(3LL));
+  server_cmd->add_keyword_arg("worker-idle-timeout",
+                              make_aliases("--worker-idle-timeout"),
+                              "seconds a worker thread above the minimum may stay idle before it exits",
+                              ArgType_Single, false,
+                              ArgValue(60LL));
+  server_cmd->add_keyword_arg("max-batch-size",
+                              make_aliases("--max-batch-size"),
+                              "maximum number of requests in one JSON-RPC batch",
+                              ArgType_Single, false,
+                              ArgValue(100LL));
+  server_cmd->add_keyword_arg("batch-timeout",
+                              make_aliases("--batch-timeout"),
+                              "seconds a JSON-RPC batch may take before its unanswered requests time out",
+                              ArgType_Single, false,
+                              ArgValue(60LL));
+  server_cmd->add_keyword_arg("spool-cache-jobs",
+                              make_aliases("--spool-cache-jobs"),
+                              "maximum number of jobs whose spool file lists are cached (0 disables the cache)",
+                              ArgType_Single, false,
+                              ArgValue(256LL));
+  server_cmd->add_keyword_arg("spool-cache-dds",
+                              make_aliases("--spool-cache-dds"),
+                              "maximum number of spool files cached across all jobs",
+                              ArgType_Single, false,
+                              ArgValue(16384LL));
+  server_cmd->add_keyword_arg("spool-cache-active-ttl",
+                              make_aliases("--spool-cache-active-ttl"),
+                              "seconds the spool file list of a job still in input or execution is cached",
+                              ArgType_Single, false,
+                              ArgValue(5LL));
+  server_cmd->add_keyword_arg("spool-cache-complete-ttl",
+                              make_aliases("--spool-cache-complete-ttl"),
+                              "seconds the spool file list of a finished job is cached",
+                              ArgType_Single, false,
+                              ArgValue(300LL));
   server_cmd->set_handler(handle_server);
   root_command.add_command(server_cmd);
 }
@@ -29,6 +29,15 @@ struct Options
   long long num_workers = 10;
   bool verbose = false;
   long long request_timeout = 60;
+  long long interactive_workers = 2;
+  long long min_workers = 3;
+  long long worker_idle_timeout = 60;
+  long long max_batch_size = 100;
+  long long batch_timeout = 60;
+  long long spool_cache_jobs = 256;
+  long long spool_cache_dds = 16384;
+  long long spool_cache_active_ttl = 5;
+  long long spool_cache_complete_ttl = 300;
   std::string exec_dir = ".";
 };
 
@@ -163,77 +163,60 @@ int handle_uss_list(InvocationContext &context)
   list_options.long_format = context.get<bool>("long", false);
   list_options.max_depth = context.get<long long>("depth", 1);
 
-  const auto use_csv_format = context.get<bool>("response-format-csv", false);
+  const auto output_mode = context.output_mode();
 
   ZUSF zusf{};
-  std::string response;
-  rc = zusf_list_uss_file_path(&zusf, uss_file, response, list_options, use_csv_format);
-  if (0 != rc)
+  if (output_mode == InvocationContext::OutputMode_Structured)
   {
-    context.error_stream() << "Error: could not list USS files: '" << uss_file << "' rc: '" << rc << "'" << std::endl;
-    context.error_stream() << "  Details:\n"
-                           << zusf.diag.e_msg << std::endl
-                           << response << std::endl;
-    return RTNCD_FAILURE;
-  }
-
-  context.output_stream() << response;
+    // Build the result straight from the stat data instead of formatting and re-parsing text
+    std::vector<ZUSFEntry> entries;
+    rc = zusf_list_uss_entries(&zusf, uss_file, entries, list_options);
+    if (0 != rc)
+    {
+      context.error_stream() << "Error: could not list USS files: '" << uss_file << "' rc: '" << rc << "'" << std::endl;
+      context.error_stream() << "  Details:\n"
+                             << zusf.diag.e_msg << std::endl;
+      return RTNCD_FAILURE;
+    }
 
-  if (use_csv_format)
-  {
     const auto result = obj();
     const auto entries_array = arr();
-
-    // Parse CSV lines
-    std::stringstream ss(response);
-    std::string line;
-    int row_count = 0;
-
-    while (std::getline(ss, line))
+    for (const auto &entry : entries)
     {
-      if (line.empty())
-      {
-        continue;
-      }
-
-      const auto entry = obj();
-
+      const auto item = obj();
       if (list_options.long_format)
       {
-        // Parse CSV fields: mode,links,user,group,size,tag,date,name
-        std::vector<std::string> fields;
-        std::stringstream line_ss(line);
-        std::string field;
-
-        while (std::getline(line_ss, field, ','))
-        {
-          fields.push_back(field);
-        }
-
-        entry->set("mode", str(fields[0]));
-        entry->set("links", i64(atoi(fields[1].c_str())));
-        entry->set("user", str(fields[2]));
-        entry->set("group", str(fields[3]));
-        entry->set("size", i64(atoi(fields[4].c_str())));
-        entry->set("filetag", str(fields[5]));
-        entry->set("mtime", str(fields[6]));
-        entry->set("name", str(fields[7]));
-      }
-      else
-      {
-        // Simple format: just the name
-        entry->set("name", str(line));
+        item->set("mode", str(zusf_build_mode_string(entry.stats.st_mode)));
+        item->set("links", i64(entry.stats.st_nlink));
+        item->set("user", str(zusf_get_owner_from_uid(entry.stats.st_uid)));
+        item->set("group", str(zusf_get_group_from_gid(entry.stats.st_gid)));
+        item->set("size", i64(entry.stats.st_size));
+        item->set("filetag", str(zusf_get_ccsid_display_name(entry.stats.st_tag.ft_ccsid)));
+        item->set("mtime", str(zusf_format_ls_time(entry.stats.st_mtime, true)));
       }
-
-      entries_array->push(entry);
-      row_count++;
+      item->set("name", str(entry.name));
+      entries_array->push(item);
     }
 
     result->set("items", entries_array);
-    result->set("returnedRows", i64(row_count));
+    result->set("returnedRows", i64(entries.size()));
     context.set_object(result);
+    return rc;
+  }
+
+  std::string response;
+  rc = zusf_list_uss_file_path(&zusf, uss_file, response, list_options, output_mode == InvocationContext::OutputMode_Csv);
+  if (0 != rc)
+  {
+    context.error_stream() << "Error: could not list USS files: '" << uss_file << "' rc: '" << rc << "'" << std::endl;
+    context.error_stream() << "  Details:\n"
+                           << zusf.diag.e_msg << std::endl
+                           << response << std::endl;
+    return RTNCD_FAILURE;
   }
 
+  context.output_stream() << response;
+
   return rc;
 }
 
@@ -20,6 +20,10 @@
 #include <string>
 #include <vector>
 #include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
 
 #include <unordered_map>
 
@@ -43,6 +47,256 @@ typedef std::shared_ptr<std::vector<Node>> VecPtr;
 typedef std::unordered_map<std::string, Node> ObjMap;
 typedef std::shared_ptr<ObjMap> ObjPtr;
 
+/**
+ * Bump allocator for the nodes of one AST. Memory is handed out from large
+ * blocks and released all at once when the arena is destroyed, so nodes
+ * allocated from it must not outlive it. String and container contents
+ * (characters beyond the small-string buffer, array elements, object
+ * members) still come from the heap and are freed as usual.
+ *
+ * The arena counts the nodes placed in it that are still referenced; unless
+ * NDEBUG is defined, it aborts if it is destroyed while any remain. The count
+ * is kept in every build so that the layout is the same for plugins built
+ * with other flags than the server.
+ */
+class Arena
+{
+public:
+  Arena()
+      : m_blocks(nullptr), m_next(nullptr), m_end(nullptr), m_block_size(FIRST_BLOCK_SIZE), m_bytes_allocated(0), m_live_parts(0)
+  {
+  }
+
+  ~Arena()
+  {
+#ifndef NDEBUG
+    if (m_live_parts != 0)
+    {
+      fprintf(stderr, "ast::Arena destroyed while %zu node parts allocated from it are still referenced\n", m_live_parts);
+      abort();
+    }
+#endif
+    while (m_blocks)
+    {
+      Block *next = m_blocks->next;
+      ::operator delete(m_blocks);
+      m_blocks = next;
+    }
+  }
+
+  void *allocate(size_t size, size_t alignment)
+  {
+    uintptr_t ptr = align_up(reinterpret_cast<uintptr_t>(m_next), alignment);
+    if (m_next == nullptr || ptr + size > reinterpret_cast<uintptr_t>(m_end))
+    {
+      add_block(size + alignment);
+      ptr = align_up(reinterpret_cast<uintptr_t>(m_next), alignment);
+    }
+    m_next = reinterpret_cast<char *>(ptr + size);
+    m_bytes_allocated += size;
+    return reinterpret_cast<void *>(ptr);
+  }
+
+  // Bytes handed out so far, excluding alignment padding
+  size_t bytes_allocated() const
+  {
+    return m_bytes_allocated;
+  }
+
+  // Node parts placed in the arena that are still referenced
+  size_t live_parts() const
+  {
+    return m_live_parts;
+  }
+
+  void adopt_part()
+  {
+    m_live_parts++;
+  }
+
+  void release_part()
+  {
+    m_live_parts--;
+  }
+
+private:
+  static constexpr size_t FIRST_BLOCK_SIZE = 16 * 1024;
+  static constexpr size_t MAX_BLOCK_SIZE = 1024 * 1024;
+
+  struct Block
+  {
+    Block *next;
+  };
+
+  static uintptr_t align_up(uintptr_t value, size_t alignment)
+  {
+    return (value + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+  }
+
+  void add_block(size_t min_size)
+  {
+    const size_t size = std::max(m_block_size, min_size + sizeof(Block));
+    Block *block = static_cast<Block *>(::operator new(size));
+    block->next = m_blocks;
+    m_blocks = block;
+    m_next = reinterpret_cast<char *>(block + 1);
+    m_end = reinterpret_cast<char *>(block) + size;
+    m_block_size = std::min(m_block_size * 2, MAX_BLOCK_SIZE);
+  }
+
+  Block *m_blocks;
+  char *m_next;
+  char *m_end;
+  size_t m_block_size;
+  size_t m_bytes_allocated;
+  size_t m_live_parts;
+
+  Arena(const Arena &);
+  Arena &operator=(const Arena &);
+};
+
+/**
+ * Allocator for shared_ptr control blocks in an arena; memory is only released with the arena
+ */
+template <typename T>
+struct ArenaAllocator
+{
+  typedef T value_type;
+
+  explicit ArenaAllocator(Arena *arena_)
+      : arena(arena_)
+  {
+  }
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U> &other)
+      : arena(other.arena)
+  {
+  }
+
+  T *allocate(size_t n)
+  {
+    return static_cast<T *>(arena->allocate(n * sizeof(T), alignof(T)));
+  }
+  void deallocate(T *, size_t)
+  {
+  }
+
+  template <typename U>
+  bool operator==(const ArenaAllocator<U> &other) const
+  {
+    return arena == other.arena;
+  }
+  template <typename U>
+  bool operator!=(const ArenaAllocator<U> &other) const
+  {
+    return arena != other.arena;
+  }
+
+  Arena *arena;
+};
+
+// Runs the destructor of an object placed in an arena, leaving its memory to the arena
+template <typename T>
+struct ArenaDeleter
+{
+  explicit ArenaDeleter(Arena *arena_)
+      : arena(arena_)
+  {
+  }
+
+  void operator()(T *ptr) const
+  {
+    ptr->~T();
+    arena->release_part();
+  }
+
+  Arena *arena;
+};
+
+/**
+ * Arena used by the node factories on this thread, or nullptr to allocate from the heap.
+ *
+ * Lifetime rule: while an ArenaScope is active, every node the factories return lives in
+ * that arena and is destroyed with it. A handler run by the server must not keep such a
+ * node past its request (e.g. in a static or a background thread); build long-lived nodes
+ * outside any scope, or wrap the code that builds them in a HeapScope.
+ */
+inline Arena *&current_arena()
+{
+  static thread_local Arena *arena = nullptr;
+  return arena;
+}
+
+/**
+ * Makes the node factories (obj(), arr(), str(), ...) allocate from `arena` on this thread
+ * until the scope ends. The nodes must be released before `arena` is destroyed.
+ */
+class ArenaScope
+{
+public:
+  explicit ArenaScope(Arena &arena)
+      : m_previous(current_arena())
+  {
+    current_arena() = &arena;
+  }
+  ~ArenaScope()
+  {
+    current_arena() = m_previous;
+  }
+
+private:
+  Arena *m_previous;
+
+  ArenaScope(const ArenaScope &);
+  ArenaScope &operator=(const ArenaScope &);
+};
+
+/**
+ * Makes the node factories allocate from the heap on this thread until the scope ends, for
+ * nodes that must outlive the arena of the current request
+ */
+class HeapScope
+{
+public:
+  HeapScope()
+      : m_previous(current_arena())
+  {
+    current_arena() = nullptr;
+  }
+  ~HeapScope()
+  {
+    current_arena() = m_previous;
+  }
+
+private:
+  Arena *m_previous;
+
+  HeapScope(const HeapScope &);
+  HeapScope &operator=(const HeapScope &);
+};
+
+/**
+ * Wrap `ptr`, constructed in `arena`, in a shared_ptr whose control block is also in `arena`
+ */
+template <typename T>
+std::shared_ptr<T> adopt_node_part(T *ptr, Arena *arena)
+{
+  arena->adopt_part();
+  return std::shared_ptr<T>(ptr, ArenaDeleter<T>(arena), ArenaAllocator<T>(arena));
+}
+
+/**
+ * Construct a node's string or container in the current arena, or on the heap
+ */
+template <typename T, typename... Args>
+std::shared_ptr<T> make_node_part(Args &&...args)
+{
+  Arena *arena = current_arena();
+  if (arena == nullptr)
+    return std::shared_ptr<T>(new T(std::forward<Args>(args)...));
+  return adopt_node_part(new (arena->allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...), arena);
+}
+
 struct Ast
 {
   enum Kind
@@ -57,44 +311,46 @@ struct Ast
   };
 
   // --- factories ---
+  // Nodes come from the current arena when an ArenaScope is active, otherwise from the heap;
+  // see current_arena() for how long arena nodes may be kept
   static Node null()
   {
-    return Node(new Ast(Null));
+    return make(Null);
   }
   static Node boolean(bool v)
   {
-    Node n(new Ast(Boolean));
+    Node n = make(Boolean);
     n->b = v;
     return n;
   }
   static Node integer(long long v)
   {
-    Node n(new Ast(Integer));
+    Node n = make(Integer);
     n->i = v;
     return n;
   }
   static Node number(double v)
   {
-    Node n(new Ast(Number));
+    Node n = make(Number);
     n->d = v;
     return n;
   }
   static Node string(const std::string &v)
   {
-    Node n(new Ast(String));
-    n->s.reset(new std::string(v));
+    Node n = make(String);
+    n->s = make_node_part<std::string>(v);
     return n;
   }
   static Node array()
   {
-    Node n(new Ast(Array));
-    n->a.reset(new std::vector<Node>());
+    Node n = make(Array);
+    n->a = make_node_part<std::vector<Node>>();
     return n;
   }
   static Node object()
   {
-    Node n(new Ast(Object));
-    n->o.reset(new ObjMap());
+    Node n = make(Object);
+    n->o = make_node_part<ObjMap>();
     return n;
   }
 
@@ -275,6 +531,14 @@ private:
   {
   }
 
+  static Node make(Kind kind_)
+  {
+    Arena *arena = current_arena();
+    if (arena == nullptr)
+      return Node(new Ast(kind_));
+    return adopt_node_part(new (arena->allocate(sizeof(Ast), alignof(Ast))) Ast(kind_), arena);
+  }
+
   void append_yaml(std::ostringstream &out, size_t indent) const
   {
     switch (k)
@@ -394,7 +658,8 @@ private:
   ObjPtr o;    // Object
 };
 
-// convenience free functions
+// convenience free functions; like the Ast factories, they allocate from the current arena
+// inside a request, so the nodes they return must not be kept past it (see current_arena())
 inline Node obj()
 {
   return Ast::object();
@@ -1014,10 +1279,18 @@ struct ContextArgs
 class InvocationContext : public Io
 {
 public:
+  enum OutputMode
+  {
+    OutputMode_Text = 0,      // Human-readable text in the output stream
+    OutputMode_Csv = 1,       // CSV rows in the output stream
+    OutputMode_Structured = 2 // Result object only (set_object), as used by the RPC server
+  };
+
   explicit InvocationContext(const ContextArgs &context_args)
       : Io(context_args.args, context_args.in_stream, context_args.out_stream, context_args.err_stream),
         m_command_path(context_args.command_path),
-        m_passthrough_args(context_args.passthrough_args)
+        m_passthrough_args(context_args.passthrough_args),
+        m_output_mode(OutputMode_Text)
   {
   }
 
@@ -1038,9 +1311,25 @@ public:
     return m_passthrough_args;
   }
 
+  // How the handler should present its result; text mode becomes CSV with --response-format-csv
+  OutputMode output_mode()
+  {
+    if (m_output_mode == OutputMode_Text && get<bool>("response-format-csv", false))
+    {
+      return OutputMode_Csv;
+    }
+    return m_output_mode;
+  }
+
+  void set_output_mode(OutputMode mode)
+  {
+    m_output_mode = mode;
+  }
+
 private:
   std::string m_command_path;
   std::vector<std::string> m_passthrough_args;
+  OutputMode m_output_mode;
 };
 
 class CommandProviderImpl
@@ -0,0 +1,128 @@
+/**
+ * This program and the accompanying materials are made available under the terms of the
+ * Eclipse Public License v2.0 which accompanies this distribution, and is available at
+ * https://www.eclipse.org/legal/epl-v20.html
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Copyright Contributors to the Zowe Project.
+ *
+ */
+
+#include "ast_writer.hpp"
+#include "validator.hpp"
+#include "../zjson.hpp"
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+
+void AstWriter::write(const ast::Node &node)
+{
+  if (!node)
+  {
+    m_out.append("null", 4);
+    return;
+  }
+
+  switch (node->kind())
+  {
+  case ast::Ast::Boolean:
+    if (node->as_bool())
+      m_out.append("true", 4);
+    else
+      m_out.append("false", 5);
+    break;
+
+  case ast::Ast::Integer:
+  case ast::Ast::Number:
+    write_number(*node);
+    break;
+
+  case ast::Ast::String:
+    zjson::write_json_string(m_out, node->as_string());
+    break;
+
+  case ast::Ast::Array:
+  {
+    const auto &array = node->as_array();
+    m_out.push_back('[');
+    for (size_t i = 0; i < array.size(); ++i)
+    {
+      if (i > 0)
+        m_out.push_back(',');
+      write(array[i]);
+    }
+    m_out.push_back(']');
+    break;
+  }
+
+  case ast::Ast::Object:
+  {
+    m_out.push_back('{');
+    bool first = true;
+    for (const auto &member : node->as_object())
+    {
+      if (!first)
+        m_out.push_back(',');
+      first = false;
+      zjson::write_json_string(m_out, member.first);
+      m_out.push_back(':');
+      write(member.second);
+    }
+    m_out.push_back('}');
+    break;
+  }
+
+  default:
+    m_out.append("null", 4);
+    break;
+  }
+}
+
+void AstWriter::write_result(const ast::Node &result, bool success, validator::ObjectValidator *validator)
+{
+  if (!result || !result->is_object())
+  {
+    throw std::runtime_error("Command result must be an object");
+  }
+
+  m_out.push_back('{');
+  for (const auto &member : result->as_object())
+  {
+    if (member.first == "success")
+      continue;
+
+    if (validator)
+      validator->check_member(member.first, member.second);
+    zjson::write_json_string(m_out, member.first);
+    m_out.push_back(':');
+    write(member.second);
+    m_out.push_back(',');
+  }
+
+  if (validator)
+    validator->check_member("success", ast::boolean(success));
+  m_out.append(success ? "\"success\":true}" : "\"success\":false}");
+}
+
+void AstWriter::write_number(const ast::Ast &node)
+{
+  // Formatted as zjson::write_json formats numbers
+  char buf[32];
+  int length;
+  if (node.is_integer())
+  {
+    length = snprintf(buf, sizeof(buf), "%lld", node.as_integer());
+  }
+  else if (std::isfinite(node.as_number()))
+  {
+    length = snprintf(buf, sizeof(buf), "%.17g", node.as_number());
+  }
+  else
+  {
+    // JSON has no representation for NaN or infinity
+    m_out.append("null", 4);
+    return;
+  }
+  m_out.append(buf, static_cast<size_t>(length));
+}
@@ -0,0 +1,57 @@
+/**
+ * This program and the accompanying materials are made available under the terms of the
+ * Eclipse Public License v2.0 which accompanies this distribution, and is available at
+ * https://www.eclipse.org/legal/epl-v20.html
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Copyright Contributors to the Zowe Project.
+ *
+ */
+
+#ifndef AST_WRITER_HPP
+#define AST_WRITER_HPP
+
+#include "../extend/plugin.hpp"
+#include <string>
+
+namespace validator
+{
+class ObjectValidator;
+}
+
+/**
+ * Writes command results straight from the handler's ast::Node tree as compact
+ * JSON, in the same format as zjson::write_json, without converting the tree
+ * to a zjson::Value first.
+ */
+class AstWriter
+{
+public:
+  explicit AstWriter(std::string &out)
+      : m_out(out)
+  {
+  }
+
+  /**
+   * Append the JSON text for a node; a null pointer is written as null
+   */
+  void write(const ast::Node &node);
+
+  /**
+   * Append a command result: the members of `result` followed by "success",
+   * which replaces any member of that name. Each top-level member is checked
+   * against `validator` as it is written.
+   * @param result The result object built by the command handler
+   * @param success Value written for the "success" member
+   * @param validator Response validator, or nullptr to skip validation
+   */
+  void write_result(const ast::Node &result, bool success, validator::ObjectValidator *validator);
+
+private:
+  std::string &m_out;
+
+  void write_number(const ast::Ast &node);
+};
+
+#endif
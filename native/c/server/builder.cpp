@@ -10,17 +10,13 @@
  */
 
 #include "builder.hpp"
+#include "fifo_pool.hpp"
+#include "frame.hpp"
 #include "logger.hpp"
 #include "rpcio.hpp"
 #include "rpc_server.hpp"
 #include "../zbase64.h"
-#include <cerrno>
-#include <cstdlib>
 #include <iostream>
-#include <sstream>
-#include <sys/stat.h>
-#include <sys/types.h>
-#include <unistd.h>
 
 using std::string;
 
@@ -147,6 +143,19 @@ void CommandBuilder::apply_input_transforms(MiddlewareContext &context) const
     {
       // WriteStdin: Read argument value and write to stdin
       // If base64 is true, decode base64 before writing to stdin
+      // With binary framing, the raw bytes may have been sent ahead of the request instead
+      string payload;
+      if (transform.base64 && FrameChannel::get_instance().is_binary() && !RpcServer::in_notification() &&
+          FrameChannel::get_instance().take_payload(context.get_request_id(), payload))
+      {
+        context.set_input_content(std::move(payload));
+        if (arg_it != args.end())
+        {
+          args.erase(arg_it);
+        }
+        break;
+      }
+
       if (arg_it != args.end())
       {
         try
@@ -160,7 +169,7 @@ void CommandBuilder::apply_input_transforms(MiddlewareContext &context) const
           }
 
           // Write to stdin
-          context.set_input_content(data);
+          context.set_input_content(std::move(data));
 
           // Remove the argument from args
           args.erase(arg_it);
@@ -259,39 +268,17 @@ void CommandBuilder::apply_input_transforms(MiddlewareContext &context) const
           }
           long long stream_id = *stream_id_ptr;
 
-          // Create pipe path: /tmp/zowex_{uid}_{pid}_{stream_id}_fifo
-          const char *tmp_dir = std::getenv("TMPDIR");
-          if (tmp_dir == nullptr || tmp_dir[0] == '\0')
-          {
-            tmp_dir = "/tmp";
-          }
-
-          std::ostringstream pipe_path_stream;
-          pipe_path_stream << tmp_dir << "/zowex_"
-                           << geteuid() << "_"
-                           << getpid() << "_"
-                           << stream_id << "_fifo";
-          const string pipe_path = pipe_path_stream.str();
-
-          // Remove any existing pipe (ignore errors if it doesn't exist)
-          if (unlink(pipe_path.c_str()) != 0 && errno != ENOENT)
+          // Lease a FIFO pipe: {TMPDIR}/zowex_{uid}_{pid}_{id}_fifo, reused across requests
+          string pipe_path;
+          string error;
+          if (!FifoPool::get_instance().lease(pipe_path, error))
           {
-            string errMsg = string("Failed to delete existing FIFO pipe: ") + pipe_path + ", errno: " + std::to_string(errno);
-            context.errln(errMsg.c_str());
-            LOG_ERROR("%s", errMsg.c_str());
+            context.errln(error.c_str());
+            LOG_ERROR("%s", error.c_str());
             break;
           }
 
-          // Create the FIFO pipe
-          if (mkfifo(pipe_path.c_str(), 0600) != 0)
-          {
-            string errMsg = string("Failed to create FIFO pipe: ") + pipe_path + ", errno: " + std::to_string(errno);
-            context.errln(errMsg.c_str());
-            LOG_ERROR("%s", errMsg.c_str());
-            break;
-          }
-
-          LOG_DEBUG("Created FIFO pipe: %s", pipe_path.c_str());
+          LOG_DEBUG("Leased FIFO pipe %s for stream %lld", pipe_path.c_str(), stream_id);
 
           // Set the pipe path as the output argument
           args[transform.arg_name] = plugin::Argument(pipe_path);
@@ -335,7 +322,7 @@ void CommandBuilder::apply_input_transforms(MiddlewareContext &context) const
   }
 }
 
-void CommandBuilder::apply_output_transforms(MiddlewareContext &context) const
+void CommandBuilder::apply_output_transforms(MiddlewareContext &context, int result) const
 {
   auto obj = context.get_object();
 
@@ -365,7 +352,16 @@ void CommandBuilder::apply_output_transforms(MiddlewareContext &context) const
       // If base64 is true, encode base64 before writing to output
       try
       {
-        string data = context.get_output_content();
+        if (transform.base64 && FrameChannel::get_instance().is_binary() && !RpcServer::in_notification())
+        {
+          // The raw bytes go to the client in frames ahead of the response, which carries an empty field
+          FrameChannel::get_instance().send_payload(context.get_request_id(), context.take_output_content());
+          obj->set(transform.arg_name, ast::str(""));
+          break;
+        }
+
+        // The output is moved out rather than copied, which also frees it as soon as it has been encoded
+        string data = context.take_output_content();
 
         if (transform.base64)
         {
@@ -376,9 +372,6 @@ void CommandBuilder::apply_output_transforms(MiddlewareContext &context) const
         {
           context.store_large_data(transform.arg_name, std::move(data));
           obj->set(transform.arg_name, ast::str(""));
-
-          // Clear output buffer to free memory ASAP
-          std::stringstream().swap(context.get_output_stream());
         }
         else
         {
@@ -396,22 +389,14 @@ void CommandBuilder::apply_output_transforms(MiddlewareContext &context) const
 
     case ArgTransform::HandleFifo:
     {
-      // HandleFifo cleanup: Remove the FIFO pipe after command execution
+      // HandleFifo cleanup: Return the FIFO pipe after command execution. It is kept for the next
+      // streamed request only if this one succeeded, since the client attached to it then.
       const auto &args = context.arguments();
       const auto pipe_path_arg = args.find(transform.arg_name);
 
       if (pipe_path_arg != args.end())
       {
-        // Remove the pipe (ignore errors if already removed)
-        const string pipe_path = pipe_path_arg->second.get_string_value();
-        if (unlink(pipe_path.c_str()) == 0)
-        {
-          LOG_DEBUG("Cleaned up FIFO pipe: %s", pipe_path.c_str());
-        }
-        else if (errno != ENOENT)
-        {
-          LOG_ERROR("Failed to delete FIFO pipe: %s, errno: %d", pipe_path.c_str(), errno);
-        }
+        FifoPool::get_instance().release(pipe_path_arg->second.get_string_value(), result == 0);
       }
       break;
     }
@@ -138,6 +138,10 @@ public:
     {
       return validator::validate_schema(params, validator::SchemaRegistry<ResponseT>::fields, validator::SchemaRegistry<ResponseT>::field_count, false);
     };
+    request_schema_ = validator::Schema{validator::SchemaRegistry<RequestT>::fields, validator::SchemaRegistry<RequestT>::field_count, validator::SchemaRegistry<RequestT>::order};
+    has_request_schema_ = true;
+    response_schema_ = validator::Schema{validator::SchemaRegistry<ResponseT>::fields, validator::SchemaRegistry<ResponseT>::field_count, validator::SchemaRegistry<ResponseT>::order};
+    has_response_schema_ = true;
     return *this;
   }
 
@@ -159,23 +163,39 @@ public:
     return request_validator_;
   }
 
+  // Get the request schema for validating params while they are decoded (may be null)
+  const validator::Schema *get_request_schema() const
+  {
+    return has_request_schema_ ? &request_schema_ : nullptr;
+  }
+
   // Get the response validator (may be null)
   validator::ValidatorFn get_response_validator() const
   {
     return response_validator_;
   }
 
+  // Get the response schema for validating results while they are written (may be null)
+  const validator::Schema *get_response_schema() const
+  {
+    return has_response_schema_ ? &response_schema_ : nullptr;
+  }
+
   // Apply input transforms to the context before command execution
   void apply_input_transforms(MiddlewareContext &context) const;
 
-  // Apply output transforms to the context after command execution
-  void apply_output_transforms(MiddlewareContext &context) const;
+  // Apply output transforms to the context after command execution, given the handler's return code
+  void apply_output_transforms(MiddlewareContext &context, int result) const;
 
 private:
   CommandHandler handler_;
   std::vector<ArgTransform> transforms_;
   validator::ValidatorFn request_validator_;
   validator::ValidatorFn response_validator_;
+  validator::Schema request_schema_{nullptr, 0, nullptr};
+  bool has_request_schema_{false};
+  validator::Schema response_schema_{nullptr, 0, nullptr};
+  bool has_response_schema_{false};
 };
 
 #endif
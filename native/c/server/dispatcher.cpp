@@ -18,7 +18,7 @@
 
 using std::string;
 
-bool CommandDispatcher::register_command(const string &command_name, const CommandBuilder &builder)
+bool CommandDispatcher::register_command(const string &command_name, const CommandBuilder &builder, SchedulingClass scheduling)
 {
   if (command_name.empty() || builder.get_handler() == nullptr)
   {
@@ -34,6 +34,7 @@ bool CommandDispatcher::register_command(const string &command_name, const Comma
   }
 
   m_commands.insert(std::make_pair(command_name, builder));
+  m_scheduling[command_name] = scheduling;
 
   LOG_DEBUG("Registered command: %s", command_name.c_str());
   return true;
@@ -59,6 +60,9 @@ int CommandDispatcher::dispatch(const string &command_name, MiddlewareContext &c
     return RpcErrorCode::INTERNAL_ERROR;
   }
 
+  // Nodes built by the transforms and the handler live as long as the request
+  ast::ArenaScope arena_scope(context.get_arena());
+
   try
   {
     LOG_DEBUG("Dispatching command: %s", command_name.c_str());
@@ -70,7 +74,7 @@ int CommandDispatcher::dispatch(const string &command_name, MiddlewareContext &c
     int result = handler(context);
 
     // Apply output transforms
-    builder.apply_output_transforms(context);
+    builder.apply_output_transforms(context, result);
 
     if (result != 0)
     {
@@ -100,6 +104,12 @@ bool CommandDispatcher::has_command(const string &command_name) const
   return m_commands.find(command_name) != m_commands.end();
 }
 
+SchedulingClass CommandDispatcher::get_scheduling_class(const string &command_name) const
+{
+  auto it = m_scheduling.find(command_name);
+  return it != m_scheduling.end() ? it->second : SchedulingClass::Interactive;
+}
+
 std::vector<string> CommandDispatcher::get_registered_commands() const
 {
   std::vector<string> commands;
@@ -125,6 +135,7 @@ bool CommandDispatcher::unregister_command(const string &command_name)
   }
 
   m_commands.erase(it);
+  m_scheduling.erase(command_name);
 
   LOG_DEBUG("Unregistered command: %s", command_name.c_str());
   return true;
@@ -134,4 +145,5 @@ void CommandDispatcher::clear()
 {
   LOG_DEBUG("Clearing all registered commands");
   m_commands.clear();
+  m_scheduling.clear();
 }
@@ -15,6 +15,7 @@
 #include "../extend/plugin.hpp"
 #include "../singleton.hpp"
 #include "builder.hpp"
+#include "worker.hpp"
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -31,8 +32,11 @@ public:
   // CommandHandler type from plugin.hpp
   typedef plugin::CommandProviderImpl::CommandRegistrationContext::CommandHandler CommandHandler;
 
-  // Register a new command using CommandBuilder
-  bool register_command(const std::string &command_name, const CommandBuilder &builder);
+  // Register a new command using CommandBuilder. Bulk commands (data transfers,
+  // long-running searches) are queued behind interactive ones and never run on
+  // the workers reserved for interactive requests.
+  bool register_command(const std::string &command_name, const CommandBuilder &builder,
+                        SchedulingClass scheduling = SchedulingClass::Interactive);
 
   // Dispatch a command by name using the provided context
   int dispatch(const std::string &command_name, MiddlewareContext &context);
@@ -40,6 +44,9 @@ public:
   // Check if a command is registered
   bool has_command(const std::string &command_name) const;
 
+  // Get the scheduling class of a command (Interactive if it is not registered)
+  SchedulingClass get_scheduling_class(const std::string &command_name) const;
+
   // Get list of registered command names
   std::vector<std::string> get_registered_commands() const;
 
@@ -60,6 +67,7 @@ private:
   CommandDispatcher() = default;
 
   std::unordered_map<std::string, CommandBuilder> m_commands;
+  std::unordered_map<std::string, SchedulingClass> m_scheduling;
 };
 
 #endif
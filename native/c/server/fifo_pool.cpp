@@ -0,0 +1,232 @@
+/**
+ * This program and the accompanying materials are made available under the terms of the
+ * Eclipse Public License v2.0 which accompanies this distribution, and is available at
+ * https://www.eclipse.org/legal/epl-v20.html
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Copyright Contributors to the Zowe Project.
+ *
+ */
+
+#include "fifo_pool.hpp"
+#include "logger.hpp"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+void FifoPool::configure(size_t max_idle_channels, std::chrono::milliseconds timeout)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  max_idle = max_idle_channels;
+  lease_timeout = timeout;
+  while (idle.size() > max_idle)
+  {
+    remove(idle.back());
+    idle.pop_back();
+    stats.retired++;
+  }
+}
+
+void FifoPool::prefill(size_t count)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  while (idle.size() < count && idle.size() < max_idle)
+  {
+    Channel channel;
+    std::string error;
+    if (!create(channel, error))
+    {
+      LOG_ERROR("%s", error.c_str());
+      return;
+    }
+    idle.push_back(channel);
+  }
+}
+
+bool FifoPool::lease(std::string &path, std::string &error)
+{
+  const auto now = std::chrono::steady_clock::now();
+  reclaim_stale(now);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  Channel channel;
+  bool found = false;
+  while (!idle.empty())
+  {
+    channel = idle.front();
+    idle.pop_front();
+    if (is_reusable(channel))
+    {
+      found = true;
+      stats.reused++;
+      break;
+    }
+
+    LOG_DEBUG("Removing FIFO pipe %s: it was replaced or is still held open", channel.path.c_str());
+    remove(channel);
+    stats.retired++;
+  }
+
+  if (!found && !create(channel, error))
+  {
+    return false;
+  }
+
+  channel.leased_at = now;
+  path = channel.path;
+  leased[path] = channel;
+  return true;
+}
+
+void FifoPool::release(const std::string &path, bool reusable)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  const auto it = leased.find(path);
+  if (it == leased.end())
+  {
+    // Reclaimed while its request was still running; the FIFO is already gone
+    LOG_DEBUG("FIFO pipe %s was returned after its lease was reclaimed", path.c_str());
+    return;
+  }
+
+  const Channel channel = it->second;
+  leased.erase(it);
+  if (reusable && idle.size() < max_idle)
+  {
+    idle.push_back(channel);
+    return;
+  }
+
+  remove(channel);
+  stats.retired++;
+}
+
+size_t FifoPool::reclaim_stale(std::chrono::steady_clock::time_point now)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  size_t count = 0;
+  for (auto it = leased.begin(); it != leased.end();)
+  {
+    if (now - it->second.leased_at < lease_timeout)
+    {
+      ++it;
+      continue;
+    }
+
+    LOG_WARN("Reclaiming FIFO pipe %s, leased %lld seconds ago", it->first.c_str(),
+             static_cast<long long>(std::chrono::duration_cast<std::chrono::seconds>(now - it->second.leased_at).count()));
+    remove(it->second);
+    it = leased.erase(it);
+    count++;
+  }
+  stats.reclaimed += count;
+  return count;
+}
+
+void FifoPool::shutdown()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  for (const auto &channel : idle)
+    remove(channel);
+  for (const auto &entry : leased)
+    remove(entry.second);
+  idle.clear();
+  leased.clear();
+}
+
+FifoPool::Stats FifoPool::get_stats()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  Stats current = stats;
+  current.idle = idle.size();
+  current.leased = leased.size();
+  return current;
+}
+
+bool FifoPool::create(Channel &channel, std::string &error)
+{
+  const char *tmp_dir = std::getenv("TMPDIR");
+  if (tmp_dir == nullptr || tmp_dir[0] == '\0')
+  {
+    tmp_dir = "/tmp";
+  }
+
+  channel.path = std::string(tmp_dir) + "/zowex_" + std::to_string(geteuid()) + "_" + std::to_string(getpid()) + "_" +
+                 std::to_string(next_id++) + "_fifo";
+
+  // Remove any existing pipe (ignore errors if it doesn't exist)
+  if (unlink(channel.path.c_str()) != 0 && errno != ENOENT)
+  {
+    error = "Failed to delete existing FIFO pipe: " + channel.path + ", errno: " + std::to_string(errno);
+    return false;
+  }
+
+  if (mkfifo(channel.path.c_str(), 0600) != 0)
+  {
+    error = "Failed to create FIFO pipe: " + channel.path + ", errno: " + std::to_string(errno);
+    return false;
+  }
+
+  struct stat st;
+  if (lstat(channel.path.c_str(), &st) != 0)
+  {
+    error = "Failed to check FIFO pipe: " + channel.path + ", errno: " + std::to_string(errno);
+    unlink(channel.path.c_str());
+    return false;
+  }
+  channel.device = st.st_dev;
+  channel.inode = st.st_ino;
+
+  LOG_DEBUG("Created FIFO pipe: %s", channel.path.c_str());
+  stats.created++;
+  return true;
+}
+
+bool FifoPool::is_reusable(const Channel &channel)
+{
+  struct stat st;
+  if (lstat(channel.path.c_str(), &st) != 0 || !S_ISFIFO(st.st_mode) || st.st_uid != geteuid() ||
+      (st.st_mode & 0777) != 0600 || st.st_dev != channel.device || st.st_ino != channel.inode)
+  {
+    return false;
+  }
+
+  // A reader still attached makes a non-blocking open for writing succeed
+  int fd = open(channel.path.c_str(), O_WRONLY | O_NONBLOCK);
+  if (fd >= 0)
+  {
+    close(fd);
+    return false;
+  }
+  if (errno != ENXIO)
+  {
+    return false;
+  }
+
+  // With no writer attached and nothing left unread, a non-blocking read sees end of file
+  fd = open(channel.path.c_str(), O_RDONLY | O_NONBLOCK);
+  if (fd < 0)
+  {
+    return false;
+  }
+  char byte;
+  const ssize_t count = read(fd, &byte, 1);
+  close(fd);
+  return count == 0;
+}
+
+void FifoPool::remove(const Channel &channel)
+{
+  if (unlink(channel.path.c_str()) == 0)
+  {
+    LOG_DEBUG("Cleaned up FIFO pipe: %s", channel.path.c_str());
+  }
+  else if (errno != ENOENT)
+  {
+    LOG_ERROR("Failed to delete FIFO pipe: %s, errno: %d", channel.path.c_str(), errno);
+  }
+}
@@ -0,0 +1,125 @@
+/**
+ * This program and the accompanying materials are made available under the terms of the
+ * Eclipse Public License v2.0 which accompanies this distribution, and is available at
+ * https://www.eclipse.org/legal/epl-v20.html
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Copyright Contributors to the Zowe Project.
+ *
+ */
+
+#ifndef FIFO_POOL_HPP
+#define FIFO_POOL_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <sys/types.h>
+#include "../singleton.hpp"
+
+/**
+ * FIFO channels for streamed reads and writes, reused across requests.
+ *
+ * A streamed request leases a channel, passes its path to the client in a
+ * receiveStream/sendStream notification, and returns it once the request
+ * finishes. A channel whose request completed is kept for the next request
+ * instead of being removed and created again. Before a kept channel is leased
+ * again, it is checked to be the same FIFO the server created, with 0600
+ * permissions, and to be held open by no one. Channels that fail the check,
+ * channels of failed requests and channels leased for longer than the lease
+ * timeout (their request is assumed lost) are removed.
+ *
+ * FIFOs are named {TMPDIR}/zowex_{uid}_{pid}_{id}_fifo, where id numbers the
+ * channels of the server process.
+ */
+class FifoPool : public Singleton<FifoPool>
+{
+  friend class Singleton<FifoPool>;
+
+public:
+  // Channels kept for reuse, unless configured otherwise
+  static constexpr size_t DEFAULT_MAX_IDLE = 8;
+  // Channels created when the server starts
+  static constexpr size_t DEFAULT_PREFILL = 2;
+
+  struct Stats
+  {
+    size_t created;   // Channels created
+    size_t reused;    // Leases served by a kept channel
+    size_t retired;   // Channels removed when returned or found unusable
+    size_t reclaimed; // Leases removed after the lease timeout
+    size_t idle;      // Channels kept for reuse
+    size_t leased;    // Channels currently leased
+  };
+
+  /**
+   * @param max_idle Channels kept for reuse; channels returned beyond this are removed
+   * @param lease_timeout Time after which a lease that was not returned is reclaimed
+   */
+  void configure(size_t max_idle, std::chrono::milliseconds lease_timeout);
+
+  /**
+   * Create channels ahead of the first streamed requests, up to the number kept for reuse
+   */
+  void prefill(size_t count);
+
+  /**
+   * Lease a channel for one streamed request
+   * @param path Receives the path of the FIFO
+   * @param error Receives the reason if no channel could be leased
+   * @return false if no channel could be leased
+   */
+  bool lease(std::string &path, std::string &error);
+
+  /**
+   * Return a leased channel
+   * @param path Path received from lease()
+   * @param reusable Whether the request completed its transfer; otherwise the client may
+   *        still attach to the FIFO later, so it is removed
+   */
+  void release(const std::string &path, bool reusable);
+
+  /**
+   * Remove channels leased for longer than the lease timeout
+   * @return Number of leases reclaimed
+   */
+  size_t reclaim_stale(std::chrono::steady_clock::time_point now);
+
+  /**
+   * Remove every channel, leased or not; called when the server shuts down
+   */
+  void shutdown();
+
+  Stats get_stats();
+
+private:
+  struct Channel
+  {
+    std::string path;
+    dev_t device;
+    ino_t inode;
+    std::chrono::steady_clock::time_point leased_at;
+  };
+
+  std::mutex mutex;
+  std::deque<Channel> idle;
+  std::unordered_map<std::string, Channel> leased;
+  unsigned long long next_id = 1;
+  size_t max_idle = DEFAULT_MAX_IDLE;
+  std::chrono::milliseconds lease_timeout{std::chrono::minutes(10)};
+  Stats stats{};
+
+  FifoPool() = default;
+
+  // Create a FIFO with a new id; called with the mutex held
+  bool create(Channel &channel, std::string &error);
+  // Whether a kept channel is still the FIFO created for it and nothing holds it open
+  static bool is_reusable(const Channel &channel);
+  static void remove(const Channel &channel);
+};
+
+#endif
@@ -0,0 +1,383 @@
+/**
+ * This program and the accompanying materials are made available under the terms of the
+ * Eclipse Public License v2.0 which accompanies this distribution, and is available at
+ * https://www.eclipse.org/legal/epl-v20.html
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Copyright Contributors to the Zowe Project.
+ *
+ */
+
+#include "frame.hpp"
+#include "logger.hpp"
+#include "response_writer.hpp"
+#include "../ztype.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <vector>
+#if defined(__MVS__)
+#include <iconv.h>
+#endif
+
+namespace frame
+{
+#if defined(__MVS__)
+// Byte-for-byte conversion table between two single-byte code pages
+class WireTable
+{
+public:
+  WireTable(const char *to_code, const char *from_code)
+  {
+    for (int i = 0; i < 256; ++i)
+      table[i] = static_cast<unsigned char>(i);
+
+    iconv_t cd = iconv_open(to_code, from_code);
+    if (cd == (iconv_t)-1)
+    {
+      LOG_ERROR("Failed to open conversion from %s to %s for binary frames", from_code, to_code);
+      return;
+    }
+    char input[256];
+    char output[256];
+    for (int i = 0; i < 256; ++i)
+      input[i] = static_cast<char>(i);
+    char *in = input;
+    char *out = output;
+    size_t in_left = sizeof(input);
+    size_t out_left = sizeof(output);
+    if (iconv(cd, &in, &in_left, &out, &out_left) == (size_t)-1 || out_left != 0)
+      LOG_ERROR("Failed to build conversion from %s to %s for binary frames", from_code, to_code);
+    else
+      memcpy(table, output, sizeof(table));
+    iconv_close(cd);
+  }
+
+  void apply(char *data, size_t length) const
+  {
+    auto *bytes = reinterpret_cast<unsigned char *>(data);
+    for (size_t i = 0; i < length; ++i)
+      bytes[i] = table[bytes[i]];
+  }
+
+private:
+  unsigned char table[256];
+};
+
+void from_wire(char *data, size_t length)
+{
+  static const WireTable table("ISO8859-1", "IBM-1047");
+  table.apply(data, length);
+}
+
+void to_wire(char *data, size_t length)
+{
+  static const WireTable table("IBM-1047", "ISO8859-1");
+  table.apply(data, length);
+}
+#else
+void from_wire(char *, size_t)
+{
+}
+
+void to_wire(char *, size_t)
+{
+}
+#endif
+
+static void put_u32(char *out, uint32_t value)
+{
+  out[0] = static_cast<char>((value >> 24) & 0xFF);
+  out[1] = static_cast<char>((value >> 16) & 0xFF);
+  out[2] = static_cast<char>((value >> 8) & 0xFF);
+  out[3] = static_cast<char>(value & 0xFF);
+}
+
+static uint32_t get_u32(const char *in)
+{
+  const auto *bytes = reinterpret_cast<const unsigned char *>(in);
+  return (static_cast<uint32_t>(bytes[0]) << 24) | (static_cast<uint32_t>(bytes[1]) << 16) |
+         (static_cast<uint32_t>(bytes[2]) << 8) | static_cast<uint32_t>(bytes[3]);
+}
+
+void encode_header(const Header &header, char out[HEADER_SIZE])
+{
+  out[0] = MARKER;
+  out[1] = static_cast<char>(header.flags);
+  out[2] = 0;
+  out[3] = 0;
+  put_u32(out + 4, static_cast<uint32_t>(header.request_id));
+  put_u32(out + 8, header.length);
+}
+
+bool decode_header(const char in[HEADER_SIZE], Header &header)
+{
+  if (in[0] != MARKER || in[2] != 0 || in[3] != 0)
+    return false;
+
+  header.flags = static_cast<unsigned char>(in[1]);
+  if ((header.flags & ~FLAG_FINAL) != 0)
+    return false;
+  header.request_id = static_cast<int32_t>(get_u32(in + 4));
+  header.length = get_u32(in + 8);
+  return true;
+}
+
+bool read_header(std::istream &in, Header &header)
+{
+  char bytes[HEADER_SIZE];
+  if (!in.read(bytes, HEADER_SIZE))
+    return false;
+  from_wire(bytes, HEADER_SIZE);
+  return decode_header(bytes, header);
+}
+
+bool read_payload(std::istream &in, const Header &header, std::string &payload)
+{
+  payload.resize(header.length);
+  if (header.length > 0 && !in.read(&payload[0], header.length))
+    return false;
+  from_wire(&payload[0], payload.size());
+  return true;
+}
+
+bool skip_payload(std::istream &in, const Header &header)
+{
+  in.ignore(static_cast<std::streamsize>(header.length));
+  return static_cast<uint32_t>(in.gcount()) == header.length;
+}
+
+bool read_frame(std::istream &in, Header &header, std::string &payload)
+{
+  return read_header(in, header) && header.length <= MAX_FRAME_PAYLOAD && read_payload(in, header, payload);
+}
+} // namespace frame
+
+void FrameChannel::set_binary(bool enabled)
+{
+  binary.store(enabled, std::memory_order_relaxed);
+  if (!enabled)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    payloads.clear();
+    total_bytes = 0;
+  }
+}
+
+void FrameChannel::configure(std::chrono::milliseconds payload_ttl)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  this->payload_ttl = payload_ttl;
+}
+
+bool FrameChannel::read_frame(std::istream &in)
+{
+  frame::Header header{};
+  if (!frame::read_header(in, header))
+  {
+    if (!in)
+      return false;
+    // Without a valid header the length cannot be trusted, so look for the next request line instead
+    LOG_ERROR("Skipping binary frame with a malformed header up to the next line");
+    in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    return true;
+  }
+
+  if (!admit(header))
+    return frame::skip_payload(in, header);
+
+  std::string payload;
+  if (!frame::read_payload(in, header, payload))
+    return false;
+  receive(header, std::move(payload));
+  return true;
+}
+
+bool FrameChannel::admit(const frame::Header &header)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return admit_locked(header, std::chrono::steady_clock::now()) != nullptr;
+}
+
+FrameChannel::Payload *FrameChannel::admit_locked(const frame::Header &header, std::chrono::steady_clock::time_point now)
+{
+  expire_stale_locked(now);
+
+  Payload &entry = payloads[header.request_id];
+  if (!entry.rejection.empty())
+    return nullptr;
+  entry.received_at = now;
+  if (entry.complete)
+  {
+    // A new payload for an id whose last one was never used replaces it
+    total_bytes -= entry.data.size();
+    entry = Payload();
+    entry.received_at = now;
+  }
+
+  if (!is_binary())
+  {
+    reject(header.request_id, entry, "Binary framing is not enabled");
+    return nullptr;
+  }
+  if (header.length > frame::MAX_FRAME_PAYLOAD)
+  {
+    reject(header.request_id, entry, "Binary frame of " + std::to_string(header.length) + " bytes exceeds the limit of " +
+                                         std::to_string(frame::MAX_FRAME_PAYLOAD) + " bytes per frame");
+    return nullptr;
+  }
+  if (total_bytes + header.length > frame::MAX_PENDING_BYTES)
+  {
+    reject(header.request_id, entry, "Binary payloads waiting for their requests exceed the limit of " +
+                                         std::to_string(frame::MAX_PENDING_BYTES) + " bytes");
+    return nullptr;
+  }
+  return &entry;
+}
+
+void FrameChannel::reject(int request_id, Payload &entry, std::string reason)
+{
+  LOG_WARN("Rejecting binary payload for request %d: %s", request_id, reason.c_str());
+  total_bytes -= entry.data.size();
+  entry.data = std::string();
+  entry.complete = false;
+  entry.rejection = std::move(reason);
+}
+
+bool FrameChannel::receive(const frame::Header &header, std::string payload)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  Payload *entry = admit_locked(header, std::chrono::steady_clock::now());
+  if (entry == nullptr)
+    return false;
+
+  total_bytes += payload.size();
+  if (entry->data.empty())
+    entry->data = std::move(payload);
+  else
+    entry->data.append(payload);
+  entry->complete = (header.flags & frame::FLAG_FINAL) != 0;
+  return true;
+}
+
+bool FrameChannel::take_rejection(int request_id, std::string &reason)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  const auto it = payloads.find(request_id);
+  if (it == payloads.end() || it->second.rejection.empty())
+    return false;
+
+  reason = std::move(it->second.rejection);
+  payloads.erase(it);
+  return true;
+}
+
+bool FrameChannel::take_payload(int request_id, std::string &payload)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  const auto it = payloads.find(request_id);
+  if (it == payloads.end() || !it->second.complete)
+    return false;
+
+  total_bytes -= it->second.data.size();
+  payload = std::move(it->second.data);
+  payloads.erase(it);
+  return true;
+}
+
+void FrameChannel::discard_payload(int request_id)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  if (payloads.empty())
+    return;
+
+  const auto it = payloads.find(request_id);
+  if (it != payloads.end())
+  {
+    LOG_DEBUG("Discarding %zu bytes received for request %d that it did not use", it->second.data.size(), request_id);
+    total_bytes -= it->second.data.size();
+    payloads.erase(it);
+  }
+}
+
+void FrameChannel::send_payload(int request_id, std::string payload)
+{
+  ResponseWriter &writer = ResponseWriter::get_instance();
+  if (!payload.empty())
+    frame::to_wire(&payload[0], payload.size());
+
+  const auto header = [request_id](unsigned char flags, size_t length)
+  {
+    std::string bytes(frame::HEADER_SIZE, '\0');
+    frame::encode_header(frame::Header{flags, request_id, static_cast<uint32_t>(length)}, &bytes[0]);
+    frame::to_wire(&bytes[0], bytes.size());
+    return bytes;
+  };
+
+  if (payload.size() <= frame::MAX_FRAME_PAYLOAD)
+  {
+    std::vector<std::string> segments(2);
+    segments[0] = header(frame::FLAG_FINAL, payload.size());
+    segments[1] = std::move(payload);
+    writer.write_raw(ResponseWriter::Output, std::move(segments));
+    return;
+  }
+
+  for (size_t offset = 0; offset < payload.size(); offset += frame::MAX_FRAME_PAYLOAD)
+  {
+    const size_t length = std::min(frame::MAX_FRAME_PAYLOAD, payload.size() - offset);
+    std::vector<std::string> segments(2);
+    segments[0] = header(offset + length == payload.size() ? frame::FLAG_FINAL : 0, length);
+    segments[1] = payload.substr(offset, length);
+    writer.write_raw(ResponseWriter::Output, std::move(segments));
+  }
+}
+
+size_t FrameChannel::pending_bytes()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return total_bytes;
+}
+
+size_t FrameChannel::expire_stale(std::chrono::steady_clock::time_point now)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return expire_stale_locked(now);
+}
+
+size_t FrameChannel::expire_stale_locked(std::chrono::steady_clock::time_point now)
+{
+  size_t expired = 0;
+  for (auto it = payloads.begin(); it != payloads.end();)
+  {
+    if (now - it->second.received_at < payload_ttl)
+    {
+      ++it;
+      continue;
+    }
+    LOG_WARN("Dropping %zu bytes received for request %d, which did not arrive", it->second.data.size(), it->first);
+    total_bytes -= it->second.data.size();
+    it = payloads.erase(it);
+    ++expired;
+  }
+  return expired;
+}
+
+int handle_set_framing(plugin::InvocationContext &context)
+{
+  const std::string mode = context.get<std::string>("mode", "");
+  if (mode != "json" && mode != "binary")
+  {
+    context.errln("Framing mode must be \"json\" or \"binary\"");
+    return RTNCD_FAILURE;
+  }
+
+  FrameChannel::get_instance().set_binary(mode == "binary");
+  LOG_INFO("Data of inline reads and writes now travels as %s", mode == "binary" ? "binary frames" : "Base64 text");
+
+  const auto result = ast::obj();
+  result->set("mode", ast::str(mode));
+  context.set_object(result);
+  return RTNCD_SUCCESS;
+}
@@ -0,0 +1,232 @@
+/**
+ * This program and the accompanying materials are made available under the terms of the
+ * Eclipse Public License v2.0 which accompanies this distribution, and is available at
+ * https://www.eclipse.org/legal/epl-v20.html
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Copyright Contributors to the Zowe Project.
+ *
+ */
+
+#ifndef FRAME_HPP
+#define FRAME_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "../singleton.hpp"
+#include "../extend/plugin.hpp"
+
+/**
+ * Binary frames for the data of inline reads and writes.
+ *
+ * Once a client switches the session to binary framing (setFraming), the
+ * contents that would travel as Base64 text in the `data` field of a request
+ * or response travel as raw bytes instead. Frames share stdin and stdout with
+ * the JSON-RPC lines. A frame starts with a NUL byte, which never starts a
+ * JSON line, followed by the rest of a 12-byte header and the payload:
+ *
+ *   byte 0      0x00
+ *   byte 1      flags (FLAG_FINAL on the last frame of a payload)
+ *   bytes 2-3   reserved, 0
+ *   bytes 4-7   id of the JSON-RPC request the payload belongs to (big-endian)
+ *   bytes 8-11  payload length (big-endian)
+ *
+ * A client sends the frames of a write before the request line and leaves out
+ * its `data` field. The server writes the frames of a read before the response
+ * line, whose `data` field is then empty. Neither side sends a frame longer than
+ * MAX_FRAME_PAYLOAD; longer payloads are split over several frames.
+ */
+namespace frame
+{
+constexpr char MARKER = '\0';
+constexpr size_t HEADER_SIZE = 12;
+constexpr unsigned char FLAG_FINAL = 0x01;
+// Largest payload of a single frame; longer payloads are split, and longer frames are rejected
+constexpr size_t MAX_FRAME_PAYLOAD = 1024 * 1024;
+// Largest total of payload bytes held for requests that have not taken them yet
+constexpr size_t MAX_PENDING_BYTES = 64 * 1024 * 1024;
+
+struct Header
+{
+  unsigned char flags;
+  int32_t request_id;
+  uint32_t length;
+};
+
+void encode_header(const Header &header, char out[HEADER_SIZE]);
+
+/**
+ * @return false if the bytes do not start a frame, or set reserved bits or bytes
+ */
+bool decode_header(const char in[HEADER_SIZE], Header &header);
+
+/**
+ * Map bytes the server writes to how they travel, and bytes that arrive back to how the client
+ * sent them. On z/OS the SSH session converts stdin and stdout between ISO8859-1 and IBM-1047 one
+ * byte at a time, as it does for the JSON text, so frames are mapped ahead of that conversion.
+ * Elsewhere the bytes are left as they are.
+ */
+void to_wire(char *data, size_t length);
+void from_wire(char *data, size_t length);
+
+/**
+ * Read the header of a frame from a stream positioned at its marker
+ * @return false if the stream ended before the end of the header or the header is malformed
+ */
+bool read_header(std::istream &in, Header &header);
+
+/**
+ * Read the payload of a frame whose header was read, mapping its bytes back from the wire
+ * @return false if the stream ended before the end of the payload
+ */
+bool read_payload(std::istream &in, const Header &header, std::string &payload);
+
+/**
+ * Consume the payload of a frame whose header was read, without holding on to its bytes
+ * @return false if the stream ended before the end of the payload
+ */
+bool skip_payload(std::istream &in, const Header &header);
+
+/**
+ * Read one frame from a stream positioned at its marker
+ * @return false if the stream ended before the end of the frame, the header is malformed,
+ *         or the payload is longer than MAX_FRAME_PAYLOAD
+ */
+bool read_frame(std::istream &in, Header &header, std::string &payload);
+} // namespace frame
+
+/**
+ * Framing mode of the session and the payloads received for requests that
+ * have not used them yet.
+ */
+class FrameChannel : public Singleton<FrameChannel>
+{
+  friend class Singleton<FrameChannel>;
+
+public:
+  bool is_binary() const
+  {
+    return binary.load(std::memory_order_relaxed);
+  }
+
+  void set_binary(bool enabled);
+
+  /**
+   * @param payload_ttl Time after which a payload whose request has not arrived is dropped
+   */
+  void configure(std::chrono::milliseconds payload_ttl);
+
+  /**
+   * Read the frame at the front of the client input and keep its payload for its request (input thread).
+   * A frame that arrives while binary framing is off, is longer than MAX_FRAME_PAYLOAD or would hold
+   * more than MAX_PENDING_BYTES is consumed without keeping its bytes, and its request is failed when
+   * it arrives. A frame with a malformed header is skipped up to the next line.
+   * @return false if the input ended inside the frame
+   */
+  bool read_frame(std::istream &in);
+
+  /**
+   * Add the payload of a frame received from the client (input thread)
+   * @return false if the payload was rejected for the limits above and not kept
+   */
+  bool receive(const frame::Header &header, std::string payload);
+
+  /**
+   * Take the reason the payload sent for a request was rejected
+   * @return false if no payload was rejected for the request
+   */
+  bool take_rejection(int request_id, std::string &reason);
+
+  /**
+   * Take the complete payload received for a request
+   * @return false if no complete payload was received for the request
+   */
+  bool take_payload(int request_id, std::string &payload);
+
+  /**
+   * Drop whatever was received for a request
+   */
+  void discard_payload(int request_id);
+
+  /**
+   * Write a payload to the client as frames tagged with the request id, ahead of
+   * the responses queued after it
+   */
+  void send_payload(int request_id, std::string payload);
+
+  /**
+   * Bytes received and not yet taken, for all requests
+   */
+  size_t pending_bytes();
+
+  /**
+   * Drop the payloads and rejections of requests that have not arrived within the payload TTL
+   * @return Number of entries dropped
+   */
+  size_t expire_stale(std::chrono::steady_clock::time_point now);
+
+  /**
+   * Drops the payload received for a request, if the request did not take it,
+   * once the request finishes
+   */
+  class PayloadGuard
+  {
+  public:
+    explicit PayloadGuard(int request_id)
+        : request_id(request_id)
+    {
+    }
+    ~PayloadGuard()
+    {
+      FrameChannel::get_instance().discard_payload(request_id);
+    }
+
+    PayloadGuard(const PayloadGuard &) = delete;
+    PayloadGuard &operator=(const PayloadGuard &) = delete;
+
+  private:
+    int request_id;
+  };
+
+private:
+  struct Payload
+  {
+    std::string data;
+    bool complete = false;
+    // Set once a frame for the request was rejected; later frames for it are skipped
+    std::string rejection;
+    std::chrono::steady_clock::time_point received_at;
+  };
+
+  std::atomic<bool> binary{false};
+  std::mutex mutex;
+  std::unordered_map<int, Payload> payloads;
+  size_t total_bytes = 0;
+  std::chrono::milliseconds payload_ttl{std::chrono::minutes(10)};
+
+  FrameChannel() = default;
+
+  // Whether the payload of a frame can be kept, rejecting it otherwise
+  bool admit(const frame::Header &header);
+  // The entry the payload of a frame is added to, or nullptr if it is rejected; called with the mutex held
+  Payload *admit_locked(const frame::Header &header, std::chrono::steady_clock::time_point now);
+  // Mark the payload of a request as rejected and free what was kept of it; called with the mutex held
+  void reject(int request_id, Payload &entry, std::string reason);
+  // Called with the mutex held
+  size_t expire_stale_locked(std::chrono::steady_clock::time_point now);
+};
+
+/**
+ * Handler for setFraming: switches the session between Base64 text ("json")
+ * and binary frames ("binary") for the data of inline reads and writes
+ */
+int handle_set_framing(plugin::InvocationContext &context);
+
+#endif
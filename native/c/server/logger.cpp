@@ -0,0 +1,480 @@
+/**
+ * This program and the accompanying materials are made available under the terms of the
+ * Eclipse Public License v2.0 which accompanies this distribution, and is available at
+ * https://www.eclipse.org/legal/epl-v20.html
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Copyright Contributors to the Zowe Project.
+ *
+ */
+
+#include "logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace server
+{
+namespace
+{
+// Bytes buffered per thread before it has to wait for the writer thread
+constexpr size_t THREAD_BUFFER_SIZE = 64 * 1024;
+// How long the writer thread sleeps when no thread signals new lines
+constexpr auto WRITER_IDLE_INTERVAL = std::chrono::milliseconds(100);
+
+/**
+ * Single-producer, single-consumer ring of complete log records. The owning
+ * thread appends; only the writer thread drains.
+ */
+struct ThreadBuffer
+{
+  char data[THREAD_BUFFER_SIZE];
+  std::atomic<size_t> head{0};       // Total bytes appended (producer)
+  std::atomic<size_t> tail{0};       // Total bytes drained (consumer)
+  std::atomic<bool> orphaned{false}; // Set when the owning thread exits
+
+  bool push(const void *header, size_t header_size, const char *payload, size_t payload_size)
+  {
+    const size_t h = head.load(std::memory_order_relaxed);
+    const size_t t = tail.load(std::memory_order_acquire);
+    if (THREAD_BUFFER_SIZE - (h - t) < header_size + payload_size)
+    {
+      return false;
+    }
+
+    copy_in(h, static_cast<const char *>(header), header_size);
+    copy_in(h + header_size, payload, payload_size);
+    head.store(h + header_size + payload_size, std::memory_order_release);
+    return true;
+  }
+
+  void drain(std::string &out)
+  {
+    const size_t t = tail.load(std::memory_order_relaxed);
+    const size_t h = head.load(std::memory_order_acquire);
+    if (h == t)
+    {
+      return;
+    }
+
+    const size_t offset = t % THREAD_BUFFER_SIZE;
+    const size_t length = h - t;
+    const size_t first = std::min(length, THREAD_BUFFER_SIZE - offset);
+    out.append(data + offset, first);
+    out.append(data, length - first);
+    tail.store(h, std::memory_order_release);
+  }
+
+private:
+  void copy_in(size_t position, const char *bytes, size_t length)
+  {
+    const size_t offset = position % THREAD_BUFFER_SIZE;
+    const size_t first = std::min(length, THREAD_BUFFER_SIZE - offset);
+    memcpy(data + offset, bytes, first);
+    memcpy(data, bytes + first, length - first);
+  }
+};
+
+/**
+ * Header of each record in a thread buffer, followed by `payload_size` bytes: the
+ * formatted message, or the captured arguments when there is a formatter
+ */
+struct RecordHeader
+{
+  size_t payload_size;
+  time_t time;
+  Logger::Level level;
+  const char *format;
+  Logger::Formatter formatter;
+};
+
+const char *const LEVEL_NAMES[] = {"DEBUG", "INFO", "WARN", "ERROR", "FATAL"};
+
+struct LoggerState
+{
+  // Guards the list of thread buffers; taken once per thread and once per writer pass
+  std::mutex buffers_mutex;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+
+  // Writer thread and its wake-up signal
+  std::mutex writer_mutex;
+  std::condition_variable writer_condition;
+  std::atomic<bool> signaled{false};
+  std::atomic<bool> running{false};
+  bool stopping = false;
+  std::thread writer_thread;
+
+  // Log file, owned by the writer thread while it runs
+  int fd = -1;
+  std::string path;
+  size_t file_size = 0;
+  size_t max_file_size = Logger::MAX_LOG_SIZE;
+  int max_files = Logger::MAX_LOG_FILES;
+};
+
+LoggerState &get_state()
+{
+  static LoggerState *state = new LoggerState(); // Never destroyed, so threads can log during exit
+  return *state;
+}
+
+// Trivially destructible, so still readable while thread-local objects are being destroyed
+thread_local ThreadBuffer *current_buffer = nullptr;
+thread_local bool thread_exited = false;
+
+/**
+ * Registers the thread's buffer on first use and marks it orphaned when the
+ * thread exits, so that the writer thread can drain and release it
+ */
+struct ThreadBufferHandle
+{
+  std::shared_ptr<ThreadBuffer> buffer;
+
+  ThreadBufferHandle()
+      : buffer(std::make_shared<ThreadBuffer>())
+  {
+    LoggerState &state = get_state();
+    const std::lock_guard<std::mutex> lock(state.buffers_mutex);
+    state.buffers.push_back(buffer);
+  }
+
+  ~ThreadBufferHandle()
+  {
+    thread_exited = true;
+    current_buffer = nullptr;
+    buffer->orphaned.store(true, std::memory_order_release);
+  }
+};
+
+/**
+ * The calling thread's buffer, or nullptr once the thread has started to exit
+ */
+ThreadBuffer *get_thread_buffer()
+{
+  if (current_buffer == nullptr && !thread_exited)
+  {
+    thread_local ThreadBufferHandle handle;
+    current_buffer = handle.buffer.get();
+  }
+  return current_buffer;
+}
+
+/**
+ * Write "YYYY-MM-DD HH:MM:SS" into `out`, calling localtime_r at most once per second per thread
+ */
+void format_timestamp(time_t now, char (&out)[20])
+{
+  thread_local time_t cached_time = -1;
+  thread_local char cached[20];
+
+  if (now != cached_time)
+  {
+    struct tm timeinfo;
+    localtime_r(&now, &timeinfo);
+    strftime(cached, sizeof(cached), "%Y-%m-%d %H:%M:%S", &timeinfo);
+    cached_time = now;
+  }
+  memcpy(out, cached, sizeof(cached));
+}
+
+void wake_writer(LoggerState &state)
+{
+  if (!state.signaled.exchange(true, std::memory_order_acq_rel))
+  {
+    state.writer_condition.notify_one();
+  }
+}
+
+/**
+ * Hand one complete record to the writer thread. If the thread's buffer is
+ * full, wait for the writer thread to drain it.
+ */
+void enqueue(const RecordHeader &header, const char *payload)
+{
+  LoggerState &state = get_state();
+  ThreadBuffer *buffer = get_thread_buffer();
+  if (buffer == nullptr)
+  {
+    return; // Logging from a thread-local destructor
+  }
+
+  while (!buffer->push(&header, sizeof(header), payload, header.payload_size))
+  {
+    if (!state.running.load(std::memory_order_acquire))
+    {
+      return; // No writer thread to make room, so the record is dropped
+    }
+    wake_writer(state);
+    std::this_thread::yield();
+  }
+  wake_writer(state);
+}
+
+void write_all(LoggerState &state, const char *data, size_t length)
+{
+  while (length > 0 && state.fd != -1)
+  {
+    const ssize_t written = write(state.fd, data, length);
+    if (written < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      std::cerr << "Failed to write to log file: " << state.path << ": " << strerror(errno) << std::endl;
+      return;
+    }
+
+    data += written;
+    length -= static_cast<size_t>(written);
+    state.file_size += static_cast<size_t>(written);
+  }
+}
+
+/**
+ * Shift zowex_server.log.N-1 to .N, ..., the active file to .1, then start a new active file
+ */
+void rotate_log_file(LoggerState &state)
+{
+  close(state.fd);
+  state.fd = -1;
+
+  for (int i = state.max_files - 1; i > 0; i--)
+  {
+    const std::string from = i == 1 ? state.path : state.path + "." + std::to_string(i - 1);
+    const std::string to = state.path + "." + std::to_string(i);
+    rename(from.c_str(), to.c_str());
+  }
+
+  state.fd = open(state.path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0600);
+  state.file_size = 0;
+  if (state.fd == -1)
+  {
+    std::cerr << "Failed to rotate log file: " << state.path << std::endl;
+    return;
+  }
+
+  char timestamp[20];
+  format_timestamp(time(nullptr), timestamp);
+  const std::string notice = std::string(timestamp) + (state.max_files > 1 ? " [INFO] Log file rotated due to size limit\n" : " [INFO] Log file truncated due to size limit\n");
+  write_all(state, notice.data(), notice.size());
+}
+
+/**
+ * Move the records buffered by all threads into `records`, releasing the buffers of exited threads
+ */
+void drain_buffers(LoggerState &state, std::string &records)
+{
+  const std::lock_guard<std::mutex> lock(state.buffers_mutex);
+  for (auto it = state.buffers.begin(); it != state.buffers.end();)
+  {
+    // Read the flag first, so that nothing the thread wrote before exiting is missed
+    const bool orphaned = (*it)->orphaned.load(std::memory_order_acquire);
+    (*it)->drain(records);
+    it = orphaned ? state.buffers.erase(it) : it + 1;
+  }
+}
+
+/**
+ * Format each record as "<timestamp> [<level>] <message>\n" into `batch`
+ */
+void format_records(const std::string &records, std::string &batch)
+{
+  char message[Logger::LOG_BUFFER_SIZE];
+  size_t offset = 0;
+  while (offset + sizeof(RecordHeader) <= records.size())
+  {
+    RecordHeader header;
+    memcpy(&header, records.data() + offset, sizeof(header));
+    const char *payload = records.data() + offset + sizeof(header);
+    offset += sizeof(header) + header.payload_size;
+
+    char timestamp[20];
+    format_timestamp(header.time, timestamp);
+    batch.append(timestamp);
+    batch.append(" [");
+    batch.append(LEVEL_NAMES[header.level]);
+    batch.append("] ");
+
+    if (header.formatter == nullptr)
+    {
+      batch.append(payload, header.payload_size);
+    }
+    else
+    {
+      const int length = header.formatter(header.format, payload, message, sizeof(message));
+      if (length > 0)
+      {
+        batch.append(message, std::min(static_cast<size_t>(length), sizeof(message) - 1));
+      }
+    }
+    batch.push_back('\n');
+  }
+}
+
+void write_batch(LoggerState &state, const std::string &batch)
+{
+  if (batch.empty())
+  {
+    return;
+  }
+
+  // Rotate before writing, so that the newest lines are always in the active file
+  if (state.fd != -1 && state.file_size >= state.max_file_size)
+  {
+    rotate_log_file(state);
+  }
+  write_all(state, batch.data(), batch.size());
+}
+
+void writer_loop()
+{
+  LoggerState &state = get_state();
+  std::string records;
+  std::string batch;
+  bool stop = false;
+  while (!stop)
+  {
+    {
+      std::unique_lock<std::mutex> lock(state.writer_mutex);
+      state.writer_condition.wait_for(lock, WRITER_IDLE_INTERVAL, [&state]
+                                      { return state.stopping || state.signaled.load(std::memory_order_acquire); });
+      stop = state.stopping;
+    }
+    state.signaled.store(false, std::memory_order_release);
+
+    records.clear();
+    batch.clear();
+    drain_buffers(state, records);
+    format_records(records, batch);
+    write_batch(state, batch);
+  }
+}
+
+} // namespace
+
+void Logger::init_logger(const char *exec_dir, bool verbose, bool truncate, size_t max_file_size, int max_files)
+{
+  shutdown();
+
+  LoggerState &state = get_state();
+  get_verbose_logging().store(verbose, std::memory_order_relaxed);
+
+  // Create logs directory
+  const std::string logs_dir = std::string(exec_dir) + "/logs";
+
+  if (mkdir(logs_dir.c_str(), 0700) != 0 && errno != EEXIST)
+  {
+    std::cerr << "Failed to create logs directory: " << logs_dir << std::endl;
+    return;
+  }
+
+  // Create/open file with restricted permissions (0600)
+  state.path = logs_dir + "/zowex_server.log";
+  state.fd = open(state.path.c_str(), O_WRONLY | O_CREAT | O_APPEND | (truncate ? O_TRUNC : 0), 0600);
+  if (state.fd == -1)
+  {
+    std::cerr << "Failed to create log file: " << state.path << std::endl;
+    return;
+  }
+
+  // Size is tracked from here on as lines are written
+  struct stat st;
+  state.file_size = fstat(state.fd, &st) == 0 ? static_cast<size_t>(st.st_size) : 0;
+  state.max_file_size = max_file_size;
+  state.max_files = max_files > 0 ? max_files : 1;
+
+  state.stopping = false;
+  state.running.store(true, std::memory_order_release);
+  state.writer_thread = std::thread(writer_loop);
+  get_level().store(verbose ? Debug : Info, std::memory_order_release);
+
+  if (verbose)
+  {
+    log_debug("Verbose logging enabled");
+  }
+}
+
+void Logger::log_message(Level level, const char *format, va_list args)
+{
+  char message[LOG_BUFFER_SIZE];
+  const int length = vsnprintf(message, sizeof(message), format, args);
+  enqueue_record(level, nullptr, nullptr, message, length > 0 ? std::min(static_cast<size_t>(length), sizeof(message) - 1) : 0);
+}
+
+void Logger::enqueue_record(Level level, const char *format, Formatter formatter, const char *payload, size_t size)
+{
+  const RecordHeader header = {size, time(nullptr), level, format, formatter};
+  enqueue(header, payload);
+}
+
+void Logger::log_fatal(const char *format, ...)
+{
+  char buffer[LOG_BUFFER_SIZE];
+  va_list args;
+  va_start(args, format);
+
+  va_list args_copy;
+  va_copy(args_copy, args);
+
+  vsnprintf(buffer, sizeof(buffer), format, args);
+
+  if (is_enabled(Fatal))
+  {
+    log_message(Fatal, format, args_copy);
+    shutdown();
+  }
+
+  va_end(args_copy);
+  va_end(args);
+
+  // Also print to stderr
+  std::cerr << "FATAL: " << buffer << std::endl;
+
+  exit(1);
+}
+
+void Logger::shutdown()
+{
+  LoggerState &state = get_state();
+  get_level().store(Off, std::memory_order_release);
+
+  {
+    const std::lock_guard<std::mutex> lock(state.writer_mutex);
+    if (!state.running.load(std::memory_order_acquire))
+    {
+      return;
+    }
+    state.stopping = true;
+  }
+  state.writer_condition.notify_one();
+
+  // The writer drains all buffers once more before it exits
+  if (state.writer_thread.joinable())
+  {
+    state.writer_thread.join();
+  }
+  state.running.store(false, std::memory_order_release);
+
+  if (state.fd != -1)
+  {
+    close(state.fd);
+    state.fd = -1;
+  }
+}
+
+} // namespace server
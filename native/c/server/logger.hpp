@@ -12,203 +12,76 @@
 #ifndef LOGGER_HPP
 #define LOGGER_HPP
 
-#include <fstream>
-#include <string>
-#include <mutex>
-#include <cstdio>
+#include <algorithm>
+#include <atomic>
 #include <cstdarg>
-#include <ctime>
-#include <cstdlib>
-#include <cerrno>
-#include <sys/stat.h>
-#include <fcntl.h>
-#include <unistd.h>
-#include <iostream>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
 namespace server
 {
+/**
+ * Server log, written to <exec_dir>/logs/zowex_server.log.
+ *
+ * Each thread formats its own lines into a private lock-free ring buffer and
+ * returns immediately. A background thread drains all ring buffers and writes
+ * them with one write(2) per batch. The file size is tracked in-process, and
+ * once it reaches the size limit the file is rotated to zowex_server.log.1,
+ * .2, ... keeping a fixed number of files. Lines from one thread keep their
+ * order; lines from different threads can interleave by up to one batch.
+ */
 class Logger
 {
-private:
-  // Buffer size for log messages
-  static constexpr size_t LOG_BUFFER_SIZE = 4096;
-  // Maximum log file size before truncation (10MB)
-  static constexpr size_t MAX_LOG_SIZE = 10 * 1024 * 1024;
-
-  static std::ofstream &get_log_file()
-  {
-    static std::ofstream log_file;
-    return log_file;
-  }
-
-  static bool &get_verbose_logging()
-  {
-    static bool verbose_logging = false;
-    return verbose_logging;
-  }
-
-  static std::mutex &get_log_mutex()
-  {
-    static std::mutex log_mutex;
-    return log_mutex;
-  }
-
-  static bool &get_initialized()
-  {
-    static bool initialized = false;
-    return initialized;
-  }
-
-  static std::string &get_log_file_path()
-  {
-    static std::string log_file_path;
-    return log_file_path;
-  }
-
-  /**
-   * Get the current timestamp as a formatted string
-   */
-  static std::string get_current_timestamp()
-  {
-    const auto now = time(nullptr);
-    struct tm timeinfo;
-    localtime_r(&now, &timeinfo);
-
-    char buffer[80];
-    strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &timeinfo);
-    return std::string(buffer);
-  }
-
-  /**
-   * Check log file size and truncate if necessary
-   */
-  static void check_and_truncate_log_file()
-  {
-    const auto &log_file_path = get_log_file_path();
-    std::ofstream &log_file = get_log_file();
-
-    if (log_file_path.empty() || !log_file.is_open())
-    {
-      return;
-    }
-
-    struct stat st;
-    if (stat(log_file_path.c_str(), &st) == 0)
-    {
-      if (static_cast<size_t>(st.st_size) > MAX_LOG_SIZE)
-      {
-        log_file.close();
-
-        // Reopen the file in truncate mode
-        log_file.open(log_file_path.c_str(), std::ios::out | std::ios::trunc);
-        if (!log_file.is_open())
-        {
-          std::cerr << "Failed to truncate log file: " << log_file_path << std::endl;
-          return;
-        }
-
-        log_file << get_current_timestamp() << " [INFO] Log file truncated due to size limit\n";
-        log_file.flush();
-      }
-    }
-  }
-
-  /**
-   * Common logging implementation
-   */
-  static void log_message(const char *level, const char *format, va_list args)
+public:
+  enum Level
   {
-    std::mutex &log_mutex = get_log_mutex();
-    std::ofstream &log_file = get_log_file();
-    const std::lock_guard<std::mutex> lock(log_mutex);
-
-    char buffer[LOG_BUFFER_SIZE];
-    vsnprintf(buffer, sizeof(buffer), format, args);
-
-    log_file << get_current_timestamp() << " [" << level << "] " << buffer << std::endl;
-
-    check_and_truncate_log_file();
-  }
+    Debug = 0,
+    Info = 1,
+    Warn = 2,
+    Error = 3,
+    Fatal = 4,
+    Off = 5
+  };
+
+  // Maximum log file size before rotation (10MB)
+  static constexpr size_t MAX_LOG_SIZE = 10 * 1024 * 1024;
+  // Number of log files kept, including the active one
+  static constexpr int MAX_LOG_FILES = 5;
+  // Largest formatted message, and largest captured argument record
+  static constexpr size_t LOG_BUFFER_SIZE = 4096;
 
-public:
   /**
    * Initialize the logger with specified options
    * @param exec_dir Executable directory (must be provided)
    * @param verbose Whether to enable verbose logging
    * @param truncate Whether to truncate existing log file
+   * @param max_file_size Size at which the log file is rotated
+   * @param max_files Number of log files kept, including the active one; 1 truncates instead of rotating
    */
-  static void init_logger(const char *exec_dir, bool verbose = false, bool truncate = false)
-  {
-    std::mutex &log_mutex = get_log_mutex();
-    std::ofstream &log_file = get_log_file();
-    bool &verbose_logging = get_verbose_logging();
-    bool &initialized = get_initialized();
-    std::string &log_file_path = get_log_file_path();
-
-    {
-      const std::lock_guard<std::mutex> lock(log_mutex);
-
-      verbose_logging = verbose;
-
-      // Create logs directory
-      const std::string logs_dir = std::string(exec_dir) + "/logs";
-
-      if (mkdir(logs_dir.c_str(), 0700) != 0 && errno != EEXIST)
-      {
-        std::cerr << "Failed to create logs directory: " << logs_dir << std::endl;
-        return;
-      }
-
-      // Set log file path
-      log_file_path = logs_dir + "/zowex_server.log";
-
-      // Open log file
-      auto mode = std::ios::out;
-      if (truncate)
-      {
-        mode |= std::ios::trunc;
-      }
-      else
-      {
-        mode |= std::ios::app;
-      }
-
-      if (log_file.is_open())
-      {
-        log_file.close();
-      }
-
-      // Create/open file with restricted permissions (0600)
-      int fd = open(log_file_path.c_str(), O_WRONLY | O_CREAT | (truncate ? O_TRUNC : O_APPEND), 0600);
-      if (fd == -1)
-      {
-        std::cerr << "Failed to create log file: " << log_file_path << std::endl;
-        return;
-      }
-      close(fd);
-
-      // Now open with fstream
-      log_file.open(log_file_path.c_str(), mode);
-      if (!log_file.is_open())
-      {
-        std::cerr << "Failed to initialize logger: could not open " << log_file_path << std::endl;
-        return;
-      }
-
-      initialized = true;
-    }
-    if (verbose)
-    {
-      log_debug("Verbose logging enabled");
-    }
-  }
+  static void init_logger(const char *exec_dir, bool verbose = false, bool truncate = false,
+                          size_t max_file_size = MAX_LOG_SIZE, int max_files = MAX_LOG_FILES);
 
   /**
    * Check if verbose logging is enabled
    */
   static bool is_verbose_logging()
   {
-    return get_verbose_logging();
+    return get_verbose_logging().load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Check if messages at `level` are written; a single relaxed load, so the LOG_* macros
+   * can skip evaluating their arguments
+   */
+  static bool is_enabled(Level level)
+  {
+    return level >= get_level().load(std::memory_order_relaxed);
   }
 
   /**
@@ -216,13 +89,13 @@ public:
    */
   static void log_debug(const char *format, ...)
   {
-    if (!get_initialized() || !is_verbose_logging())
+    if (!is_enabled(Debug))
     {
       return;
     }
     va_list args;
     va_start(args, format);
-    log_message("DEBUG", format, args);
+    log_message(Debug, format, args);
     va_end(args);
   }
 
@@ -231,13 +104,13 @@ public:
    */
   static void log_info(const char *format, ...)
   {
-    if (!get_initialized())
+    if (!is_enabled(Info))
     {
       return;
     }
     va_list args;
     va_start(args, format);
-    log_message("INFO", format, args);
+    log_message(Info, format, args);
     va_end(args);
   }
 
@@ -246,13 +119,13 @@ public:
    */
   static void log_warn(const char *format, ...)
   {
-    if (!get_initialized())
+    if (!is_enabled(Warn))
     {
       return;
     }
     va_list args;
     va_start(args, format);
-    log_message("WARN", format, args);
+    log_message(Warn, format, args);
     va_end(args);
   }
 
@@ -261,69 +134,216 @@ public:
    */
   static void log_error(const char *format, ...)
   {
-    if (!get_initialized())
+    if (!is_enabled(Error))
     {
       return;
     }
     va_list args;
     va_start(args, format);
-    log_message("ERROR", format, args);
+    log_message(Error, format, args);
     va_end(args);
   }
 
   /**
-   * Log a fatal error and exit the program
+   * Log a message without formatting it on the calling thread. The arguments are copied
+   * into a binary record (C strings by value) and formatted by the writer thread.
+   * @param level Level of the message
+   * @param format printf-style format; must be a string literal, since only the pointer is kept
+   * @param args Arithmetic values, pointers and C strings matching `format`
    */
-  static void log_fatal(const char *format, ...)
+  template <typename... Args>
+  static void log_deferred(Level level, const char *format, Args... args)
   {
-    char buffer[LOG_BUFFER_SIZE];
-    va_list args;
-    va_start(args, format);
-
-    va_list args_copy;
-    va_copy(args_copy, args);
-
-    vsnprintf(buffer, sizeof(buffer), format, args);
+    if (!is_enabled(level))
+    {
+      return;
+    }
 
-    if (get_initialized())
+    char payload[LOG_BUFFER_SIZE];
+    size_t size = 0;
+    bool fits = true;
+    (void)std::initializer_list<int>{(fits = fits && DeferredArg<Args>::pack(payload, size, sizeof(payload), args), 0)...};
+    if (!fits)
     {
-      log_message("FATAL", format, args_copy);
+      // Too large to capture; format now instead
+      char message[LOG_BUFFER_SIZE];
+      const int length = snprintf(message, sizeof(message), format, args...);
+      enqueue_record(level, nullptr, nullptr, message, length > 0 ? std::min(static_cast<size_t>(length), sizeof(message) - 1) : 0);
+      return;
     }
+    enqueue_record(level, format, &format_deferred<Args...>, payload, size);
+  }
 
-    va_end(args_copy);
-    va_end(args);
+  /**
+   * Log a fatal error, write out everything still buffered and exit the program
+   */
+  static void log_fatal(const char *format, ...);
+
+  /**
+   * Write out everything still buffered, stop the writer thread and close the log file
+   */
+  static void shutdown();
 
-    // Also print to stderr
-    std::cerr << "FATAL: " << buffer << std::endl;
+  /**
+   * Formats a captured record on the writer thread
+   * @return Length of the formatted message, as returned by snprintf
+   */
+  typedef int (*Formatter)(const char *format, const char *payload, char *out, size_t size);
+
+private:
+  static std::atomic<int> &get_level()
+  {
+    static std::atomic<int> level(Off);
+    return level;
+  }
 
-    exit(1);
+  static std::atomic<bool> &get_verbose_logging()
+  {
+    static std::atomic<bool> verbose_logging(false);
+    return verbose_logging;
   }
 
   /**
-   * Cleanup and close the log file
+   * Format one message on the calling thread and queue it
+   */
+  static void log_message(Level level, const char *format, va_list args);
+
+  /**
+   * Queue one record on the calling thread's buffer. Without a formatter, `payload` is the
+   * formatted message.
+   */
+  static void enqueue_record(Level level, const char *format, Formatter formatter, const char *payload, size_t size);
+
+  /**
+   * Copies one argument into a record and reads it back on the writer thread.
+   * Arithmetic values and pointers are copied as they are.
+   */
+  template <typename T, typename Enable = void>
+  struct DeferredArg
+  {
+    static_assert(std::is_arithmetic<T>::value || std::is_pointer<T>::value || std::is_enum<T>::value,
+                  "Deferred log arguments must be arithmetic values, pointers or C strings");
+    typedef T value_type;
+
+    static bool pack(char *payload, size_t &offset, size_t capacity, T value)
+    {
+      if (capacity - offset < sizeof(T))
+      {
+        return false;
+      }
+      memcpy(payload + offset, &value, sizeof(T));
+      offset += sizeof(T);
+      return true;
+    }
+
+    static T unpack(const char *payload, size_t &offset)
+    {
+      T value;
+      memcpy(&value, payload + offset, sizeof(T));
+      offset += sizeof(T);
+      return value;
+    }
+  };
+
+  /**
+   * C strings are copied with their terminator, since the caller's buffer may be gone by
+   * the time the record is formatted
    */
-  static void shutdown()
+  template <typename T>
+  struct DeferredArg<T, typename std::enable_if<std::is_pointer<T>::value && std::is_same<typename std::remove_cv<typename std::remove_pointer<T>::type>::type, char>::value>::type>
   {
-    std::mutex &log_mutex = get_log_mutex();
-    std::ofstream &log_file = get_log_file();
-    bool &initialized = get_initialized();
+    typedef const char *value_type;
+
+    static bool pack(char *payload, size_t &offset, size_t capacity, const char *value)
+    {
+      if (value == nullptr)
+      {
+        value = "(null)";
+      }
+      const size_t length = strlen(value) + 1;
+      if (capacity - offset < length)
+      {
+        return false;
+      }
+      memcpy(payload + offset, value, length);
+      offset += length;
+      return true;
+    }
 
-    const std::lock_guard<std::mutex> lock(log_mutex);
-    if (log_file.is_open())
+    static const char *unpack(const char *payload, size_t &offset)
     {
-      log_file.close();
+      const char *value = payload + offset;
+      offset += strlen(value) + 1;
+      return value;
     }
-    initialized = false;
+  };
+
+  template <typename... Args>
+  static int format_deferred(const char *format, const char *payload, char *out, size_t size)
+  {
+    size_t offset = 0;
+    // Braced initialization unpacks the arguments left to right
+    const std::tuple<typename DeferredArg<Args>::value_type...> values{DeferredArg<Args>::unpack(payload, offset)...};
+    (void)payload; // Unused when there are no arguments
+    (void)offset;
+    return format_tuple(format, out, size, values, std::index_sequence_for<Args...>());
+  }
+
+  template <typename Tuple, size_t... I>
+  static int format_tuple(const char *format, char *out, size_t size, const Tuple &values, std::index_sequence<I...>)
+  {
+    return snprintf(out, size, format, std::get<I>(values)...);
   }
 };
 
 } // namespace server
 
-// Convenience macros for easier usage
-#define LOG_DEBUG(...) server::Logger::log_debug(__VA_ARGS__)
-#define LOG_INFO(...) server::Logger::log_info(__VA_ARGS__)
-#define LOG_WARN(...) server::Logger::log_warn(__VA_ARGS__)
-#define LOG_ERROR(...) server::Logger::log_error(__VA_ARGS__)
+/**
+ * Logging macros. The level is checked before the arguments are evaluated, and levels
+ * below LOG_MIN_LEVEL (0 = DEBUG, 1 = INFO, 2 = WARN, 3 = ERROR) are compiled out.
+ * With LOG_DEFERRED_FORMAT defined, arguments are captured as they are and formatted by
+ * the writer thread (see Logger::log_deferred).
+ */
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL 0
+#endif
+
+#ifdef LOG_DEFERRED_FORMAT
+#define LOG_AT_LEVEL(level, ...) server::Logger::log_deferred(server::Logger::level, __VA_ARGS__)
+#else
+#define LOG_AT_LEVEL(level, ...) LOG_CALL_##level(__VA_ARGS__)
+#endif
+#define LOG_CALL_Debug(...) server::Logger::log_debug(__VA_ARGS__)
+#define LOG_CALL_Info(...) server::Logger::log_info(__VA_ARGS__)
+#define LOG_CALL_Warn(...) server::Logger::log_warn(__VA_ARGS__)
+#define LOG_CALL_Error(...) server::Logger::log_error(__VA_ARGS__)
+#define LOG_IF_ENABLED(level, ...)                             \
+  do                                                           \
+  {                                                            \
+    if (server::Logger::is_enabled(server::Logger::level))     \
+      LOG_AT_LEVEL(level, __VA_ARGS__);                        \
+  } while (0)
+
+#if LOG_MIN_LEVEL <= 0
+#define LOG_DEBUG(...) LOG_IF_ENABLED(Debug, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void)0)
+#endif
+#if LOG_MIN_LEVEL <= 1
+#define LOG_INFO(...) LOG_IF_ENABLED(Info, __VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void)0)
+#endif
+#if LOG_MIN_LEVEL <= 2
+#define LOG_WARN(...) LOG_IF_ENABLED(Warn, __VA_ARGS__)
+#else
+#define LOG_WARN(...) ((void)0)
+#endif
+#if LOG_MIN_LEVEL <= 3
+#define LOG_ERROR(...) LOG_IF_ENABLED(Error, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) ((void)0)
+#endif
 #define LOG_FATAL(...) server::Logger::log_fatal(__VA_ARGS__)
 
 #endif // LOGGER_HPP
@@ -0,0 +1,166 @@
+/**
+ * This program and the accompanying materials are made available under the terms of the
+ * Eclipse Public License v2.0 which accompanies this distribution, and is available at
+ * https://www.eclipse.org/legal/epl-v20.html
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Copyright Contributors to the Zowe Project.
+ *
+ */
+
+#include "request_batch.hpp"
+#include "rpcio.hpp"
+#include "response_writer.hpp"
+#include "logger.hpp"
+
+RequestBatch::RequestBatch(std::vector<Member> batch_members, std::chrono::milliseconds batch_timeout)
+    : members(std::move(batch_members)),
+      deadline(std::chrono::steady_clock::now() + batch_timeout),
+      timeout(batch_timeout),
+      responses(members.size()),
+      answered(members.size(), false),
+      remaining(members.size())
+{
+  for (size_t i = 0; i < members.size(); ++i)
+  {
+    if (members[i].invalid.empty())
+      continue;
+    responses[i].assign(1, error_response(members[i], RpcErrorCode::INVALID_REQUEST, members[i].invalid));
+    answered[i] = true;
+    --remaining;
+  }
+}
+
+bool RequestBatch::complete(size_t index, std::vector<std::string> segments)
+{
+  std::vector<std::vector<std::string>> batch_responses;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (finished || index >= answered.size() || answered[index])
+      return false;
+
+    responses[index] = std::move(segments);
+    answered[index] = true;
+    if (--remaining > 0)
+      return true;
+
+    finished = true;
+    batch_responses.swap(responses);
+  }
+
+  write(batch_responses);
+  return true;
+}
+
+bool RequestBatch::expire(std::chrono::steady_clock::time_point now)
+{
+  std::vector<std::vector<std::string>> batch_responses;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (finished)
+      return true;
+    if (now < deadline)
+      return false;
+
+    LOG_WARN("Batch of %zu requests timed out after %lld ms with %zu requests unanswered", members.size(), static_cast<long long>(timeout.count()), remaining);
+    for (size_t i = 0; i < members.size(); ++i)
+    {
+      if (!answered[i])
+      {
+        responses[i].assign(1, error_response(members[i], RpcErrorCode::REQUEST_TIMEOUT,
+                                              "Batch timed out after " + std::to_string(timeout.count()) + " ms (method: " + members[i].method + ")"));
+        answered[i] = true;
+      }
+    }
+    remaining = 0;
+    finished = true;
+    batch_responses.swap(responses);
+  }
+
+  write(batch_responses);
+  return true;
+}
+
+bool RequestBatch::write_if_answered()
+{
+  std::vector<std::vector<std::string>> batch_responses;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (finished)
+      return true;
+    if (remaining > 0)
+      return false;
+
+    finished = true;
+    batch_responses.swap(responses);
+  }
+
+  write(batch_responses);
+  return true;
+}
+
+bool RequestBatch::is_finished()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return finished;
+}
+
+void RequestBatch::write(std::vector<std::vector<std::string>> &batch_responses)
+{
+  size_t count = 2;
+  for (const auto &response : batch_responses)
+    count += response.size() + 1;
+
+  std::vector<std::string> segments;
+  segments.reserve(count);
+  segments.emplace_back("[");
+  for (size_t i = 0; i < batch_responses.size(); ++i)
+  {
+    if (i > 0)
+      segments.emplace_back(",");
+    for (auto &segment : batch_responses[i])
+      segments.push_back(std::move(segment));
+  }
+  segments.emplace_back("]");
+
+  LOG_DEBUG("Writing responses of batch with %zu requests", batch_responses.size());
+  ResponseWriter::get_instance().write_line(ResponseWriter::Output, std::move(segments));
+}
+
+std::string RequestBatch::error_response(const Member &member, int code, const std::string &message) const
+{
+  const ErrorDetails error{code, message, std::optional<zjson::Value>()};
+  return "{\"jsonrpc\":\"2.0\",\"error\":" + zjson::to_string(zjson::to_value(error).value()).value_or(std::string("null")) +
+         ",\"id\":" + member.id + "}";
+}
+
+RequestBatch::Scope *&RequestBatch::current()
+{
+  static thread_local Scope *scope = nullptr;
+  return scope;
+}
+
+RequestBatch::Scope::Scope(std::shared_ptr<RequestBatch> member_batch, size_t member_index)
+    : batch(std::move(member_batch)), index(member_index), previous(current())
+{
+  if (batch)
+    current() = this;
+}
+
+RequestBatch::Scope::~Scope()
+{
+  if (batch)
+    current() = previous;
+}
+
+bool RequestBatch::complete_current(std::vector<std::string> &segments)
+{
+  Scope *scope = current();
+  if (scope == nullptr)
+    return false;
+
+  if (!scope->batch->complete(scope->index, std::move(segments)))
+    LOG_DEBUG("Dropped late response for request %zu of a batch that was already answered", scope->index);
+  return true;
+}
@@ -0,0 +1,135 @@
+/**
+ * This program and the accompanying materials are made available under the terms of the
+ * Eclipse Public License v2.0 which accompanies this distribution, and is available at
+ * https://www.eclipse.org/legal/epl-v20.html
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Copyright Contributors to the Zowe Project.
+ *
+ */
+
+#ifndef REQUEST_BATCH_HPP
+#define REQUEST_BATCH_HPP
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Responses of one JSON-RPC batch request.
+ *
+ * Each member of the batch is queued as its own request and may run on any
+ * worker. While a worker runs a member, a Scope routes the member's response
+ * into its slot instead of the output channel. Once every member has answered,
+ * or the batch deadline has passed, the responses are written as one array in
+ * the order of the batch.
+ */
+class RequestBatch
+{
+public:
+  // Identity of a member request, used to answer it if it has not completed by the deadline
+  struct Member
+  {
+    // JSON text of the request id, written unchanged into the responses the batch makes itself
+    std::string id = "null";
+    std::string method;
+    // Set for a member that is answered with an invalid request error instead of running
+    std::string invalid;
+  };
+
+  /**
+   * @param members One entry per request in the batch, in order; members with `invalid` set are answered right away
+   * @param timeout Time allowed for the whole batch, from now
+   */
+  RequestBatch(std::vector<Member> members, std::chrono::milliseconds timeout);
+
+  RequestBatch(const RequestBatch &) = delete;
+  RequestBatch &operator=(const RequestBatch &) = delete;
+
+  size_t size() const
+  {
+    return members.size();
+  }
+
+  /**
+   * Record the response of a member. The batch is written once this was the last one missing.
+   * @param index Position of the member in the batch
+   * @param segments The response line, in pieces
+   * @return false if the member already has a response or the batch was already written
+   */
+  bool complete(size_t index, std::vector<std::string> segments);
+
+  /**
+   * Answer every member still missing a response with a timeout error and write the batch,
+   * if its deadline has passed
+   * @return true if the batch has been written, now or before
+   */
+  bool expire(std::chrono::steady_clock::time_point now);
+
+  /**
+   * Write the batch if every member was answered when it was created, as when none is a valid request
+   * @return true if the batch has been written, now or before
+   */
+  bool write_if_answered();
+
+  /**
+   * Whether the batch has been written
+   */
+  bool is_finished();
+
+  /**
+   * Routes the responses queued on this thread to a member of a batch while it is in scope.
+   * A scope without a batch changes nothing, so requests outside batches can use one too.
+   */
+  class Scope
+  {
+  public:
+    Scope(std::shared_ptr<RequestBatch> batch, size_t index);
+    ~Scope();
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+  private:
+    friend class RequestBatch;
+    std::shared_ptr<RequestBatch> batch;
+    size_t index;
+    Scope *previous;
+  };
+
+  /**
+   * Record a response for the batch member in scope on this thread
+   * @return false if no batch member is in scope, in which case the response should be written as usual
+   */
+  static bool complete_current(std::vector<std::string> &segments);
+
+  /**
+   * Whether a batch member is in scope on this thread
+   */
+  static bool in_scope()
+  {
+    return current() != nullptr;
+  }
+
+private:
+  std::vector<Member> members;
+  std::chrono::steady_clock::time_point deadline;
+  std::chrono::milliseconds timeout;
+
+  std::mutex mutex;
+  std::vector<std::vector<std::string>> responses;
+  std::vector<bool> answered;
+  size_t remaining;
+  bool finished = false;
+
+  static Scope *&current();
+
+  // Write all responses as one array; called once, with the mutex released
+  void write(std::vector<std::vector<std::string>> &batch_responses);
+  std::string error_response(const Member &member, int code, const std::string &message) const;
+};
+
+#endif
@@ -0,0 +1,221 @@
+/**
+ * This program and the accompanying materials are made available under the terms of the
+ * Eclipse Public License v2.0 which accompanies this distribution, and is available at
+ * https://www.eclipse.org/legal/epl-v20.html
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Copyright Contributors to the Zowe Project.
+ *
+ */
+
+#include "response_writer.hpp"
+#include "logger.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+ResponseWriter::~ResponseWriter()
+{
+  stop();
+}
+
+void ResponseWriter::start(int out_fd, int err_fd)
+{
+  std::lock_guard<std::mutex> lock(queue_mutex);
+  if (running)
+    return;
+
+  fds[Output] = out_fd;
+  fds[Error] = err_fd;
+  stopping = false;
+  running = true;
+  writer_thread = std::thread(&ResponseWriter::writer_loop, this);
+}
+
+void ResponseWriter::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    if (!running)
+      return;
+    stopping = true;
+  }
+  queue_condition.notify_one();
+
+  if (writer_thread.joinable())
+    writer_thread.join();
+
+  std::lock_guard<std::mutex> lock(queue_mutex);
+  running = false;
+  fds[Output] = STDOUT_FILENO;
+  fds[Error] = STDERR_FILENO;
+}
+
+void ResponseWriter::write_line(Channel channel, std::string line)
+{
+  enqueue(Entry{channel, std::move(line), std::vector<std::string>()});
+}
+
+void ResponseWriter::write_line(Channel channel, std::vector<std::string> segments)
+{
+  enqueue(Entry{channel, std::string(), std::move(segments)});
+}
+
+void ResponseWriter::write_raw(Channel channel, std::vector<std::string> segments)
+{
+  enqueue(Entry{channel, std::string(), std::move(segments), false});
+}
+
+void ResponseWriter::enqueue(Entry entry)
+{
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    if (running && !stopping)
+    {
+      pending.push_back(std::move(entry));
+      if (pending.size() > 1)
+        return; // The output thread is already awake or about to be
+    }
+    else
+    {
+      std::vector<Entry> batch;
+      batch.push_back(std::move(entry));
+      write_batch(batch);
+      return;
+    }
+  }
+  queue_condition.notify_one();
+}
+
+void ResponseWriter::writer_loop()
+{
+  std::vector<Entry> batch;
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(queue_mutex);
+      queue_condition.wait(lock, [this]
+                           { return stopping || !pending.empty(); });
+      if (pending.empty())
+        break;
+      batch.swap(pending);
+    }
+
+    write_batch(batch);
+    batch.clear();
+  }
+}
+
+void ResponseWriter::write_batch(std::vector<Entry> &batch)
+{
+  std::lock_guard<std::mutex> lock(write_mutex);
+
+  std::string buffer;
+  int buffer_fd = -1;
+  const auto flush = [&]()
+  {
+    if (!buffer.empty())
+      write_all(buffer_fd, buffer.data(), buffer.size());
+    buffer.clear();
+  };
+
+  for (auto &entry : batch)
+  {
+    const int fd = fds[entry.channel];
+    if (fd != buffer_fd)
+    {
+      flush();
+      buffer_fd = fd;
+    }
+
+    size_t line_size = entry.data.size();
+    for (const auto &segment : entry.segments)
+      line_size += segment.size();
+
+    if (line_size >= kCoalesceLimit)
+    {
+      // Large responses are written straight from their own buffers, together with
+      // the lines buffered before them
+      static char newline = '\n';
+      std::vector<struct iovec> buffers;
+      buffers.reserve(entry.segments.size() + 3);
+      const auto add = [&buffers](const char *data, size_t length)
+      {
+        if (length > 0)
+          buffers.push_back(iovec{const_cast<char *>(data), length});
+      };
+      add(buffer.data(), buffer.size());
+      add(entry.data.data(), entry.data.size());
+      for (const auto &segment : entry.segments)
+        add(segment.data(), segment.size());
+      if (entry.newline)
+        add(&newline, 1);
+
+      write_all(fd, buffers);
+      buffer.clear();
+    }
+    else
+    {
+      buffer.append(entry.data);
+      for (const auto &segment : entry.segments)
+        buffer.append(segment);
+      if (entry.newline)
+        buffer.push_back('\n');
+      if (buffer.size() >= kCoalesceLimit)
+        flush();
+    }
+  }
+
+  flush();
+}
+
+void ResponseWriter::write_all(int fd, const char *data, size_t length)
+{
+  while (length > 0)
+  {
+    const ssize_t written = write(fd, data, length);
+    if (written < 0)
+    {
+      if (errno == EINTR)
+        continue;
+
+      LOG_ERROR("Failed to write %zu bytes of output to fd %d: %s", length, fd, strerror(errno));
+      return;
+    }
+
+    data += written;
+    length -= static_cast<size_t>(written);
+  }
+}
+
+void ResponseWriter::write_all(int fd, std::vector<struct iovec> &buffers)
+{
+  size_t index = 0;
+  while (index < buffers.size())
+  {
+    const auto count = static_cast<int>(std::min(buffers.size() - index, kMaxIovecs));
+    const ssize_t written = writev(fd, &buffers[index], count);
+    if (written <= 0)
+    {
+      if (written < 0 && errno == EINTR)
+        continue;
+
+      LOG_ERROR("Failed to write %zu buffers of output to fd %d: %s", buffers.size() - index, fd, written < 0 ? strerror(errno) : "no progress");
+      return;
+    }
+
+    // Skip the buffers written in full, then advance into a partially written one
+    auto remaining = static_cast<size_t>(written);
+    while (index < buffers.size() && remaining >= buffers[index].iov_len)
+    {
+      remaining -= buffers[index].iov_len;
+      ++index;
+    }
+    if (remaining > 0)
+    {
+      buffers[index].iov_base = static_cast<char *>(buffers[index].iov_base) + remaining;
+      buffers[index].iov_len -= remaining;
+    }
+  }
+}
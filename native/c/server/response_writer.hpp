@@ -0,0 +1,115 @@
+/**
+ * This program and the accompanying materials are made available under the terms of the
+ * Eclipse Public License v2.0 which accompanies this distribution, and is available at
+ * https://www.eclipse.org/legal/epl-v20.html
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Copyright Contributors to the Zowe Project.
+ *
+ */
+
+#ifndef RESPONSE_WRITER_HPP
+#define RESPONSE_WRITER_HPP
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "../singleton.hpp"
+
+/**
+ * Single ordered output channel for JSON-RPC responses and notifications.
+ *
+ * Workers hand over complete lines and return immediately. A dedicated thread
+ * writes them in the order they were queued, coalescing everything queued so
+ * far into as few write(2) calls as possible, so a slow SSH channel only
+ * delays the output thread. Until start() is called (and after stop()), lines
+ * are written synchronously by the caller.
+ */
+class ResponseWriter : public Singleton<ResponseWriter>
+{
+  friend class Singleton<ResponseWriter>;
+
+public:
+  enum Channel
+  {
+    Output, // Responses and notifications (stdout)
+    Error   // Error responses (stderr)
+  };
+
+  /**
+   * Start the output thread
+   * @param out_fd Descriptor for the Output channel
+   * @param err_fd Descriptor for the Error channel
+   */
+  void start(int out_fd = STDOUT_FILENO, int err_fd = STDERR_FILENO);
+
+  /**
+   * Write everything still queued, then stop the output thread. Later lines
+   * are written synchronously to stdout and stderr.
+   */
+  void stop();
+
+  /**
+   * Queue one line of output; a newline is added when it is written
+   * @param channel The channel to write the line to
+   * @param line The line to write, without a trailing newline
+   */
+  void write_line(Channel channel, std::string line);
+
+  /**
+   * Queue one line of output made of several buffers. Long lines are written
+   * straight from the buffers with writev(2), without joining them first.
+   * @param channel The channel to write the line to
+   * @param segments The pieces of the line, in order, without a trailing newline
+   */
+  void write_line(Channel channel, std::vector<std::string> segments);
+
+  /**
+   * Queue bytes that are written as they are, without a newline, such as a
+   * binary frame, in order with the lines queued around them
+   * @param channel The channel to write the bytes to
+   * @param segments The bytes, in pieces
+   */
+  void write_raw(Channel channel, std::vector<std::string> segments);
+
+private:
+  struct Entry
+  {
+    Channel channel;
+    std::string data;
+    std::vector<std::string> segments; // Written after data, for lines queued in pieces
+    bool newline = true;
+  };
+
+  // Lines are copied into one buffer until it reaches this size; longer lines are written from their own buffers
+  static constexpr size_t kCoalesceLimit = 64 * 1024;
+  // Buffers passed to a single writev(2) call
+  static constexpr size_t kMaxIovecs = 16;
+
+  std::mutex queue_mutex;
+  std::condition_variable queue_condition;
+  std::vector<Entry> pending;
+  bool running = false;
+  bool stopping = false;
+  std::thread writer_thread;
+
+  // Held while writing so that synchronous writes never interleave with the output thread
+  std::mutex write_mutex;
+  int fds[2] = {STDOUT_FILENO, STDERR_FILENO};
+
+  ResponseWriter() = default;
+  ~ResponseWriter();
+
+  void writer_loop();
+  void enqueue(Entry entry);
+  void write_batch(std::vector<Entry> &batch);
+  void write_all(int fd, const char *data, size_t length);
+  void write_all(int fd, std::vector<struct iovec> &buffers);
+};
+
+#endif
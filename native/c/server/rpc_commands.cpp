@@ -11,6 +11,8 @@
 
 #include "rpc_commands.hpp"
 #include "dispatcher.hpp"
+#include "frame.hpp"
+#include "stats.hpp"
 #include "schemas/requests.hpp"
 #include "schemas/responses.hpp"
 #include "../commands/core.hpp"
@@ -72,17 +74,20 @@ void register_ds_commands(CommandDispatcher &dispatcher)
                                   .set_default("encoding", "IBM-1047")
                                   .set_default("return-etag", true)
                                   .read_stdout("data", true)
-                                  .handle_fifo("stream", "pipe-path", FifoMode::GET));
+                                  .handle_fifo("stream", "pipe-path", FifoMode::GET),
+                              SchedulingClass::Bulk);
   dispatcher.register_command("restoreDataset",
                               create_ds_builder(ds::handle_data_set_restore)
-                                  .validate<RestoreDatasetRequest, RestoreDatasetResponse>());
+                                  .validate<RestoreDatasetRequest, RestoreDatasetResponse>(),
+                              SchedulingClass::Bulk);
   dispatcher.register_command("writeDataset",
                               create_ds_builder(ds::handle_data_set_write)
                                   .validate<WriteDatasetRequest, WriteDatasetResponse>()
                                   .rename_arg("volume", "volser")
                                   .set_default("encoding", "IBM-1047")
                                   .write_stdin("data", true)
-                                  .handle_fifo("stream", "pipe-path", FifoMode::PUT));
+                                  .handle_fifo("stream", "pipe-path", FifoMode::PUT),
+                              SchedulingClass::Bulk);
   dispatcher.register_command("renameDataset", create_ds_builder(ds::handle_data_set_rename).validate<RenameDatasetRequest, RenameDatasetResponse>());
   dispatcher.register_command("renameMember", create_ds_builder(ds::handle_rename_member).validate<RenameMemberRequest, RenameMemberResponse>());
 }
@@ -113,12 +118,20 @@ void register_job_commands(CommandDispatcher &dispatcher)
   dispatcher.register_command("listSpools",
                               create_job_builder(job::handle_job_list_files)
                                   .validate<ListSpoolsRequest, ListSpoolsResponse>());
+  dispatcher.register_command("readAllSpools",
+                              create_job_builder(job::handle_job_view_all_files)
+                                  .validate<ReadAllSpoolsRequest, ReadAllSpoolsResponse>()
+                                  .set_default("encoding", "IBM-1047")
+                                  .set_default("max-bytes", 8LL * 1024 * 1024)
+                                  .set_default("warn", false),
+                              SchedulingClass::Bulk);
   dispatcher.register_command("readSpool",
                               create_job_builder(job::handle_job_view_file_by_id)
                                   .validate<ReadSpoolRequest, ReadSpoolResponse>()
                                   .rename_arg("spoolId", "key")
                                   .set_default("encoding", "IBM-1047")
-                                  .read_stdout("data", true));
+                                  .read_stdout("data", true),
+                              SchedulingClass::Bulk);
   dispatcher.register_command("releaseJob",
                               create_job_builder(job::handle_job_release)
                                   .validate<ReleaseJobRequest, ReleaseJobResponse>());
@@ -146,7 +159,7 @@ void register_uss_commands(CommandDispatcher &dispatcher)
   dispatcher.register_command("chtagFile",
                               create_uss_builder(uss::handle_uss_chtag)
                                   .validate<ChtagFileRequest, ChtagFileResponse>());
-  dispatcher.register_command("copyUss", copy_uss_builder(uss::handle_uss_copy).validate<CopyUssRequest, CopyUssResponse>());
+  dispatcher.register_command("copyUss", copy_uss_builder(uss::handle_uss_copy).validate<CopyUssRequest, CopyUssResponse>(), SchedulingClass::Bulk);
   const auto handle_uss_create = [](plugin::InvocationContext &context) -> int
   {
     auto handler = context.get<bool>("is-dir", false) ?
@@ -166,21 +179,22 @@ void register_uss_commands(CommandDispatcher &dispatcher)
                                   .set_default("force", true));
   dispatcher.register_command("listFiles",
                               create_uss_builder(uss::handle_uss_list)
-                                  .validate<ListFilesRequest, ListFilesResponse>()
-                                  .set_default("response-format-csv", true));
+                                  .validate<ListFilesRequest, ListFilesResponse>());
   dispatcher.register_command("readFile",
                               create_uss_builder(uss::handle_uss_view)
                                   .validate<ReadFileRequest, ReadFileResponse>()
                                   .set_default("encoding", "IBM-1047")
                                   .set_default("return-etag", true)
                                   .read_stdout("data", true)
-                                  .handle_fifo("stream", "pipe-path", FifoMode::GET, true));
+                                  .handle_fifo("stream", "pipe-path", FifoMode::GET, true),
+                              SchedulingClass::Bulk);
   dispatcher.register_command("writeFile",
                               create_uss_builder(uss::handle_uss_write)
                                   .validate<WriteFileRequest, WriteFileResponse>()
                                   .set_default("encoding", "IBM-1047")
                                   .write_stdin("data", true)
-                                  .handle_fifo("stream", "pipe-path", FifoMode::PUT));
+                                  .handle_fifo("stream", "pipe-path", FifoMode::PUT),
+                              SchedulingClass::Bulk);
   dispatcher.register_command("unixCommand",
                               CommandBuilder(uss::handle_uss_issue_cmd)
                                   .validate<IssueUssCmdRequest, IssueUssCmdResponse>()
@@ -202,7 +216,8 @@ void register_tool_commands(CommandDispatcher &dispatcher)
   dispatcher.register_command("toolSearch",
                               create_ds_builder(tool::handle_tool_search)
                                   .validate<ToolSearchRequest, ToolSearchResponse>()
-                                  .read_stdout("data", false));
+                                  .read_stdout("data", false),
+                              SchedulingClass::Bulk);
 }
 
 void register_core_commands(CommandDispatcher &dispatcher)
@@ -210,6 +225,12 @@ void register_core_commands(CommandDispatcher &dispatcher)
   dispatcher.register_command("getInfo",
                               CommandBuilder(core::handle_version)
                                   .validate<GetInfoRequest, GetInfoResponse>());
+  dispatcher.register_command("getStats",
+                              CommandBuilder(handle_get_stats)
+                                  .validate<GetStatsRequest, GetStatsResponse>());
+  dispatcher.register_command("setFraming",
+                              CommandBuilder(handle_set_framing)
+                                  .validate<SetFramingRequest, SetFramingResponse>());
 }
 
 void register_all_commands(CommandDispatcher &dispatcher)
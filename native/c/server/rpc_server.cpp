@@ -11,9 +11,16 @@
 
 #include "rpc_server.hpp"
 #include "rpcio.hpp"
+#include "ast_writer.hpp"
+#include "response_writer.hpp"
+#include "request_batch.hpp"
 #include "dispatcher.hpp"
+#include "frame.hpp"
 #include "logger.hpp"
+#include <algorithm>
 #include <iostream>
+#include <limits>
+#include <optional>
 
 using std::string;
 
@@ -39,8 +46,42 @@ void RpcServer::process_request(const string &request_data)
 {
   try
   {
-    // Parse the JSON request
-    auto parse_result = zjson::from_str<RpcRequest>(request_data);
+    // Parse the JSON request, validating params and decoding them straight
+    // into the argument map. Clients send the method before params, so the
+    // schema is usually known by the time params are read; otherwise params
+    // are decoded from their raw text once the whole request is parsed.
+    plugin::ArgumentMap args;
+    std::string_view raw_params;
+    bool params_is_object = false;
+    bool params_decoded = false;
+    validator::ValidationResult params_result = validator::ValidationResult::success();
+    auto parse_result = zjson::from_str<RpcRequest>(request_data, [&](const string &key, zjson::Reader &reader, RpcRequest &partial)
+                                                    {
+                                                      if (key != "params")
+                                                      {
+                                                        return false;
+                                                      }
+
+                                                      const zjson::Value::Type type = reader.peek();
+                                                      if (type == zjson::Value::Null)
+                                                      {
+                                                        reader.skip_value();
+                                                        return true;
+                                                      }
+
+                                                      params_is_object = type == zjson::Value::Object;
+                                                      if (params_is_object && !partial.method.empty() && CommandDispatcher::get_instance().has_command(partial.method))
+                                                      {
+                                                        const char *start = reader.position();
+                                                        params_result = decode_params(reader, find_request_schema(partial.method), args);
+                                                        raw_params = std::string_view(start, reader.position() - start);
+                                                        params_decoded = true;
+                                                      }
+                                                      else
+                                                      {
+                                                        raw_params = reader.skip_value();
+                                                      }
+                                                      return true; });
 
     if (!parse_result.has_value())
     {
@@ -49,7 +90,24 @@ void RpcServer::process_request(const string &request_data)
       return;
     }
 
-    RpcRequest request = parse_result.value();
+    RpcRequest request = std::move(parse_result.value());
+
+    // A payload sent in frames ahead of the request is released with it, even if the request fails before using it.
+    // A notification's id is not its own, so frames sent for a request with the same id are left alone.
+    const bool uses_frames = !in_notification();
+    std::optional<FrameChannel::PayloadGuard> payload_guard;
+    if (uses_frames)
+    {
+      payload_guard.emplace(request.id);
+    }
+
+    // A payload that was not kept must not let the request run as if it had been sent without data
+    string rejection;
+    if (uses_frames && FrameChannel::get_instance().take_rejection(request.id, rejection))
+    {
+      print_error(request.id, RpcErrorCode::INVALID_REQUEST, "Binary payload was rejected (" + request.method + ")", &rejection);
+      return;
+    }
 
     // Use CommandDispatcher singleton to handle the command
     CommandDispatcher &dispatcher = CommandDispatcher::get_instance();
@@ -62,26 +120,33 @@ void RpcServer::process_request(const string &request_data)
       return;
     }
 
-    // Validate params if a request validator is registered for this command
-    if (request.params.has_value())
+    if (!raw_params.empty())
     {
-      auto validation_result = validate_json_with_schema(request.method, request.params.value(), true);
-      if (!validation_result.is_valid)
+      const validator::Schema *schema = find_request_schema(request.method);
+      if (!params_is_object)
       {
-        print_error(request.id, RpcErrorCode::INVALID_PARAMS, "Request validation failed (" + request.method + ")", &validation_result.error_message);
-        return;
+        if (schema == nullptr)
+        {
+          throw std::runtime_error("Invalid parameters - must be an object");
+        }
+        params_result = validator::ValidationResult::error("Parameters must be an object");
+      }
+      else if (!params_decoded)
+      {
+        zjson::Reader reader(raw_params);
+        params_result = decode_params(reader, schema, args);
       }
-    }
 
-    // Convert JSON params to ArgumentMap
-    plugin::ArgumentMap args;
-    if (request.params.has_value())
-    {
-      args = convert_json_params_to_argument_map(request.params.value());
+      // Params are checked against the request schema, if one is registered for this command
+      if (!params_result.is_valid)
+      {
+        print_error(request.id, RpcErrorCode::INVALID_PARAMS, "Request validation failed (" + request.method + ")", &params_result.error_message);
+        return;
+      }
     }
 
     // Create MiddlewareContext for the command
-    MiddlewareContext context(request.method, args);
+    MiddlewareContext context(request.method, args, request.id);
 
     // Dispatch the command
     int result = dispatcher.dispatch(request.method, context);
@@ -102,26 +167,37 @@ void RpcServer::process_request(const string &request_data)
       return;
     }
 
-    // Success - check if context has an object set, otherwise use output content
-    zjson::Value result_json;
+    // Success - write the envelope and the result straight into the response text
+    const bool success = context.get_error_content().empty();
+    string json_string = "{\"jsonrpc\":\"2.0\",\"result\":";
 
     const auto &ast_object = context.get_object();
+    validator::ValidationResult validation_result = validator::ValidationResult::success();
     if (ast_object)
     {
-      // Convert AST object to zjson::Value
-      result_json = convert_ast_to_json(ast_object);
+      // Validate result against the response schema, if one is registered for this command, while writing it
+      const validator::Schema *schema = find_response_schema(request.method);
+      std::optional<validator::ObjectValidator> result_validator;
+      if (schema != nullptr)
+      {
+        result_validator.emplace(*schema);
+      }
+
+      AstWriter(json_string).write_result(ast_object, success, result_validator ? &*result_validator : nullptr);
+      if (result_validator)
+      {
+        validation_result = result_validator->finish();
+      }
     }
     else
     {
       // Fallback to output content if no AST object is set
-      string output = context.get_output_content();
-      result_json = convert_output_to_json(output);
+      zjson::Value result_json = convert_output_to_json(context.get_output_content());
+      result_json.add_to_object("success", zjson::Value(success));
+      validation_result = validate_json_with_schema(request.method, result_json, false);
+      zjson::write_json(json_string, result_json);
     }
 
-    result_json.add_to_object("success", zjson::Value(context.get_error_content().empty()));
-
-    // Validate result if a response validator is registered for this command
-    auto validation_result = validate_json_with_schema(request.method, result_json, false);
     if (!validation_result.is_valid)
     {
       // Response validation failed - return internal error
@@ -130,14 +206,10 @@ void RpcServer::process_request(const string &request_data)
       return;
     }
 
-    // Build success response
-    RpcResponse response;
-    response.jsonrpc = "2.0";
-    response.result = std::optional<zjson::Value>(result_json);
-    response.error = std::optional<ErrorDetails>();
-    response.id = std::optional<int>(request.id);
-
-    print_response(response, &context);
+    json_string += ",\"id\":";
+    json_string += std::to_string(request.id);
+    json_string += '}';
+    queue_response(std::move(json_string), false, &context);
   }
   catch (const std::exception &e)
   {
@@ -188,47 +260,95 @@ string RpcServer::camel_case_to_kebab_case(const string &input)
   return result;
 }
 
-plugin::ArgumentMap RpcServer::convert_json_params_to_argument_map(const zjson::Value &params)
+validator::ValidationResult RpcServer::decode_params(zjson::Reader &reader, const validator::Schema *schema, plugin::ArgumentMap &args)
 {
-  plugin::ArgumentMap args;
-
-  if (!params.is_object())
+  std::optional<validator::ObjectValidator> params_validator;
+  if (schema != nullptr)
   {
-    throw std::runtime_error("Invalid parameters - must be an object");
+    // Allow unknown fields in requests for forward compatibility
+    params_validator.emplace(*schema, true);
   }
 
-  // Convert JSON object to ArgumentMap
-  for (const auto &pair : params.as_object())
+  const char *start = reader.position();
+  reader.read_object([&](const string &key)
+                     {
+                       std::string_view raw;
+                       const bool consumed = params_validator && params_validator->check_member(key, reader, raw);
+
+                       // Once the request is known to be invalid, only finish reading it
+                       if (params_validator && params_validator->has_error())
+                       {
+                         if (!consumed)
+                         {
+                           reader.skip_value();
+                         }
+                         return;
+                       }
+
+                       // Convert camelCase keys to kebab-case
+                       plugin::Argument &arg = args[camel_case_to_kebab_case(key)];
+                       if (consumed)
+                       {
+                         arg = plugin::Argument(string(raw));
+                         return;
+                       }
+
+                       switch (reader.peek())
+                       {
+                       case zjson::Value::String:
+                       {
+                         string str;
+                         reader.read_string(str);
+                         arg = plugin::Argument(str);
+                         break;
+                       }
+                       case zjson::Value::Bool:
+                         arg = plugin::Argument(reader.read_value().as_bool());
+                         break;
+                       case zjson::Value::Number:
+                       {
+                         const zjson::Value value = reader.read_value();
+                         arg = value.is_integer() ? plugin::Argument(value.as_int64()) : plugin::Argument(value.as_double());
+                         break;
+                       }
+                       case zjson::Value::Null:
+                         reader.skip_value();
+                         arg = plugin::Argument("");
+                         break;
+                       // For arrays and objects, pass the JSON text through as a string
+                       default:
+                         arg = plugin::Argument(string(reader.skip_value()));
+                         break;
+                       } });
+
+  if (!params_validator)
   {
-    // Convert camelCase keys to kebab-case
-    const string kebab_key = camel_case_to_kebab_case(pair.first);
-    const zjson::Value &value = pair.second;
+    return validator::ValidationResult::success();
+  }
 
-    if (value.is_bool())
-    {
-      args[kebab_key] = plugin::Argument(value.as_bool());
-    }
-    else if (value.is_integer())
-    {
-      args[kebab_key] = plugin::Argument(value.as_int64());
-    }
-    else if (value.is_double())
-    {
-      args[kebab_key] = plugin::Argument(value.as_double());
-    }
-    else if (value.is_string())
-    {
-      args[kebab_key] = plugin::Argument(value.as_string());
-    }
-    // For other types (null, array, object), convert to string representation
-    else
-    {
-      auto str_result = zjson::to_string(value);
-      args[kebab_key] = plugin::Argument(str_result.value_or(""));
-    }
+  validator::ValidationResult result = params_validator->finish();
+  if (result.is_valid && params_validator->has_error())
+  {
+    // A duplicate key replaced the invalid value, so decode the params again in full
+    args.clear();
+    zjson::Reader retry(std::string_view(start, reader.position() - start));
+    decode_params(retry, nullptr, args);
   }
+  return result;
+}
 
-  return args;
+const validator::Schema *RpcServer::find_request_schema(const string &method)
+{
+  const auto &builders = CommandDispatcher::get_instance().get_builders();
+  const auto it = builders.find(method);
+  return it != builders.end() ? it->second.get_request_schema() : nullptr;
+}
+
+const validator::Schema *RpcServer::find_response_schema(const string &method)
+{
+  const auto &builders = CommandDispatcher::get_instance().get_builders();
+  const auto it = builders.find(method);
+  return it != builders.end() ? it->second.get_response_schema() : nullptr;
 }
 
 zjson::Value RpcServer::convert_output_to_json(const string &output)
@@ -252,60 +372,6 @@ zjson::Value RpcServer::convert_output_to_json(const string &output)
   }
 }
 
-zjson::Value RpcServer::convert_ast_to_json(const ast::Node &ast_node)
-{
-  if (!ast_node)
-  {
-    return zjson::Value(); // null
-  }
-
-  switch (ast_node->kind())
-  {
-  case ast::Ast::Null:
-    return zjson::Value(); // null
-
-  case ast::Ast::Boolean:
-    return zjson::Value(ast_node->as_bool());
-
-  case ast::Ast::Integer:
-    return zjson::Value(ast_node->as_integer());
-
-  case ast::Ast::Number:
-    return zjson::Value(ast_node->as_number());
-
-  case ast::Ast::String:
-    return zjson::Value(ast_node->as_string());
-
-  case ast::Ast::Array:
-  {
-    zjson::Value array_value = zjson::Value::create_array();
-    const auto &ast_array = ast_node->as_array();
-    array_value.reserve_array(ast_array.size());
-
-    for (size_t i = 0; i < ast_array.size(); ++i)
-    {
-      array_value.add_to_array(convert_ast_to_json(ast_array[i]));
-    }
-    return array_value;
-  }
-
-  case ast::Ast::Object:
-  {
-    zjson::Value object_value = zjson::Value::create_object();
-    const auto &ast_object = ast_node->as_object();
-
-    for (const auto &pair : ast_object)
-    {
-      object_value.add_to_object(pair.first, convert_ast_to_json(pair.second));
-    }
-    return object_value;
-  }
-
-  default:
-    return zjson::Value(); // null for unknown types
-  }
-}
-
 void RpcServer::print_response(const RpcResponse &response, MiddlewareContext *context)
 {
   // Log errors to the log file
@@ -324,41 +390,83 @@ void RpcServer::print_response(const RpcResponse &response, MiddlewareContext *c
     }
   }
 
-  string json_string = serialize_json(rpc_response_to_json(response));
+  queue_response(serialize_json(rpc_response_to_json(response)), response.error.has_value(), context);
+}
 
-  // Replace placeholders with actual large data
-  if (context && context->get_large_data().size() > 0)
+void RpcServer::queue_response(string json_string, bool is_error, MiddlewareContext *context)
+{
+  // A notification is never answered, not even with an error
+  if (in_notification())
   {
-    auto &large_data_map = context->get_large_data();
-    for (auto it = large_data_map.begin(); it != large_data_map.end();)
+    LOG_DEBUG("Dropping the %s of a notification", is_error ? "error" : "response");
+    return;
+  }
+
+  // Responses to batch members, errors included, are written as part of the batch's response array
+  if (RequestBatch::in_scope())
+  {
+    std::vector<string> segments;
+    if (context && !context->get_large_data().empty())
+    {
+      segments = splice_large_data(json_string, context->get_large_data());
+    }
+    else
     {
-      add_large_data_to_json(json_string, it->first, it->second);
-      it = large_data_map.erase(it);
+      segments.push_back(std::move(json_string));
     }
+    RequestBatch::complete_current(segments);
+    return;
   }
 
-  auto &stream = response.error.has_value() ? std::cerr : std::cout;
-  std::lock_guard<std::mutex> lock(response_mutex);
-  stream << json_string << std::endl;
+  // Queue the response on the shared output channel so that the worker never waits on the client
+  ResponseWriter &writer = ResponseWriter::get_instance();
+  const auto channel = is_error ? ResponseWriter::Error : ResponseWriter::Output;
+  if (context && !context->get_large_data().empty())
+  {
+    // Large data is written between the pieces of the JSON instead of being copied into it
+    writer.write_line(channel, splice_large_data(json_string, context->get_large_data()));
+  }
+  else
+  {
+    writer.write_line(channel, std::move(json_string));
+  }
 }
 
-void RpcServer::add_large_data_to_json(string &json_string, const string &field_name, const string &data)
+std::vector<string> RpcServer::splice_large_data(const string &json_string, std::unordered_map<string, string> &large_data)
 {
-  // Find the field in JSON: "fieldName":""
-  const string search_pattern = "\"" + field_name + "\":\"\"";
-  size_t pos = json_string.find(search_pattern);
-
-  if (pos == string::npos)
+  // Find each field's placeholder in JSON: "fieldName":""
+  std::vector<std::pair<size_t, std::unordered_map<string, string>::iterator>> splices;
+  for (auto it = large_data.begin(); it != large_data.end(); ++it)
   {
-    LOG_ERROR("Could not find empty field '%s' in JSON for large data replacement", field_name.c_str());
-    return;
+    const string search_pattern = "\"" + it->first + "\":\"\"";
+    const size_t pos = json_string.find(search_pattern);
+    if (pos == string::npos)
+    {
+      LOG_ERROR("Could not find empty field '%s' in JSON for large data replacement", it->first.c_str());
+      continue;
+    }
+
+    // The data goes between the quotes of the empty string
+    splices.emplace_back(pos + search_pattern.length() - 1, it);
   }
+  std::sort(splices.begin(), splices.end(), [](const std::pair<size_t, std::unordered_map<string, string>::iterator> &a, const std::pair<size_t, std::unordered_map<string, string>::iterator> &b)
+            { return a.first < b.first; });
 
   // Assume that data is Base64 encoded so no JSON escaping needed
-  const string replacement = "\"" + field_name + "\":\"" + data + "\"";
-  json_string.replace(pos, search_pattern.length(), replacement);
+  std::vector<string> segments;
+  segments.reserve(splices.size() * 2 + 1);
+  size_t start = 0;
+  for (auto &splice : splices)
+  {
+    LOG_DEBUG("Splicing large data into field '%s' (%zu bytes)", splice.second->first.c_str(), splice.second->second.size());
+    segments.push_back(json_string.substr(start, splice.first - start));
+    segments.push_back(std::move(splice.second->second));
+    start = splice.first;
+  }
+  segments.push_back(json_string.substr(start));
 
-  LOG_DEBUG("Replaced empty field '%s' with large data (%zu bytes)", field_name.c_str(), data.size());
+  large_data.clear();
+  return segments;
 }
 
 // Static utility methods
@@ -401,8 +509,169 @@ zjson::Value RpcServer::error_details_to_json(const ErrorDetails &error)
 
 void RpcServer::send_notification(const RpcNotification &notification)
 {
-  string json_string = serialize_json(zjson::to_value(notification).value());
-  std::cout << json_string << std::endl;
+  // Notifications share the response channel so that they stay ordered with the responses
+  ResponseWriter::get_instance().write_line(ResponseWriter::Output, serialize_json(zjson::to_value(notification).value()));
+}
+
+SchedulingClass RpcServer::get_scheduling_class(const string &request_data)
+{
+  string method;
+  try
+  {
+    zjson::Reader reader(request_data);
+    if (!reader.find_member("method") || reader.peek() != zjson::Value::Type::String)
+      return SchedulingClass::Interactive;
+    reader.read_string(method);
+  }
+  catch (const zjson::Error &)
+  {
+    // Malformed requests are answered with an error by process_request, which is quick
+    return SchedulingClass::Interactive;
+  }
+
+  return CommandDispatcher::get_instance().get_scheduling_class(method);
+}
+
+bool RpcServer::is_batch(const string &request_data)
+{
+  const size_t start = request_data.find_first_not_of(" \t\r\n");
+  return start != string::npos && request_data[start] == '[';
+}
+
+// Give a notification the id it needs to parse as a request, as the first member of its object
+static string with_notification_id(std::string_view raw)
+{
+  const size_t body = raw.find_first_not_of(" \t\r\n", 1);
+  const bool empty = body == std::string_view::npos || raw[body] == '}';
+  string request;
+  request.reserve(raw.size() + 20);
+  request += "{\"id\":";
+  request += std::to_string(RpcServer::NOTIFICATION_ID);
+  if (!empty)
+  {
+    request += ',';
+  }
+  request.append(raw.substr(1));
+  return request;
+}
+
+std::shared_ptr<RequestBatch> RpcServer::split_batch(const string &request_data, size_t max_size, std::chrono::milliseconds timeout,
+                                                     std::vector<string> &requests, std::vector<string> &notifications)
+{
+  std::vector<RequestBatch::Member> members;
+  try
+  {
+    zjson::Reader reader(request_data);
+    reader.start();
+    reader.read_array([&]()
+                      {
+                        const std::string_view raw = reader.skip_value();
+
+                        // Elements that are not request objects are answered in their slot and not run
+                        RequestBatch::Member member;
+                        if (raw.front() != '{')
+                        {
+                          member.invalid = "Batch element must be a request object";
+                          requests.emplace_back();
+                          members.push_back(std::move(member));
+                          return;
+                        }
+
+                        // A request without an id is a notification, which is run but gets no slot and no response
+                        zjson::Reader id_reader(raw);
+                        if (!id_reader.find_member("id"))
+                        {
+                          notifications.push_back(with_notification_id(raw));
+                          return;
+                        }
+
+                        // Keep the id and method, to answer the request if the batch times out
+                        member.id.assign(id_reader.skip_value());
+                        zjson::Reader id_value(member.id);
+                        const bool is_number = id_value.peek() == zjson::Value::Number;
+                        const zjson::Value id = is_number ? id_value.read_value() : zjson::Value();
+                        if (!id.is_integer() || id.as_int64() < std::numeric_limits<int>::min() || id.as_int64() > std::numeric_limits<int>::max())
+                        {
+                          member.invalid = "Request id must be an integer";
+                          requests.emplace_back();
+                        }
+                        else
+                        {
+                          requests.emplace_back(raw);
+                        }
+
+                        zjson::Reader method_reader(raw);
+                        if (method_reader.find_member("method") && method_reader.peek() == zjson::Value::String)
+                        {
+                          method_reader.read_string(member.method);
+                        }
+                        members.push_back(std::move(member)); });
+    reader.finish();
+  }
+  catch (const zjson::Error &e)
+  {
+    requests.clear();
+    notifications.clear();
+    const string error_msg = e.what();
+    print_error(-1, RpcErrorCode::PARSE_ERROR, "Failed to parse command request", &error_msg);
+    return nullptr;
+  }
+
+  if (requests.empty() && notifications.empty())
+  {
+    print_error(-1, RpcErrorCode::INVALID_REQUEST, "Batch request must contain at least one request");
+    return nullptr;
+  }
+
+  if (requests.size() + notifications.size() > max_size)
+  {
+    const size_t count = requests.size() + notifications.size();
+    requests.clear();
+    notifications.clear();
+    print_error(-1, RpcErrorCode::INVALID_REQUEST,
+                "Batch of " + std::to_string(count) + " requests exceeds the limit of " + std::to_string(max_size));
+    return nullptr;
+  }
+
+  // A batch of notifications alone is answered with nothing at all
+  if (requests.empty())
+  {
+    return nullptr;
+  }
+
+  LOG_DEBUG("Received batch of %zu requests and %zu notifications", requests.size(), notifications.size());
+  auto batch = std::make_shared<RequestBatch>(std::move(members), timeout);
+
+  // With no member left to run, the batch holds only the errors of its invalid elements
+  if (batch->write_if_answered())
+  {
+    requests.clear();
+    return nullptr;
+  }
+  return batch;
+}
+
+bool &RpcServer::notification_flag()
+{
+  static thread_local bool running_notification = false;
+  return running_notification;
+}
+
+bool RpcServer::in_notification()
+{
+  return notification_flag();
+}
+
+RpcServer::NotificationScope::NotificationScope(bool active)
+    : previous(notification_flag())
+{
+  if (active)
+    notification_flag() = true;
+}
+
+RpcServer::NotificationScope::~NotificationScope()
+{
+  notification_flag() = previous;
 }
 
 void RpcServer::send_timeout_error(const string &request_data, int64_t timeout_ms)
@@ -12,8 +12,12 @@
 #ifndef RPC_SERVER_HPP
 #define RPC_SERVER_HPP
 
+#include <chrono>
+#include <climits>
+#include <memory>
 #include <string>
-#include <mutex>
+#include <unordered_map>
+#include <vector>
 #include "../extend/plugin.hpp"
 #include "../singleton.hpp"
 
@@ -21,12 +25,16 @@
 namespace zjson
 {
 class Value;
+class Reader;
 }
 namespace validator
 {
 struct ValidationResult;
+struct Schema;
 }
 class MiddlewareContext;
+class RequestBatch;
+enum class SchedulingClass;
 struct RpcRequest;
 struct RpcResponse;
 struct RpcNotification;
@@ -41,20 +49,20 @@ class RpcServer : public Singleton<RpcServer>
   friend class Singleton<RpcServer>;
 
 private:
-  std::mutex response_mutex;
-
   // Private constructor for singleton
   RpcServer() = default;
 
   // Helper methods for JSON processing
   RpcRequest parse_rpc_request(const zjson::Value &json);
-  plugin::ArgumentMap convert_json_params_to_argument_map(const zjson::Value &params);
+  validator::ValidationResult decode_params(zjson::Reader &reader, const validator::Schema *schema, plugin::ArgumentMap &args);
+  const validator::Schema *find_request_schema(const std::string &method);
+  const validator::Schema *find_response_schema(const std::string &method);
   zjson::Value convert_output_to_json(const std::string &output);
-  zjson::Value convert_ast_to_json(const ast::Node &ast_node);
   void print_response(const RpcResponse &response, MiddlewareContext *context = nullptr);
+  void queue_response(std::string json_string, bool is_error, MiddlewareContext *context);
   void print_error(int request_id, int code, const std::string &message, const std::string *data = nullptr);
   validator::ValidationResult validate_json_with_schema(const std::string &method, const zjson::Value &params, bool is_request);
-  void add_large_data_to_json(std::string &json_string, const std::string &field_name, const std::string &data);
+  std::vector<std::string> splice_large_data(const std::string &json_string, std::unordered_map<std::string, std::string> &large_data);
 
 public:
   /**
@@ -71,6 +79,38 @@ public:
    */
   void process_request(const std::string &request_data);
 
+  /**
+   * Check whether a request line is a JSON-RPC batch, i.e. a JSON array
+   * @param request_data The raw JSON-RPC request string
+   */
+  static bool is_batch(const std::string &request_data);
+
+  /**
+   * Split a JSON-RPC batch into its requests. A batch that is malformed, empty
+   * or larger than max_size is answered with a single error response here.
+   * Notifications get no slot; they are returned with NOTIFICATION_ID as their id,
+   * to be run under a NotificationScope, so a batch of notifications alone is
+   * answered with nothing. Elements that are not request objects, or whose id is
+   * not an integer, are answered in their slot with an invalid request error.
+   * @param request_data The raw JSON-RPC batch, a JSON array of requests
+   * @param max_size The largest number of requests accepted in one batch
+   * @param timeout The time allowed for the whole batch
+   * @param requests Receives the raw text of each request, in slot order; empty for slots already answered
+   * @param notifications Receives the text of each notification, to run without a response
+   * @return The batch that collects the responses, or null if no request is left to run
+   */
+  std::shared_ptr<RequestBatch> split_batch(const std::string &request_data, size_t max_size, std::chrono::milliseconds timeout,
+                                            std::vector<std::string> &requests, std::vector<std::string> &notifications);
+
+  /**
+   * Look up the scheduling class of a JSON-RPC request from its method name.
+   * Only the request up to the method member is read, so this is cheap enough
+   * to call on the input thread before the request is queued.
+   * @param request_data The raw JSON-RPC request string
+   * @return The method's scheduling class, or Interactive if it cannot be determined
+   */
+  SchedulingClass get_scheduling_class(const std::string &request_data);
+
   /**
    * Utility function to serialize JSON with error handling
    * @param val The JSON value to serialize
@@ -114,6 +154,36 @@ public:
    * @param timeout_ms The timeout value that was exceeded (in milliseconds)
    */
   void send_timeout_error(const std::string &request_data, int64_t timeout_ms);
+
+  // Id given to notifications from a batch so that they parse as requests; never written to the client
+  static constexpr int NOTIFICATION_ID = INT_MIN;
+
+  /**
+   * Runs the requests on this thread as notifications while in scope: their
+   * responses, errors included, are dropped, and no binary frames are read or
+   * written for them, since frames are matched by request id.
+   * An inactive scope changes nothing, so every request can use one.
+   */
+  class NotificationScope
+  {
+  public:
+    explicit NotificationScope(bool active);
+    ~NotificationScope();
+
+    NotificationScope(const NotificationScope &) = delete;
+    NotificationScope &operator=(const NotificationScope &) = delete;
+
+  private:
+    bool previous;
+  };
+
+  /**
+   * Whether a notification is running on this thread
+   */
+  static bool in_notification();
+
+private:
+  static bool &notification_flag();
 };
 
 #endif
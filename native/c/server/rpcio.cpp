@@ -15,17 +15,28 @@
 
 using std::string;
 
-MiddlewareContext::MiddlewareContext(const string &command_path, const plugin::ArgumentMap &args)
-    : plugin::InvocationContext(plugin::ContextArgs(command_path, args, {}, &m_input_stream, &m_output_stream, &m_error_stream))
+MiddlewareContext::MiddlewareContext(const string &command_path, const plugin::ArgumentMap &args, int request_id)
+    : plugin::InvocationContext(plugin::ContextArgs(command_path, args, {}, &m_input_stream, &m_output_stream, &m_error_stream)),
+      m_request_id(request_id),
+      m_input_stream(&m_input_buffer),
+      m_output_stream(&m_output_buffer)
 {
+  // Only the result object is sent back, so handlers need not render text
+  set_output_mode(OutputMode_Structured);
 }
 
-std::stringstream &MiddlewareContext::get_input_stream()
+MiddlewareContext::~MiddlewareContext()
+{
+  // The result object is a member of the base class and would otherwise be released after the arena holding it
+  set_object(ast::Node());
+}
+
+std::istream &MiddlewareContext::get_input_stream()
 {
   return m_input_stream;
 }
 
-std::stringstream &MiddlewareContext::get_output_stream()
+std::ostream &MiddlewareContext::get_output_stream()
 {
   return m_output_stream;
 }
@@ -35,15 +46,20 @@ std::stringstream &MiddlewareContext::get_error_stream()
   return m_error_stream;
 }
 
-void MiddlewareContext::set_input_content(const string &content)
+void MiddlewareContext::set_input_content(string content)
 {
-  m_input_stream.str(content);
+  m_input_buffer.assign(std::move(content));
   m_input_stream.clear(); // Clear any error flags
 }
 
-string MiddlewareContext::get_output_content() const
+const string &MiddlewareContext::get_output_content() const
+{
+  return m_output_buffer.data();
+}
+
+string MiddlewareContext::take_output_content()
 {
-  return m_output_stream.str();
+  return m_output_buffer.take();
 }
 
 string MiddlewareContext::get_error_content() const
@@ -78,7 +94,7 @@ void MiddlewareContext::set_pending_notification(const RpcNotification &notifica
   m_pending_notification.reset(new RpcNotification(notification));
 }
 
-void MiddlewareContext::store_large_data(const string &field_name, const string &data)
+void MiddlewareContext::store_large_data(const string &field_name, string data)
 {
-  m_large_data[field_name] = data;
+  m_large_data[field_name] = std::move(data);
 }
@@ -70,19 +70,91 @@ ZJSON_SERIALIZABLE(RpcResponse,
 
 static constexpr size_t LARGE_DATA_THRESHOLD = 16 * 1024 * 1024; // 16MB
 
+/**
+ * Stream buffer that appends everything written to it to a string, which the
+ * server can take over without copying it
+ */
+class ByteSink : public std::streambuf
+{
+public:
+  const std::string &data() const
+  {
+    return m_data;
+  }
+
+  std::string take()
+  {
+    std::string data;
+    data.swap(m_data);
+    return data;
+  }
+
+protected:
+  int_type overflow(int_type ch) override
+  {
+    if (!traits_type::eq_int_type(ch, traits_type::eof()))
+    {
+      m_data.push_back(traits_type::to_char_type(ch));
+    }
+    return traits_type::not_eof(ch);
+  }
+
+  std::streamsize xsputn(const char *s, std::streamsize count) override
+  {
+    m_data.append(s, static_cast<size_t>(count));
+    return count;
+  }
+
+private:
+  std::string m_data;
+};
+
+/**
+ * Stream buffer that reads from a string it owns, so content handed over by
+ * the server is read in place
+ */
+class ByteSource : public std::streambuf
+{
+public:
+  void assign(std::string data)
+  {
+    m_data = std::move(data);
+    char *begin = &m_data[0];
+    setg(begin, begin, begin + m_data.size());
+  }
+
+private:
+  std::string m_data;
+};
+
 class MiddlewareContext : public plugin::InvocationContext
 {
 public:
-  MiddlewareContext(const std::string &command_path, const plugin::ArgumentMap &args);
+  MiddlewareContext(const std::string &command_path, const plugin::ArgumentMap &args, int request_id = -1);
+  ~MiddlewareContext();
+
+  // Arena for the request's AST; nodes built while dispatching the request are allocated from it
+  ast::Arena &get_arena()
+  {
+    return m_arena;
+  }
+
+  // Id of the JSON-RPC request being run, which tags its binary frames
+  int get_request_id() const
+  {
+    return m_request_id;
+  }
 
-  // Get access to the string streams for reading/writing content
-  std::stringstream &get_input_stream();
-  std::stringstream &get_output_stream();
+  // Get access to the streams for reading/writing content
+  std::istream &get_input_stream();
+  std::ostream &get_output_stream();
   std::stringstream &get_error_stream();
 
   // Helper methods to set input content and get output/error content
-  void set_input_content(const std::string &content);
-  std::string get_output_content() const;
+  void set_input_content(std::string content);
+  const std::string &get_output_content() const;
+  // Move the output content out, leaving the output empty
+  std::string take_output_content();
   std::string get_error_content() const;
 
   // Provide mutable access to arguments for transforms
@@ -103,12 +175,17 @@ public:
     return m_large_data;
   }
 
-  // Store large data to optimize JSON serialization
-  void store_large_data(const std::string &field_name, const std::string &data);
+  // Store large data to optimize JSON serialization; the response is written around it without copying it
+  void store_large_data(const std::string &field_name, std::string data);
 
 private:
-  std::stringstream m_input_stream;
-  std::stringstream m_output_stream;
+  ast::Arena m_arena;
+  int m_request_id;
+  // Request data is raw bytes handed over without copies; only the short error text uses a string stream
+  ByteSource m_input_buffer;
+  ByteSink m_output_buffer;
+  std::istream m_input_stream;
+  std::ostream m_output_stream;
   std::stringstream m_error_stream;
   std::unique_ptr<RpcNotification> m_pending_notification;
   std::unordered_map<std::string, std::string> m_large_data;
@@ -45,6 +45,13 @@ ZJSON_SCHEMA(IssueConsoleCmdRequest,
 
 struct GetInfoRequest {};
 
+struct GetStatsRequest {};
+
+struct SetFramingRequest {};
+ZJSON_SCHEMA(SetFramingRequest,
+    FIELD_REQUIRED(mode, STRING)
+);
+
 struct CreateDatasetRequest {};
 ZJSON_SCHEMA(CreateDatasetRequest,
     FIELD_REQUIRED(dsname, STRING),
@@ -157,6 +164,14 @@ ZJSON_SCHEMA(ListSpoolsRequest,
     FIELD_REQUIRED(jobId, STRING)
 );
 
+struct ReadAllSpoolsRequest {};
+ZJSON_SCHEMA(ReadAllSpoolsRequest,
+    FIELD_OPTIONAL(encoding, STRING),
+    FIELD_OPTIONAL(localEncoding, STRING),
+    FIELD_OPTIONAL(maxBytes, NUMBER),
+    FIELD_REQUIRED(jobId, STRING)
+);
+
 struct ReadSpoolRequest {};
 ZJSON_SCHEMA(ReadSpoolRequest,
     FIELD_OPTIONAL(encoding, STRING),
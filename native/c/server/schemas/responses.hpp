@@ -16,6 +16,17 @@
 
 #include "../validator.hpp"
 
+struct CacheStats {};
+ZJSON_SCHEMA(CacheStats,
+    FIELD_REQUIRED(name, STRING),
+    FIELD_REQUIRED(hits, NUMBER),
+    FIELD_REQUIRED(misses, NUMBER),
+    FIELD_REQUIRED(evictions, NUMBER),
+    FIELD_REQUIRED(entries, NUMBER),
+    FIELD_OPTIONAL(expirations, NUMBER),
+    FIELD_OPTIONAL(invalidations, NUMBER)
+);
+
 struct Dataset {};
 ZJSON_SCHEMA(Dataset,
     FIELD_REQUIRED(name, STRING),
@@ -109,6 +120,18 @@ ZJSON_SCHEMA(GetInfoResponse,
     FIELD_REQUIRED(buildDate, STRING)
 );
 
+struct GetStatsResponse {};
+ZJSON_SCHEMA(GetStatsResponse,
+    FIELD_REQUIRED(success, BOOL),
+    FIELD_REQUIRED_OBJECT_ARRAY(caches, CacheStats)
+);
+
+struct SetFramingResponse {};
+ZJSON_SCHEMA(SetFramingResponse,
+    FIELD_REQUIRED(success, BOOL),
+    FIELD_REQUIRED(mode, STRING)
+);
+
 struct CreateDatasetResponse {};
 ZJSON_SCHEMA(CreateDatasetResponse,
     FIELD_REQUIRED(success, BOOL)
@@ -219,6 +242,24 @@ ZJSON_SCHEMA(ListSpoolsResponse,
     FIELD_REQUIRED_OBJECT_ARRAY(items, Spool)
 );
 
+struct SpoolContents {};
+ZJSON_SCHEMA(SpoolContents,
+    FIELD_REQUIRED(id, NUMBER),
+    FIELD_REQUIRED(ddname, STRING),
+    FIELD_REQUIRED(stepname, STRING),
+    FIELD_REQUIRED(dsname, STRING),
+    FIELD_REQUIRED(procstep, STRING),
+    FIELD_REQUIRED(data, STRING),
+    FIELD_REQUIRED(truncated, BOOL)
+);
+
+struct ReadAllSpoolsResponse {};
+ZJSON_SCHEMA(ReadAllSpoolsResponse,
+    FIELD_REQUIRED(success, BOOL),
+    FIELD_REQUIRED_OBJECT_ARRAY(items, SpoolContents),
+    FIELD_REQUIRED(truncated, BOOL)
+);
+
 struct ReadSpoolResponse {};
 ZJSON_SCHEMA(ReadSpoolResponse,
     FIELD_REQUIRED(success, BOOL),
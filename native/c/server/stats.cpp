@@ -0,0 +1,55 @@
+/**
+ * This program and the accompanying materials are made available under the terms of the
+ * Eclipse Public License v2.0 which accompanies this distribution, and is available at
+ * https://www.eclipse.org/legal/epl-v20.html
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Copyright Contributors to the Zowe Project.
+ *
+ */
+
+#include "stats.hpp"
+#include "fifo_pool.hpp"
+#include "../zjb.hpp"
+#include "../ztype.h"
+#include "../zut.hpp"
+
+using namespace ast;
+
+static Node cache_stats(const std::string &name, unsigned long long hits, unsigned long long misses,
+                       unsigned long long evictions, size_t entries)
+{
+  const auto entry = obj();
+  entry->set("name", str(name));
+  entry->set("hits", i64(static_cast<long long>(hits)));
+  entry->set("misses", i64(static_cast<long long>(misses)));
+  entry->set("evictions", i64(static_cast<long long>(evictions)));
+  entry->set("entries", i64(static_cast<long long>(entries)));
+  return entry;
+}
+
+int handle_get_stats(plugin::InvocationContext &context)
+{
+  const auto caches = arr();
+
+  const JobDDCache::Stats spool = JobDDCache::get_instance().get_stats();
+  const auto spool_entry = cache_stats("spoolFiles", spool.hits, spool.misses, spool.evictions, spool.entries);
+  spool_entry->set("expirations", i64(static_cast<long long>(spool.expirations)));
+  spool_entry->set("invalidations", i64(static_cast<long long>(spool.invalidations)));
+  caches->push(spool_entry);
+
+  const IconvCache::Stats iconv = IconvCache::get_instance().get_stats();
+  caches->push(cache_stats("iconv", iconv.hits, iconv.misses, iconv.evictions, iconv.open));
+
+  // A FIFO lease served by a kept pipe is a hit; leases reclaimed after the lease timeout expired
+  const FifoPool::Stats fifo = FifoPool::get_instance().get_stats();
+  const auto fifo_entry = cache_stats("fifoPipes", fifo.reused, fifo.created, fifo.retired, fifo.idle + fifo.leased);
+  fifo_entry->set("expirations", i64(static_cast<long long>(fifo.reclaimed)));
+  caches->push(fifo_entry);
+
+  const auto result = obj();
+  result->set("caches", caches);
+  context.set_object(result);
+  return RTNCD_SUCCESS;
+}
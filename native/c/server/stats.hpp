@@ -0,0 +1,23 @@
+/**
+ * This program and the accompanying materials are made available under the terms of the
+ * Eclipse Public License v2.0 which accompanies this distribution, and is available at
+ * https://www.eclipse.org/legal/epl-v20.html
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Copyright Contributors to the Zowe Project.
+ *
+ */
+
+#ifndef STATS_HPP
+#define STATS_HPP
+
+#include "../extend/plugin.hpp"
+
+/**
+ * Handler for getStats: reports the hit and miss counters of the caches the
+ * server keeps across requests
+ */
+int handle_get_stats(plugin::InvocationContext &context);
+
+#endif
@@ -10,6 +10,7 @@
  */
 
 #include "validator.hpp"
+#include "../extend/plugin.hpp"
 #include "../zjson.hpp"
 #include <string_view>
 #include <unordered_set>
@@ -20,22 +21,22 @@ namespace validator
 {
 
 /**
- * Check if a JSON value matches the expected type
+ * Check if a JSON value type matches the expected type
  */
-static bool check_type(const zjson::Value &value, FieldType expected_type)
+static bool check_type(zjson::Value::Type actual_type, FieldType expected_type)
 {
   switch (expected_type)
   {
   case FieldType::TYPE_BOOL:
-    return value.is_bool();
+    return actual_type == zjson::Value::Bool;
   case FieldType::TYPE_NUMBER:
-    return value.is_integer() || value.is_double();
+    return actual_type == zjson::Value::Number;
   case FieldType::TYPE_STRING:
-    return value.is_string();
+    return actual_type == zjson::Value::String;
   case FieldType::TYPE_ARRAY:
-    return value.is_array();
+    return actual_type == zjson::Value::Array;
   case FieldType::TYPE_OBJECT:
-    return value.is_object();
+    return actual_type == zjson::Value::Object;
   case FieldType::TYPE_ANY:
     return true;
   default:
@@ -43,6 +44,11 @@ static bool check_type(const zjson::Value &value, FieldType expected_type)
   }
 }
 
+static bool check_type(const zjson::Value &value, FieldType expected_type)
+{
+  return check_type(value.get_type(), expected_type);
+}
+
 /**
  * Get human-readable name for a field type
  */
@@ -70,21 +76,98 @@ static std::string type_name(FieldType type)
 /**
  * Get human-readable name for the actual type of a JSON value
  */
-static std::string actual_type_name(const zjson::Value &value)
+static std::string actual_type_name(zjson::Value::Type type)
 {
-  if (value.is_null())
+  switch (type)
+  {
+  case zjson::Value::Null:
     return "null";
-  if (value.is_bool())
+  case zjson::Value::Bool:
     return "boolean";
-  if (value.is_integer() || value.is_double())
+  case zjson::Value::Number:
     return "number";
-  if (value.is_string())
+  case zjson::Value::String:
     return "string";
-  if (value.is_array())
+  case zjson::Value::Array:
     return "array";
-  if (value.is_object())
+  case zjson::Value::Object:
     return "object";
-  return "unknown";
+  default:
+    return "unknown";
+  }
+}
+
+static std::string actual_type_name(const zjson::Value &value)
+{
+  return actual_type_name(value.get_type());
+}
+
+/**
+ * Get the JSON type that an AST node is written as
+ */
+static zjson::Value::Type node_type(const ast::Node &node)
+{
+  if (!node)
+  {
+    return zjson::Value::Null;
+  }
+
+  switch (node->kind())
+  {
+  case ast::Ast::Boolean:
+    return zjson::Value::Bool;
+  case ast::Ast::Integer:
+  case ast::Ast::Number:
+    return zjson::Value::Number;
+  case ast::Ast::String:
+    return zjson::Value::String;
+  case ast::Ast::Array:
+    return zjson::Value::Array;
+  case ast::Ast::Object:
+    return zjson::Value::Object;
+  default:
+    return zjson::Value::Null;
+  }
+}
+
+/**
+ * Find a field by name, using the sorted lookup table when the schema has one
+ * @return Index of the field in the schema, or field_count if not found
+ */
+static size_t find_field(const Schema &schema, std::string_view name)
+{
+  if (schema.order == nullptr)
+  {
+    for (size_t i = 0; i < schema.field_count; i++)
+    {
+      if (schema.fields[i].name == name)
+      {
+        return i;
+      }
+    }
+    return schema.field_count;
+  }
+
+  size_t low = 0;
+  size_t high = schema.field_count;
+  while (low < high)
+  {
+    const size_t mid = low + (high - low) / 2;
+    if (schema.fields[schema.order[mid]].name < name)
+    {
+      low = mid + 1;
+    }
+    else
+    {
+      high = mid;
+    }
+  }
+
+  if (low < schema.field_count && schema.fields[schema.order[low]].name == name)
+  {
+    return schema.order[low];
+  }
+  return schema.field_count;
 }
 
 /**
@@ -199,4 +282,220 @@ ValidationResult validate_schema(const zjson::Value &params,
   return ValidationResult::success();
 }
 
+ObjectValidator::ObjectValidator(const Schema &schema, bool allow_unknown_fields, const std::string &parent_field)
+    : m_schema(schema), m_allow_unknown_fields(allow_unknown_fields), m_parent_field(parent_field),
+      m_seen(schema.field_count, false), m_errors(schema.field_count), m_has_error(false)
+{
+}
+
+std::string ObjectValidator::get_field_path(std::string_view name) const
+{
+  return m_parent_field.empty() ? std::string(name) : m_parent_field + "." + std::string(name);
+}
+
+std::string ObjectValidator::check_nested(const Schema &schema, const std::string &parent_field, zjson::Reader &reader) const
+{
+  if (!m_parent_field.empty())
+  {
+    reader.skip_value();
+    return "Nested schemas beyond 1 level deep are not supported";
+  }
+
+  ObjectValidator nested(schema, m_allow_unknown_fields, parent_field);
+  std::string_view nested_raw;
+  reader.read_object([&](const std::string &key)
+                     {
+                       if (!nested.check_member(key, reader, nested_raw))
+                       {
+                         reader.skip_value();
+                       } });
+  return nested.finish().error_message;
+}
+
+bool ObjectValidator::check_member(const std::string &key, zjson::Reader &reader, std::string_view &raw)
+{
+  const size_t index = find_field(m_schema, key);
+  if (index == m_schema.field_count)
+  {
+    if (!m_allow_unknown_fields && m_unknown_field.empty())
+    {
+      m_unknown_field = key;
+      m_has_error = true;
+    }
+    return false;
+  }
+
+  // Last occurrence wins for duplicate keys, matching the parsed object
+  const FieldDescriptor &field = m_schema.fields[index];
+  std::string &error = m_errors[index];
+  m_seen[index] = true;
+  error.clear();
+
+  const zjson::Value::Type type = reader.peek();
+
+  // Allow null for optional fields
+  if (type == zjson::Value::Null && !field.required)
+  {
+    return false;
+  }
+
+  // Check type
+  if (!check_type(type, field.type))
+  {
+    error = "Field '" + get_field_path(field.name) + "' has wrong type. Expected " +
+            type_name(field.type) + ", got " + actual_type_name(type);
+    m_has_error = true;
+    return false;
+  }
+
+  const char *start = reader.position();
+
+  // Validate nested object schema (max 1 level deep)
+  if (field.type == FieldType::TYPE_OBJECT && field.nested_schema != nullptr)
+  {
+    error = check_nested(Schema{field.nested_schema, field.nested_schema_count, field.nested_schema_order}, std::string(field.name), reader);
+  }
+  // For arrays, validate only first element (spot check for performance)
+  else if (field.type == FieldType::TYPE_ARRAY && field.array_element_type != FieldType::TYPE_ANY)
+  {
+    bool first = true;
+    reader.read_array([&]()
+                      {
+                        if (!first)
+                        {
+                          reader.skip_value();
+                          return;
+                        }
+                        first = false;
+
+                        const zjson::Value::Type element_type = reader.peek();
+                        if (!check_type(element_type, field.array_element_type))
+                        {
+                          error = "Field '" + get_field_path(field.name) + "[0]' has wrong type. Expected " +
+                                  type_name(field.array_element_type) + ", got " + actual_type_name(element_type);
+                          reader.skip_value();
+                        }
+                        // If it's an object with a schema, validate the schema
+                        else if (field.array_element_type == FieldType::TYPE_OBJECT && field.nested_schema != nullptr)
+                        {
+                          error = check_nested(Schema{field.nested_schema, field.nested_schema_count, field.nested_schema_order}, std::string(field.name) + "[0]", reader);
+                        }
+                        else
+                        {
+                          reader.skip_value();
+                        } });
+  }
+  else
+  {
+    return false;
+  }
+
+  raw = std::string_view(start, reader.position() - start);
+  m_has_error = m_has_error || !error.empty();
+  return true;
+}
+
+std::string ObjectValidator::check_nested(const Schema &schema, const std::string &parent_field, const ast::Node &value) const
+{
+  if (!m_parent_field.empty())
+  {
+    return "Nested schemas beyond 1 level deep are not supported";
+  }
+
+  ObjectValidator nested(schema, m_allow_unknown_fields, parent_field);
+  for (const auto &member : value->as_object())
+  {
+    nested.check_member(member.first, member.second);
+  }
+  return nested.finish().error_message;
+}
+
+void ObjectValidator::check_member(const std::string &key, const ast::Node &value)
+{
+  const size_t index = find_field(m_schema, key);
+  if (index == m_schema.field_count)
+  {
+    if (!m_allow_unknown_fields && m_unknown_field.empty())
+    {
+      m_unknown_field = key;
+      m_has_error = true;
+    }
+    return;
+  }
+
+  const FieldDescriptor &field = m_schema.fields[index];
+  std::string &error = m_errors[index];
+  m_seen[index] = true;
+  error.clear();
+
+  const zjson::Value::Type type = node_type(value);
+
+  // Allow null for optional fields
+  if (type == zjson::Value::Null && !field.required)
+  {
+    return;
+  }
+
+  // Check type
+  if (!check_type(type, field.type))
+  {
+    error = "Field '" + get_field_path(field.name) + "' has wrong type. Expected " +
+            type_name(field.type) + ", got " + actual_type_name(type);
+    m_has_error = true;
+    return;
+  }
+
+  // Validate nested object schema (max 1 level deep)
+  if (field.type == FieldType::TYPE_OBJECT && field.nested_schema != nullptr)
+  {
+    error = check_nested(Schema{field.nested_schema, field.nested_schema_count, field.nested_schema_order}, std::string(field.name), value);
+  }
+  // For arrays, validate only first element (spot check for performance)
+  else if (field.type == FieldType::TYPE_ARRAY && field.array_element_type != FieldType::TYPE_ANY && !value->as_array().empty())
+  {
+    const ast::Node &element = value->as_array()[0];
+    const zjson::Value::Type element_type = node_type(element);
+    if (!check_type(element_type, field.array_element_type))
+    {
+      error = "Field '" + get_field_path(field.name) + "[0]' has wrong type. Expected " +
+              type_name(field.array_element_type) + ", got " + actual_type_name(element_type);
+    }
+    // If it's an object with a schema, validate the schema
+    else if (field.array_element_type == FieldType::TYPE_OBJECT && field.nested_schema != nullptr)
+    {
+      error = check_nested(Schema{field.nested_schema, field.nested_schema_count, field.nested_schema_order}, std::string(field.name) + "[0]", element);
+    }
+  }
+
+  m_has_error = m_has_error || !error.empty();
+}
+
+ValidationResult ObjectValidator::finish() const
+{
+  // Report errors in schema order, as validate_schema does
+  for (size_t i = 0; i < m_schema.field_count; i++)
+  {
+    if (!m_seen[i])
+    {
+      if (m_schema.fields[i].required)
+      {
+        return ValidationResult::error("Missing required field: " + get_field_path(m_schema.fields[i].name));
+      }
+      continue;
+    }
+
+    if (!m_errors[i].empty())
+    {
+      return ValidationResult::error(m_errors[i]);
+    }
+  }
+
+  if (!m_unknown_field.empty())
+  {
+    return ValidationResult::error("Unknown field: " + get_field_path(m_unknown_field));
+  }
+
+  return ValidationResult::success();
+}
+
 } // namespace validator
@@ -12,9 +12,13 @@
 #ifndef VALIDATOR_HPP
 #define VALIDATOR_HPP
 
+#include <array>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <functional>
+#include <vector>
 
 /**
  * Schema-based validation for JSON-RPC messages.
@@ -36,6 +40,12 @@
 namespace zjson
 {
 class Value;
+class Reader;
+}
+namespace ast
+{
+struct Ast;
+typedef std::shared_ptr<Ast> Node;
 }
 
 namespace validator
@@ -65,6 +75,7 @@ struct FieldDescriptor
   FieldType array_element_type;
   const FieldDescriptor *nested_schema = nullptr;
   size_t nested_schema_count = 0;
+  const uint16_t *nested_schema_order = nullptr;
 
   constexpr FieldDescriptor(std::string_view n, FieldType t, bool req)
       : name(n), type(t), required(req), array_element_type(FieldType::TYPE_ANY)
@@ -76,13 +87,13 @@ struct FieldDescriptor
   {
   }
 
-  constexpr FieldDescriptor(std::string_view n, FieldType t, bool req, const FieldDescriptor *nested, size_t nested_count)
-      : name(n), type(t), required(req), array_element_type(FieldType::TYPE_ANY), nested_schema(nested), nested_schema_count(nested_count)
+  constexpr FieldDescriptor(std::string_view n, FieldType t, bool req, const FieldDescriptor *nested, size_t nested_count, const uint16_t *nested_order = nullptr)
+      : name(n), type(t), required(req), array_element_type(FieldType::TYPE_ANY), nested_schema(nested), nested_schema_count(nested_count), nested_schema_order(nested_order)
   {
   }
 
-  constexpr FieldDescriptor(std::string_view n, FieldType t, bool req, FieldType array_elem_type, const FieldDescriptor *nested, size_t nested_count)
-      : name(n), type(t), required(req), array_element_type(array_elem_type), nested_schema(nested), nested_schema_count(nested_count)
+  constexpr FieldDescriptor(std::string_view n, FieldType t, bool req, FieldType array_elem_type, const FieldDescriptor *nested, size_t nested_count, const uint16_t *nested_order = nullptr)
+      : name(n), type(t), required(req), array_element_type(array_elem_type), nested_schema(nested), nested_schema_count(nested_count), nested_schema_order(nested_order)
   {
   }
 };
@@ -95,6 +106,38 @@ struct SchemaRegistry
 {
   inline static constexpr const FieldDescriptor *fields = nullptr;
   inline static constexpr size_t field_count = 0;
+  inline static constexpr const uint16_t *order = nullptr;
+};
+
+/**
+ * Compile-time lookup table for a schema: field indices sorted by name, so
+ * decoders can binary search instead of comparing every field name
+ */
+template <size_t N>
+constexpr std::array<uint16_t, N> sort_fields(const FieldDescriptor (&fields)[N])
+{
+  std::array<uint16_t, N> order{};
+  for (size_t i = 0; i < N; i++)
+  {
+    size_t j = i;
+    while (j > 0 && fields[i].name < fields[order[j - 1]].name)
+    {
+      order[j] = order[j - 1];
+      j--;
+    }
+    order[j] = static_cast<uint16_t>(i);
+  }
+  return order;
+}
+
+/**
+ * A schema as registered with CommandBuilder::validate
+ */
+struct Schema
+{
+  const FieldDescriptor *fields;
+  size_t field_count;
+  const uint16_t *order; // May be null for hand-written schemas
 };
 
 /**
@@ -131,6 +174,58 @@ ValidationResult validate_schema(const zjson::Value &params,
                                  bool allow_unknown_fields = false,
                                  const std::string &parent_field = "");
 
+/**
+ * Validates an object while it is being decoded with zjson::Reader, so that
+ * requests can be checked in the same pass that reads them. Members are fed
+ * in as they are read; finish() reports the same first error, with the same
+ * message, as validate_schema would for the equivalent Value. Responses are
+ * checked the same way, one ast::Node member at a time, while they are written.
+ */
+class ObjectValidator
+{
+public:
+  ObjectValidator(const Schema &schema, bool allow_unknown_fields = false, const std::string &parent_field = "");
+
+  /**
+   * Check the next value in the reader against the schema entry for key.
+   * Arrays and objects that need a deeper look are consumed here and their
+   * JSON text returned through raw; otherwise nothing is consumed.
+   * @return true if the value was consumed
+   */
+  bool check_member(const std::string &key, zjson::Reader &reader, std::string_view &raw);
+
+  /**
+   * Check a member of an ast::Node object against the schema entry for key
+   */
+  void check_member(const std::string &key, const ast::Node &value);
+
+  /**
+   * Whether an error has been recorded so far
+   */
+  bool has_error() const
+  {
+    return m_has_error;
+  }
+
+  /**
+   * Report the result once all members have been checked
+   */
+  ValidationResult finish() const;
+
+private:
+  Schema m_schema;
+  bool m_allow_unknown_fields;
+  std::string m_parent_field;
+  std::vector<bool> m_seen;
+  std::vector<std::string> m_errors;
+  std::string m_unknown_field;
+  bool m_has_error;
+
+  std::string get_field_path(std::string_view name) const;
+  std::string check_nested(const Schema &schema, const std::string &parent_field, zjson::Reader &reader) const;
+  std::string check_nested(const Schema &schema, const std::string &parent_field, const ast::Node &value) const;
+};
+
 } // namespace validator
 
 // Macros for defining schemas
@@ -148,16 +243,16 @@ ValidationResult validate_schema(const zjson::Value &params,
   validator::FieldDescriptor(#name, validator::FieldType::TYPE_ARRAY, false, validator::FieldType::TYPE_##element_type)
 
 #define FIELD_REQUIRED_OBJECT(name, StructType) \
-  validator::FieldDescriptor(#name, validator::FieldType::TYPE_OBJECT, true, validator::SchemaRegistry<StructType>::fields, validator::SchemaRegistry<StructType>::field_count)
+  validator::FieldDescriptor(#name, validator::FieldType::TYPE_OBJECT, true, validator::SchemaRegistry<StructType>::fields, validator::SchemaRegistry<StructType>::field_count, validator::SchemaRegistry<StructType>::order)
 
 #define FIELD_OPTIONAL_OBJECT(name, StructType) \
-  validator::FieldDescriptor(#name, validator::FieldType::TYPE_OBJECT, false, validator::SchemaRegistry<StructType>::fields, validator::SchemaRegistry<StructType>::field_count)
+  validator::FieldDescriptor(#name, validator::FieldType::TYPE_OBJECT, false, validator::SchemaRegistry<StructType>::fields, validator::SchemaRegistry<StructType>::field_count, validator::SchemaRegistry<StructType>::order)
 
 #define FIELD_REQUIRED_OBJECT_ARRAY(name, StructType) \
-  validator::FieldDescriptor(#name, validator::FieldType::TYPE_ARRAY, true, validator::FieldType::TYPE_OBJECT, validator::SchemaRegistry<StructType>::fields, validator::SchemaRegistry<StructType>::field_count)
+  validator::FieldDescriptor(#name, validator::FieldType::TYPE_ARRAY, true, validator::FieldType::TYPE_OBJECT, validator::SchemaRegistry<StructType>::fields, validator::SchemaRegistry<StructType>::field_count, validator::SchemaRegistry<StructType>::order)
 
 #define FIELD_OPTIONAL_OBJECT_ARRAY(name, StructType) \
-  validator::FieldDescriptor(#name, validator::FieldType::TYPE_ARRAY, false, validator::FieldType::TYPE_OBJECT, validator::SchemaRegistry<StructType>::fields, validator::SchemaRegistry<StructType>::field_count)
+  validator::FieldDescriptor(#name, validator::FieldType::TYPE_ARRAY, false, validator::FieldType::TYPE_OBJECT, validator::SchemaRegistry<StructType>::fields, validator::SchemaRegistry<StructType>::field_count, validator::SchemaRegistry<StructType>::order)
 
 #define ZJSON_SCHEMA(StructType, ...)                              \
   namespace validator                                              \
@@ -170,6 +265,11 @@ ValidationResult validate_schema(const zjson::Value &params,
   template <>                                                      \
   inline constexpr size_t SchemaRegistry<StructType>::field_count = \
       sizeof(StructType##_schema_array) / sizeof(FieldDescriptor); \
+  inline constexpr auto StructType##_schema_order =                \
+      sort_fields(StructType##_schema_array);                      \
+  template <>                                                      \
+  inline constexpr const uint16_t *SchemaRegistry<StructType>::order = \
+      StructType##_schema_order.data();                            \
   }
 
 #endif // VALIDATOR_HPP
@@ -11,7 +11,9 @@
 
 #include "worker.hpp"
 #include "rpc_server.hpp"
+#include "request_batch.hpp"
 #include "logger.hpp"
+#include <algorithm>
 #include <thread>
 #include <chrono>
 
@@ -44,8 +46,8 @@ const char *worker_state_to_string(WorkerState state)
 } // namespace
 
 // Worker implementation
-Worker::Worker(int worker_id)
-    : id(worker_id)
+Worker::Worker(int worker_id, WorkerPool *owner)
+    : id(worker_id), pool(owner)
 {
   LOG_DEBUG("Worker %d state -> %s (constructor)", id, worker_state_to_string(WorkerState::Starting));
 }
@@ -71,7 +73,7 @@ void Worker::start()
   LOG_DEBUG("Worker %d started", id);
 }
 
-void Worker::stop()
+void Worker::request_stop()
 {
   WorkerState current_state = state.load(std::memory_order_acquire);
   if (current_state == WorkerState::Exited)
@@ -85,7 +87,24 @@ void Worker::stop()
     LOG_DEBUG("Worker %d state -> %s (stop requested)", id, worker_state_to_string(WorkerState::Stopping));
   }
 
+  {
+    // Wake the worker even if it is just about to sleep
+    std::lock_guard<std::mutex> lock(queue_mutex);
+  }
   queue_condition.notify_all();
+}
+
+void Worker::stop()
+{
+  if (state.load(std::memory_order_acquire) == WorkerState::Exited)
+  {
+    // The loop already left after an earlier request_stop; only its thread is left to join
+    if (worker_thread.joinable() && worker_thread.get_id() != std::this_thread::get_id())
+      worker_thread.join();
+    return;
+  }
+
+  request_stop();
 
   if (worker_thread.joinable())
   {
@@ -120,13 +139,78 @@ void Worker::stop()
     LOG_DEBUG("Worker %d stop requested while faulted/detached", id);
 }
 
-void Worker::add_request(const RequestMetadata &request)
+bool Worker::add_request(RequestMetadata request)
 {
+  auto queued = std::make_shared<RequestMetadata>(std::move(request));
+  return try_add_request(queued);
+}
+
+bool Worker::try_add_request(std::shared_ptr<RequestMetadata> &request)
+{
+  const bool interactive = request->scheduling != SchedulingClass::Bulk;
+  RequestRing &lane = interactive ? request_queue : bulk_request_queue;
+
+  // Count the request before it becomes visible so that a concurrent pop never
+  // drives the depth below zero
+  queue_depth.fetch_add(1, std::memory_order_acq_rel);
+  if (interactive)
+    interactive_depth.fetch_add(1, std::memory_order_acq_rel);
+
+  if (!lane.try_push(request))
   {
-    std::lock_guard<std::mutex> lock(queue_mutex);
-    request_queue.push(request);
+    queue_depth.fetch_sub(1, std::memory_order_acq_rel);
+    if (interactive)
+      interactive_depth.fetch_sub(1, std::memory_order_acq_rel);
+    return false;
+  }
+
+  // Pairs with the fence in wait_for_requests(): either the worker sees the new
+  // request before sleeping, or we see that it is sleeping and wake it
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (sleeping.load(std::memory_order_relaxed))
+  {
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex);
+    }
+    queue_condition.notify_one();
   }
-  queue_condition.notify_one();
+  return true;
+}
+
+bool Worker::has_queued_requests() const
+{
+  return !request_queue.empty() || !bulk_request_queue.empty();
+}
+
+bool Worker::pop_request(std::shared_ptr<RequestMetadata> &request, bool interactive_only)
+{
+  // The interactive lane always goes first so that metadata calls never wait behind queued transfers
+  if (request_queue.try_pop(request))
+  {
+    interactive_depth.fetch_sub(1, std::memory_order_acq_rel);
+  }
+  else if (interactive_only || !bulk_request_queue.try_pop(request))
+  {
+    return false;
+  }
+
+  queue_depth.fetch_sub(1, std::memory_order_acq_rel);
+  return true;
+}
+
+bool Worker::steal_request(std::shared_ptr<RequestMetadata> &request, bool interactive_only)
+{
+  return pop_request(request, interactive_only);
+}
+
+void Worker::wait_for_requests()
+{
+  std::unique_lock<std::mutex> lock(queue_mutex);
+  sleeping.store(true, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  queue_condition.wait(lock, [this]
+                       { return stop_requested.load(std::memory_order_acquire) || has_queued_requests(); });
+  sleeping.store(false, std::memory_order_relaxed);
 }
 
 void Worker::worker_loop()
@@ -135,49 +219,36 @@ void Worker::worker_loop()
   {
     while (true)
     {
-      RequestMetadata request_metadata;
-
+      if (stop_requested.load(std::memory_order_acquire))
       {
-        std::unique_lock<std::mutex> lock(queue_mutex);
-        state.store(WorkerState::Idle, std::memory_order_release);
-        update_heartbeat();
-        queue_condition.wait(lock, [this]
-                             { return stop_requested.load(std::memory_order_acquire) || !request_queue.empty(); });
-
-        if (stop_requested.load(std::memory_order_acquire))
-        {
-          state.store(WorkerState::Stopping, std::memory_order_release);
-          update_heartbeat();
-          LOG_DEBUG("Worker %d state -> %s (stop signaled)", id, worker_state_to_string(WorkerState::Stopping));
-          break;
-        }
-
-        if (request_queue.empty())
-        {
-          update_heartbeat();
-          continue;
-        }
-
-        request_metadata = request_queue.front();
-        request_queue.pop();
-        state.store(WorkerState::Running, std::memory_order_release);
+        state.store(WorkerState::Stopping, std::memory_order_release);
         update_heartbeat();
+        LOG_DEBUG("Worker %d state -> %s (stop signaled)", id, worker_state_to_string(WorkerState::Stopping));
+        break;
       }
 
-      // Track current request for potential recovery
+      state.store(WorkerState::Idle, std::memory_order_release);
+      update_heartbeat();
+
+      // With nothing of our own to do, take work queued behind a busy worker before sleeping
+      std::shared_ptr<RequestMetadata> request_metadata;
+      if (!pop_request(request_metadata, false) && !(pool && pool->steal_request(id, request_metadata)))
       {
-        std::lock_guard<std::mutex> lock(current_request_mutex);
-        current_request_data = request_metadata.data;
+        wait_for_requests();
+        continue;
       }
 
-      process_request(request_metadata.data);
+      state.store(WorkerState::Running, std::memory_order_release);
+      update_heartbeat();
+
+      // Track current request for potential recovery
+      std::atomic_store(&current_request, std::shared_ptr<const RequestMetadata>(request_metadata));
+
+      process_request(*request_metadata);
       update_heartbeat();
 
       // Clear current request after successful processing
-      {
-        std::lock_guard<std::mutex> lock(current_request_mutex);
-        current_request_data.clear();
-      }
+      std::atomic_store(&current_request, std::shared_ptr<const RequestMetadata>());
     }
 
     state.store(WorkerState::Exited, std::memory_order_release);
@@ -205,6 +276,11 @@ bool Worker::is_ready() const
   return current == WorkerState::Idle || current == WorkerState::Running;
 }
 
+size_t Worker::get_load() const
+{
+  return get_queue_depth() + (is_running() ? 1 : 0);
+}
+
 bool Worker::is_running() const
 {
   return state.load(std::memory_order_acquire) == WorkerState::Running;
@@ -229,11 +305,13 @@ WorkerState Worker::get_state() const
   return state.load(std::memory_order_acquire);
 }
 
-void Worker::process_request(const string &data)
+void Worker::process_request(const RequestMetadata &request)
 {
-  // Delegate JSON-RPC processing to the RpcServer singleton
+  // Delegate JSON-RPC processing to the RpcServer singleton; a batch member answers into its batch
   RpcServer &server = RpcServer::get_instance();
-  server.process_request(data);
+  RequestBatch::Scope batch_scope(request.batch, request.batch_index);
+  RpcServer::NotificationScope notification_scope(request.notification);
+  server.process_request(request.data);
 }
 
 void Worker::update_heartbeat()
@@ -264,14 +342,9 @@ std::vector<RequestMetadata> Worker::drain_pending_requests()
 {
   std::vector<RequestMetadata> drained_requests;
 
-  {
-    std::lock_guard<std::mutex> lock(queue_mutex);
-    while (!request_queue.empty())
-    {
-      drained_requests.push_back(request_queue.front());
-      request_queue.pop();
-    }
-  }
+  std::shared_ptr<RequestMetadata> request;
+  while (pop_request(request, false))
+    drained_requests.push_back(std::move(*request));
 
   if (!drained_requests.empty())
   {
@@ -281,38 +354,54 @@ std::vector<RequestMetadata> Worker::drain_pending_requests()
   return drained_requests;
 }
 
-std::string Worker::get_current_request()
+std::shared_ptr<const RequestMetadata> Worker::get_current_request()
 {
-  std::lock_guard<std::mutex> lock(current_request_mutex);
-  return current_request_data;
+  return std::atomic_load(&current_request);
 }
 
 // WorkerPool implementation
 WorkerPool::WorkerPool(long long num_workers,
                        std::chrono::milliseconds request_timeout_param,
+                       long long interactive_workers,
+                       long long min_workers_param,
+                       std::chrono::milliseconds idle_timeout_param,
                        size_t max_replacement_attempts,
                        std::chrono::milliseconds base_replacement_backoff,
                        std::chrono::milliseconds max_replacement_backoff)
     : request_timeout(request_timeout_param <= std::chrono::milliseconds(0) ? std::chrono::seconds(60) : request_timeout_param),
       max_replace_attempts(max_replacement_attempts),
       base_replace_backoff(base_replacement_backoff),
-      max_replace_backoff(max_replacement_backoff)
+      max_replace_backoff(max_replacement_backoff),
+      idle_timeout(idle_timeout_param)
 {
+  // Keep at least one worker that can run bulk requests
+  if (interactive_workers > 0LL && num_workers > 1LL)
+    reserved_workers = static_cast<size_t>(std::min(interactive_workers, num_workers - 1LL));
+
+  // Without a smaller minimum the pool starts every worker and never shrinks.
+  // An elastic pool always keeps the reserved workers and one worker for bulk requests.
+  min_workers = num_workers > 0LL ? static_cast<size_t>(num_workers) : 0;
+  if (min_workers_param > 0LL && min_workers_param < num_workers)
+    min_workers = std::max(static_cast<size_t>(min_workers_param), reserved_workers + 1);
+
   workers.reserve(num_workers);
 
-  // Create workers
+  // Create workers, leaving the slots above the minimum empty until they are needed
   for (auto i = 0LL; i < num_workers; ++i)
   {
-    auto worker = std::make_shared<Worker>(i);
-    workers.push_back(std::move(worker));
+    if (static_cast<size_t>(i) < min_workers)
+      workers.push_back(std::make_shared<Worker>(i, this));
+    else
+      workers.push_back(nullptr);
   }
   ready_list.resize(num_workers, false);
   replacement_attempts.resize(num_workers, 0);
   next_replacement_allowed.resize(num_workers, std::chrono::steady_clock::time_point::min());
 
   // Initialize workers asynchronously
-  for (auto i = 0LL; i < num_workers; ++i)
-    std::thread(&WorkerPool::initialize_worker, this, i).detach();
+  starting_count.store(static_cast<int32_t>(min_workers));
+  for (size_t i = 0; i < min_workers; ++i)
+    std::thread(&WorkerPool::initialize_worker, this, static_cast<int>(i)).detach();
 
   if (num_workers > 0LL)
   {
@@ -331,6 +420,7 @@ void WorkerPool::initialize_worker(int worker_id)
   if (worker_id < 0 || worker_id >= static_cast<int>(workers.size()))
   {
     LOG_ERROR("Invalid worker ID: %d", worker_id);
+    starting_count.fetch_sub(1);
     return;
   }
 
@@ -341,27 +431,98 @@ void WorkerPool::initialize_worker(int worker_id)
 
   // Mark worker as ready
   set_worker_ready(worker_id);
+  starting_count.fetch_sub(1);
 }
 
-void WorkerPool::distribute_request(const string &request)
+void WorkerPool::distribute_request(string request, SchedulingClass scheduling)
 {
-  // Wrap the request in metadata with retry_count = 0
-  RequestMetadata metadata(request, 0);
-  distribute_request_internal(metadata);
+  // Wrap the request in metadata with retry_count = 0; the payload is moved, not copied
+  distribute_request_internal(std::make_shared<RequestMetadata>(std::move(request), 0, "", scheduling));
 }
 
-void WorkerPool::distribute_request_internal(const RequestMetadata &request)
+void WorkerPool::distribute_batch(std::shared_ptr<RequestBatch> batch, std::vector<string> requests,
+                                  const std::vector<SchedulingClass> &scheduling)
 {
-  if (is_shutting_down)
+  {
+    std::lock_guard<std::mutex> lock(batch_mutex);
+    active_batches.push_back(batch);
+  }
+
+  // Each request goes to the least-loaded worker in turn, so the batch spreads across the pool
+  for (size_t i = 0; i < requests.size(); ++i)
+  {
+    // Slots answered when the batch was split have nothing to run
+    if (requests[i].empty())
+      continue;
+
+    auto request = std::make_shared<RequestMetadata>(std::move(requests[i]), 0, "",
+                                                     i < scheduling.size() ? scheduling[i] : SchedulingClass::Interactive);
+    request->batch = batch;
+    request->batch_index = i;
+    distribute_request_internal(std::move(request));
+  }
+}
+
+void WorkerPool::distribute_notification(string notification, SchedulingClass scheduling)
+{
+  auto request = std::make_shared<RequestMetadata>(std::move(notification), 0, "", scheduling);
+  request->notification = true;
+  distribute_request_internal(std::move(request));
+}
+
+void WorkerPool::expire_batches()
+{
+  const auto now = std::chrono::steady_clock::now();
+  std::lock_guard<std::mutex> lock(batch_mutex);
+  active_batches.erase(std::remove_if(active_batches.begin(), active_batches.end(),
+                                      [now](const std::shared_ptr<RequestBatch> &batch)
+                                      { return batch->expire(now); }),
+                       active_batches.end());
+}
+
+void WorkerPool::distribute_request_internal(std::shared_ptr<RequestMetadata> request)
+{
+  // Send the request to the least-loaded ready worker
+  std::shared_ptr<Worker> worker;
+  size_t load = 0;
+  while (true)
+  {
+    if (is_shutting_down)
+      return;
+
+    worker = select_worker(request->scheduling);
+    if (!worker)
+      return;
+
+    load = worker->get_load();
+    if (worker->try_add_request(request))
+      break;
+
+    // Even the least-loaded worker's lane is full; wait for the workers to catch up
+    scale_up();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  // The worker was retired or faulted after it was selected. Its queue may already
+  // have been drained, so move anything left in it to another worker.
+  if (worker->is_stop_requested())
+  {
+    for (auto &pending : worker->drain_pending_requests())
+      distribute_request_internal(std::make_shared<RequestMetadata>(std::move(pending)));
     return;
+  }
 
-  // Simple round-robin distribution to ready workers
-  Worker *worker = get_ready_worker();
-  if (worker)
-    worker->add_request(request);
+  // Even the least-loaded worker was busy, so the pool is saturated
+  if (load >= kScaleUpLoad)
+    scale_up();
 }
 
-Worker *WorkerPool::get_ready_worker()
+Worker *WorkerPool::get_ready_worker(SchedulingClass scheduling)
+{
+  return select_worker(scheduling).get();
+}
+
+std::shared_ptr<Worker> WorkerPool::select_worker(SchedulingClass scheduling)
 {
   std::unique_lock<std::mutex> lock(ready_mutex);
   ready_condition.wait(lock, [this]
@@ -370,31 +531,100 @@ Worker *WorkerPool::get_ready_worker()
   if (is_shutting_down)
     return nullptr;
 
-  // Pop worker index from front for O(1) FIFO access (round-robin style)
-  // Note: The queue may contain stale entries for workers that are no longer ready.
-  // We validate each worker index as its popped from the queue.
-  // This keeps the common path at O(1) while gracefully handling rare state transitions.
-  while (!ready_queue.empty())
+  // Pick the ready worker with the fewest queued and in-flight requests.
+  // Workers remain "ready" even while processing (Running state), so a busy
+  // worker is only chosen when every other worker has at least as much work.
+  // The scan starts after the last choice so that ties rotate between workers.
+  // Bulk requests skip the reserved interactive workers unless no other worker is ready.
+  const size_t worker_count = workers.size();
+  const bool bulk = scheduling == SchedulingClass::Bulk;
+  std::shared_ptr<Worker> best;
+  size_t best_index = 0;
+  size_t best_load = 0;
+  std::shared_ptr<Worker> fallback;
+  size_t fallback_index = 0;
+  size_t fallback_load = 0;
+  for (size_t n = 0; n < worker_count; ++n)
   {
-    size_t worker_index = ready_queue.front();
-    ready_queue.pop_front();
+    const size_t worker_index = (next_dispatch_index + n) % worker_count;
+    const std::shared_ptr<Worker> &worker = workers[worker_index];
+    if (worker_index >= ready_list.size() || !ready_list[worker_index] || !worker || !worker->is_ready())
+      continue;
 
-    // Validate worker is still ready and exists
-    if (worker_index < workers.size() && workers[worker_index] && workers[worker_index]->is_ready())
+    const size_t load = worker->get_load();
+    if (bulk && is_reserved_worker(worker_index))
     {
-      // Re-add worker to back of queue to maintain round-robin distribution
-      // Workers remain "ready" even while processing (Running state)
-      ready_queue.push_back(worker_index);
-      return workers[worker_index].get();
+      if (!fallback || load < fallback_load)
+      {
+        fallback = worker;
+        fallback_index = worker_index;
+        fallback_load = load;
+      }
+      continue;
     }
-    else
+
+    if (!best || load < best_load)
     {
-      // Worker is no longer ready or doesn't exist, continue to next in queue
-      LOG_DEBUG("Worker %zu popped from ready queue but is no longer ready", worker_index);
+      best = worker;
+      best_index = worker_index;
+      best_load = load;
+      if (load == 0)
+        break;
     }
   }
 
-  return nullptr;
+  if (!best && fallback)
+  {
+    best = std::move(fallback);
+    best_index = fallback_index;
+  }
+
+  if (best)
+    next_dispatch_index = (best_index + 1) % worker_count;
+  else
+    LOG_DEBUG("No ready worker found despite ready count %d", ready_count.load());
+
+  return best;
+}
+
+bool WorkerPool::steal_request(int thief_id, std::shared_ptr<RequestMetadata> &request)
+{
+  if (is_shutting_down)
+    return false;
+
+  // Reserved workers only take interactive requests
+  const bool interactive_only = thief_id >= 0 && is_reserved_worker(static_cast<size_t>(thief_id));
+
+  // Snapshot the busy workers with queued requests, then steal outside the lock
+  std::vector<std::pair<size_t, std::shared_ptr<Worker>>> victims;
+  {
+    std::lock_guard<std::mutex> lock(ready_mutex);
+    for (size_t i = 0; i < workers.size(); ++i)
+    {
+      const auto &worker = workers[i];
+      if (static_cast<int>(i) == thief_id || !worker || i >= ready_list.size() || !ready_list[i])
+        continue;
+
+      const size_t depth = interactive_only ? worker->get_interactive_queue_depth() : worker->get_queue_depth();
+      if (depth > 0 && worker->is_running() && !worker->is_stop_requested())
+        victims.emplace_back(depth, worker);
+    }
+  }
+
+  // Deepest queue first, since its oldest request has likely waited longest
+  std::sort(victims.begin(), victims.end(), [](const std::pair<size_t, std::shared_ptr<Worker>> &a, const std::pair<size_t, std::shared_ptr<Worker>> &b)
+            { return a.first > b.first; });
+
+  for (auto &victim : victims)
+  {
+    if (victim.second->steal_request(request, interactive_only))
+    {
+      LOG_DEBUG("Worker %d stole a queued request from busy worker %d", thief_id, victim.second->get_id());
+      return true;
+    }
+  }
+
+  return false;
 }
 
 void WorkerPool::set_worker_ready(int worker_id)
@@ -443,7 +673,6 @@ void WorkerPool::set_worker_ready(int worker_id)
       replacement_attempts[worker_index] = 0;
       next_replacement_allowed[worker_index] = std::chrono::steady_clock::time_point::min();
 
-      ready_queue.push_back(worker_index);
       notify_ready = true;
     }
   }
@@ -461,6 +690,121 @@ int32_t WorkerPool::get_available_workers_count()
   return ready_count.load();
 }
 
+size_t WorkerPool::get_worker_count()
+{
+  std::lock_guard<std::mutex> lock(ready_mutex);
+  return static_cast<size_t>(std::count_if(workers.begin(), workers.end(), [](const std::shared_ptr<Worker> &worker)
+                                           { return worker != nullptr; }));
+}
+
+void WorkerPool::scale_up()
+{
+  // Start one worker at a time; the new worker steals queued requests as soon as it is ready
+  int32_t expected = 0;
+  if (is_shutting_down || !starting_count.compare_exchange_strong(expected, 1))
+    return;
+
+  size_t slot = workers.size();
+  {
+    std::lock_guard<std::mutex> lock(ready_mutex);
+    for (size_t i = 0; i < workers.size(); ++i)
+    {
+      // Slots emptied by a fault belong to the supervisor until a replacement is ready
+      if (!workers[i] && replacement_attempts[i] == 0)
+      {
+        slot = i;
+        break;
+      }
+    }
+  }
+
+  if (slot == workers.size())
+  {
+    starting_count.fetch_sub(1);
+    return;
+  }
+
+  LOG_DEBUG("All workers busy; starting worker %zu", slot);
+  spawn_replacement_worker(slot);
+}
+
+void WorkerPool::scale_down_idle_workers()
+{
+  if (idle_timeout.count() <= 0 || is_shutting_down)
+    return;
+
+  std::shared_ptr<Worker> retired;
+  size_t retired_index = 0;
+  {
+    std::lock_guard<std::mutex> lock(ready_mutex);
+    const auto active = static_cast<size_t>(std::count_if(workers.begin(), workers.end(), [](const std::shared_ptr<Worker> &worker)
+                                                          { return worker != nullptr; }));
+    if (active <= min_workers)
+      return;
+
+    // Retire from the top so that the remaining workers stay in the lowest slots
+    const auto now = std::chrono::steady_clock::now();
+    for (size_t i = workers.size(); i-- > reserved_workers;)
+    {
+      const auto &worker = workers[i];
+      if (!worker || !ready_list[i] || worker->get_state() != WorkerState::Idle || worker->get_queue_depth() > 0)
+        continue;
+      if (now - worker->get_last_heartbeat() < idle_timeout)
+        continue;
+
+      // No longer selectable once it leaves the ready list
+      ready_list[i] = false;
+      ready_count.fetch_sub(1);
+      retired = std::move(workers[i]);
+      retired_index = i;
+      break;
+    }
+  }
+
+  if (!retired)
+    return;
+
+  // Only signal the worker here; the supervisor joins it on a later sweep once it has left its loop
+  LOG_DEBUG("Retiring worker %zu after %lld ms idle", retired_index, static_cast<long long>(idle_timeout.count()));
+  retired->request_stop();
+
+  // Requests dispatched or stolen while the worker was being retired
+  for (auto &pending : retired->drain_pending_requests())
+    distribute_request_internal(std::make_shared<RequestMetadata>(std::move(pending)));
+
+  std::lock_guard<std::mutex> lock(ready_mutex);
+  retiring_workers.push_back(std::move(retired));
+}
+
+void WorkerPool::reap_retired_workers()
+{
+  std::vector<std::shared_ptr<Worker>> exited;
+  {
+    std::lock_guard<std::mutex> lock(ready_mutex);
+    for (auto it = retiring_workers.begin(); it != retiring_workers.end();)
+    {
+      const auto worker_state = (*it)->get_state();
+      if (worker_state != WorkerState::Exited && worker_state != WorkerState::Faulted)
+      {
+        ++it;
+        continue;
+      }
+      exited.push_back(std::move(*it));
+      it = retiring_workers.erase(it);
+    }
+  }
+
+  for (auto &worker : exited)
+  {
+    // The thread has left its loop, so this join does not wait on a request
+    worker->stop();
+
+    // Requests that reached the worker after it was drained
+    for (auto &pending : worker->drain_pending_requests())
+      distribute_request_internal(std::make_shared<RequestMetadata>(std::move(pending)));
+  }
+}
+
 void WorkerPool::shutdown()
 {
   LOG_DEBUG("Shutting down worker pool");
@@ -476,6 +820,14 @@ void WorkerPool::shutdown()
     if (worker)
       worker->stop();
   }
+
+  std::vector<std::shared_ptr<Worker>> retiring;
+  {
+    std::lock_guard<std::mutex> lock(ready_mutex);
+    retiring.swap(retiring_workers);
+  }
+  for (auto &worker : retiring)
+    worker->stop();
   LOG_DEBUG("Worker pool shutdown complete");
 }
 
@@ -539,6 +891,10 @@ void WorkerPool::monitor_workers()
       monitor_worker_at(i);
     }
 
+    reap_retired_workers();
+    scale_down_idle_workers();
+    expire_batches();
+
     // Sleep loop to avoid busy waiting on CPU
     for (int i = 0; i < 5 && supervisor_running && !is_shutting_down; i++)
       std::this_thread::sleep_for(std::chrono::milliseconds(100));
@@ -641,22 +997,27 @@ std::vector<RequestMetadata> WorkerPool::recover_requests_from_worker(
 
   // Get pending requests from queue
   auto pending = old_worker->drain_pending_requests();
-  recovered_requests.insert(recovered_requests.end(), pending.begin(), pending.end());
+  recovered_requests.insert(recovered_requests.end(), std::make_move_iterator(pending.begin()), std::make_move_iterator(pending.end()));
 
   // Recover in-flight request only if it wasn't a timeout/hang
-  std::string current_req = old_worker->get_current_request();
-  if (!current_req.empty())
+  const auto current_req = old_worker->get_current_request();
+  if (current_req && !current_req->data.empty())
   {
     if (!force_detach)
     {
       LOG_DEBUG("Worker %zu: Recovering in-flight request due to %s", worker_index, reason);
-      recovered_requests.emplace_back(current_req, 0);
+      recovered_requests.emplace_back(current_req->data, 0, "", current_req->scheduling);
+      recovered_requests.back().batch = current_req->batch;
+      recovered_requests.back().batch_index = current_req->batch_index;
+      recovered_requests.back().notification = current_req->notification;
     }
     else
     {
       LOG_DEBUG("Worker %zu: Sending timeout error for in-flight request", worker_index);
       RpcServer &server = RpcServer::get_instance();
-      server.send_timeout_error(current_req, request_timeout.count());
+      RequestBatch::Scope batch_scope(current_req->batch, current_req->batch_index);
+      RpcServer::NotificationScope notification_scope(current_req->notification);
+      server.send_timeout_error(current_req->data, request_timeout.count());
     }
   }
 
@@ -670,7 +1031,7 @@ std::vector<RequestMetadata> WorkerPool::recover_requests_from_worker(
 
 void WorkerPool::spawn_replacement_worker(size_t worker_index)
 {
-  auto new_worker = std::make_shared<Worker>(static_cast<int>(worker_index));
+  auto new_worker = std::make_shared<Worker>(static_cast<int>(worker_index), this);
 
   {
     std::lock_guard<std::mutex> lock(ready_mutex);
@@ -731,6 +1092,7 @@ void WorkerPool::replace_worker(size_t worker_index, const char *reason, bool fo
     return;
 
   // Create and spawn the new worker
+  starting_count.fetch_add(1);
   spawn_replacement_worker(worker_index);
 
   // Redistribute recovered requests from old worker
@@ -762,7 +1124,7 @@ void WorkerPool::redistribute_requests(std::vector<RequestMetadata> &requests, s
     LOG_DEBUG("Re-routing request from worker %zu (attempt %zu/%zu). Reason: %s",
               worker_index, req.retry_count, kMaxRequestRetries, reason);
 
-    distribute_request_internal(req);
+    distribute_request_internal(std::make_shared<RequestMetadata>(std::move(req)));
     redistributed_count++;
   }
 
@@ -13,8 +13,6 @@
 #define WORKER_HPP
 
 #include <thread>
-#include <queue>
-#include <deque>
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
@@ -27,6 +25,7 @@
 // Forward declarations
 class Worker;
 class WorkerPool;
+class RequestBatch;
 struct ReplacementContext;
 
 enum class WorkerState
@@ -39,20 +38,138 @@ enum class WorkerState
   Exited
 };
 
+// Scheduling class of an RPC method. Interactive requests (listings, status
+// queries) are served ahead of bulk requests (data transfers, searches) and may
+// also run on workers reserved for them.
+enum class SchedulingClass
+{
+  Interactive,
+  Bulk
+};
+
 // Request metadata for tracking retry attempts
 struct RequestMetadata
 {
-  std::string data;        // The actual request payload
-  size_t retry_count{0UL}; // Number of times this request has been attempted
-  std::string request_id;  // Optional: for logging/debugging
+  std::string data;                                        // The actual request payload
+  size_t retry_count{0UL};                                 // Number of times this request has been attempted
+  std::string request_id;                                  // Optional: for logging/debugging
+  SchedulingClass scheduling{SchedulingClass::Interactive}; // Queue lane the request is served from
+  std::shared_ptr<RequestBatch> batch;                      // Batch whose response array this request answers into, if any
+  size_t batch_index{0UL};                                  // Position of the request in its batch
+  bool notification{false};                                 // Notification from a batch, run without a response
 
   RequestMetadata()
       : retry_count(0)
   {
   }
-  explicit RequestMetadata(const std::string &req_data, size_t retries = 0UL, const std::string &id = "")
-      : data(req_data), retry_count(retries), request_id(id)
+  explicit RequestMetadata(std::string req_data, size_t retries = 0UL, std::string id = "",
+                           SchedulingClass sched = SchedulingClass::Interactive)
+      : data(std::move(req_data)), retry_count(retries), request_id(std::move(id)), scheduling(sched)
+  {
+  }
+};
+
+/**
+ * Bounded lock-free queue with one sequence number per slot (Vyukov's MPMC ring).
+ * Any thread may push or pop, so a worker's queue can be filled by the input
+ * thread while idle workers steal from it and the supervisor drains it.
+ */
+template <typename T, size_t Capacity>
+class BoundedRing
+{
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "BoundedRing capacity must be a power of two");
+
+  struct Cell
+  {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  Cell cells[Capacity];
+  alignas(64) std::atomic<size_t> enqueue_pos{0};
+  alignas(64) std::atomic<size_t> dequeue_pos{0};
+
+public:
+  BoundedRing()
+  {
+    for (size_t i = 0; i < Capacity; ++i)
+      cells[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  BoundedRing(const BoundedRing &) = delete;
+  BoundedRing &operator=(const BoundedRing &) = delete;
+
+  /**
+   * @brief Move a value into the ring
+   *
+   * @param value Moved from only if the push succeeds
+   * @return false if the ring is full
+   */
+  bool try_push(T &value)
+  {
+    size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+    while (true)
+    {
+      Cell &cell = cells[pos & (Capacity - 1)];
+      const size_t seq = cell.sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+      if (diff == 0)
+      {
+        if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        {
+          cell.value = std::move(value);
+          cell.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      }
+      else if (diff < 0)
+      {
+        return false;
+      }
+      else
+      {
+        pos = enqueue_pos.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * @brief Move the oldest value out of the ring
+   *
+   * @return false if the ring is empty (or its oldest value is still being published)
+   */
+  bool try_pop(T &value)
   {
+    size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+    while (true)
+    {
+      Cell &cell = cells[pos & (Capacity - 1)];
+      const size_t seq = cell.sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+      if (diff == 0)
+      {
+        if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        {
+          value = std::move(cell.value);
+          cell.value = T();
+          cell.sequence.store(pos + Capacity, std::memory_order_release);
+          return true;
+        }
+      }
+      else if (diff < 0)
+      {
+        return false;
+      }
+      else
+      {
+        pos = dequeue_pos.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  bool empty() const
+  {
+    return dequeue_pos.load(std::memory_order_acquire) == enqueue_pos.load(std::memory_order_acquire);
   }
 };
 
@@ -69,33 +186,84 @@ class Worker : public std::enable_shared_from_this<Worker>
 private:
   int id;
   std::thread worker_thread;
-  std::queue<RequestMetadata> request_queue;
+  WorkerPool *pool;
+  typedef BoundedRing<std::shared_ptr<RequestMetadata>, 256> RequestRing;
+
+  RequestRing request_queue;      // Interactive lane
+  RequestRing bulk_request_queue; // Bulk lane, served once the interactive lane is empty
+  std::atomic<size_t> queue_depth{0};
+  std::atomic<size_t> interactive_depth{0};
+
+  // Only used to sleep while both lanes are empty; producers take the mutex just to wake a sleeping worker
   std::mutex queue_mutex;
   std::condition_variable queue_condition;
+  std::atomic<bool> sleeping{false};
   std::atomic<bool> stop_requested{false};
   std::atomic<WorkerState> state{WorkerState::Starting};
   std::atomic<int64_t> last_heartbeat_ms{steady_clock_now_ms()};
 
-  // Track the currently processing request for recovery
-  std::string current_request_data;
-  std::mutex current_request_mutex;
+  // The currently processing request, kept for recovery. Read and swapped with std::atomic_load/store.
+  std::shared_ptr<const RequestMetadata> current_request;
 
   // Signaled when worker_loop() exits (normal or faulted)
   std::mutex exit_mutex;
   std::condition_variable exit_condition;
 
   void worker_loop();
-  void process_request(const std::string &data);
+  void wait_for_requests();
+  bool has_queued_requests() const;
+  bool pop_request(std::shared_ptr<RequestMetadata> &request, bool interactive_only);
+  void process_request(const RequestMetadata &request);
   void update_heartbeat();
 
 public:
-  Worker(int worker_id);
+  explicit Worker(int worker_id, WorkerPool *owner = nullptr);
   ~Worker();
 
   void start();
+  // Signal the worker loop to exit after its current request, without waiting for it
+  void request_stop();
   void stop();
-  void add_request(const RequestMetadata &request);
+  /**
+   * @brief Queue a request on this worker
+   *
+   * @return false if the request's lane is full
+   */
+  bool add_request(RequestMetadata request);
+  /**
+   * @brief Queue a request on this worker without copying it
+   *
+   * @param request Moved from only if it was queued
+   * @return false if the request's lane is full
+   */
+  bool try_add_request(std::shared_ptr<RequestMetadata> &request);
   bool is_ready() const;
+  /**
+   * @brief Number of requests queued or in progress on this worker
+   */
+  size_t get_load() const;
+  /**
+   * @brief Number of requests waiting in this worker's queue
+   */
+  size_t get_queue_depth() const
+  {
+    return queue_depth.load(std::memory_order_acquire);
+  }
+  /**
+   * @brief Number of interactive requests waiting in this worker's queue
+   */
+  size_t get_interactive_queue_depth() const
+  {
+    return interactive_depth.load(std::memory_order_acquire);
+  }
+  /**
+   * @brief Take the oldest queued request, for an idle worker to run instead
+   *
+   * @param request Receives the stolen request
+   * @param interactive_only Whether only interactive requests may be taken
+   * @return true if a request was taken
+   */
+  bool steal_request(std::shared_ptr<RequestMetadata> &request, bool interactive_only = false);
   int get_id() const
   {
     return id;
@@ -109,7 +277,7 @@ public:
 
   // Request recovery methods
   std::vector<RequestMetadata> drain_pending_requests();
-  std::string get_current_request();
+  std::shared_ptr<const RequestMetadata> get_current_request();
 };
 
 // Worker pool that manages multiple workers
@@ -117,6 +285,7 @@ class WorkerPool
 {
 private:
   static constexpr size_t kMaxRequestRetries = 2; // Maximum retry attempts for poison pill protection
+  static constexpr size_t kScaleUpLoad = 1;       // Start another worker when the least-loaded one already has this much work
 
   std::vector<std::shared_ptr<Worker>> workers;
 
@@ -134,8 +303,19 @@ private:
   std::chrono::milliseconds base_replace_backoff;
   std::chrono::milliseconds max_replace_backoff;
 
-  // Queue of ready worker indices for constant-time access (round-robin distribution)
-  std::deque<size_t> ready_queue;
+  // Where the next least-loaded scan starts, so that ties rotate between workers
+  size_t next_dispatch_index{0};
+
+  // Workers [0, reserved_workers) only run interactive requests
+  size_t reserved_workers{0};
+
+  // Elastic sizing: slots beyond min_workers start empty and are filled on demand.
+  // Workers idle for longer than idle_timeout are retired down to min_workers.
+  size_t min_workers{0};
+  std::chrono::milliseconds idle_timeout{0};
+  std::atomic<int32_t> starting_count{0};
+  // Workers signalled to stop by scale-down and not joined yet (guarded by ready_mutex)
+  std::vector<std::shared_ptr<Worker>> retiring_workers;
 
   // Whether the pool is shutting down
   std::atomic<bool> is_shutting_down{false};
@@ -144,6 +324,10 @@ private:
   std::thread supervisor_thread;
   std::atomic<bool> supervisor_running{false};
 
+  // Batches still collecting responses; the supervisor answers them once their deadline passes
+  std::mutex batch_mutex;
+  std::vector<std::shared_ptr<RequestBatch>> active_batches;
+
   void initialize_worker(int worker_id);
   void monitor_workers();
   void monitor_worker_at(size_t i);
@@ -204,25 +388,96 @@ private:
    */
   void redistribute_requests(std::vector<RequestMetadata> &requests, size_t worker_index, const char *reason);
 
-  void distribute_request_internal(const RequestMetadata &request);
+  void distribute_request_internal(std::shared_ptr<RequestMetadata> request);
+
+  /**
+   * @brief Start a worker in the first empty slot if the pool is below its maximum size
+   */
+  void scale_up();
+
+  /**
+   * @brief Retire one worker that has been idle for longer than the idle timeout.
+   * The worker is only signalled to stop, so the supervisor never waits for it.
+   */
+  void scale_down_idle_workers();
+
+  /**
+   * @brief Join retired workers whose loop has exited and redistribute anything left in their queues
+   */
+  void reap_retired_workers();
+
+  /**
+   * @brief Write out batches past their deadline and forget batches that have been written
+   */
+  void expire_batches();
+
+  /**
+   * @brief Pick the least-loaded ready worker, keeping it alive for the caller
+   */
+  std::shared_ptr<Worker> select_worker(SchedulingClass scheduling);
 
 public:
   explicit WorkerPool(long long num_workers,
                       std::chrono::milliseconds request_timeout,
+                      long long interactive_workers = 0,
+                      long long min_workers = 0,
+                      std::chrono::milliseconds idle_timeout = std::chrono::milliseconds(0),
                       size_t max_replacement_attempts = 3,
                       std::chrono::milliseconds base_replacement_backoff = std::chrono::milliseconds(200),
                       std::chrono::milliseconds max_replacement_backoff = std::chrono::milliseconds(5000));
   ~WorkerPool();
 
-  void distribute_request(const std::string &request);
+  void distribute_request(std::string request, SchedulingClass scheduling = SchedulingClass::Interactive);
+  /**
+   * @brief Queue each request of a batch on its own, so that they run in parallel
+   *
+   * @param batch Collects the responses and writes them once all requests are answered
+   * @param requests The requests of the batch, in order; empty entries are slots that were already answered
+   * @param scheduling The scheduling class of each request
+   */
+  void distribute_batch(std::shared_ptr<RequestBatch> batch, std::vector<std::string> requests,
+                        const std::vector<SchedulingClass> &scheduling);
+  /**
+   * @brief Queue a notification from a batch; it runs like any request, but its response is dropped
+   * @param notification The notification, with the id that split_batch gave it
+   * @param scheduling Queue lane the notification is served from
+   */
+  void distribute_notification(std::string notification, SchedulingClass scheduling = SchedulingClass::Interactive);
   int32_t get_available_workers_count();
+  /**
+   * @brief Number of workers currently running or starting
+   */
+  size_t get_worker_count();
+  /**
+   * @brief Number of workers the pool keeps running while idle
+   */
+  size_t get_min_workers() const
+  {
+    return min_workers;
+  }
   void shutdown();
   /**
-   * @brief Get the next available worker from the pool
+   * @brief Get the least-loaded available worker from the pool
    *
+   * @param scheduling The scheduling class of the request to be run
    * @return `Worker*` A pointer to the available worker
    */
-  Worker *get_ready_worker();
+  Worker *get_ready_worker(SchedulingClass scheduling = SchedulingClass::Interactive);
+  /**
+   * @brief Whether the worker at the given index only runs interactive requests
+   */
+  bool is_reserved_worker(size_t worker_index) const
+  {
+    return worker_index < reserved_workers;
+  }
+  /**
+   * @brief Hand a queued request from the busiest running worker to an idle one
+   *
+   * @param thief_id The ID of the idle worker asking for work
+   * @param request Receives the stolen request
+   * @return true if a request was stolen
+   */
+  bool steal_request(int thief_id, std::shared_ptr<RequestMetadata> &request);
   /**
    * @brief Marks the given worker ID as ready in the pool
    *
@@ -0,0 +1,111 @@
+/**
+ * This program and the accompanying materials are made available under the terms of the
+ * Eclipse Public License v2.0 which accompanies this distribution, and is available at
+ * https://www.eclipse.org/legal/epl-v20.html
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Copyright Contributors to the Zowe Project.
+ *
+ */
+
+#include "arena.test.hpp"
+#include "../ztest.hpp"
+#include "../../extend/plugin.hpp"
+
+#include <cstring>
+#include <string>
+
+using namespace ztst;
+
+static ast::Node build_list(int count)
+{
+  ast::Node items = ast::arr();
+  for (int i = 0; i < count; i++)
+  {
+    ast::Node item = ast::obj();
+    item->set("name", ast::str("member" + std::to_string(i)));
+    item->set("size", ast::i64(i));
+    item->set("migrated", ast::boolean(false));
+    items->push(item);
+  }
+  return items;
+}
+
+void server_arena_tests()
+{
+  describe("ast::Arena", []()
+           {
+    it("should allocate nodes from the arena while a scope is active", []() {
+      ast::Arena arena;
+      {
+        ast::ArenaScope scope(arena);
+        ast::Node items = build_list(1000);
+        Expect(items->as_array().size()).ToBe(static_cast<size_t>(1000));
+        Expect(items->at(999)->get("name")->as_string()).ToBe(std::string("member999"));
+        Expect(items->at(999)->get("size")->as_integer()).ToBe(static_cast<long long>(999));
+      }
+      Expect(arena.bytes_allocated() > 1000 * sizeof(ast::Ast)).ToBe(true);
+    });
+
+    it("should allocate nodes from the heap outside a scope", []() {
+      ast::Arena arena;
+      {
+        ast::ArenaScope scope(arena);
+      }
+      ast::Node items = build_list(10);
+      Expect(items->as_array().size()).ToBe(static_cast<size_t>(10));
+      Expect(arena.bytes_allocated()).ToBe(static_cast<size_t>(0));
+    });
+
+    it("should restore the previous arena when a nested scope ends", []() {
+      ast::Arena outer;
+      ast::Arena inner;
+      ast::ArenaScope outer_scope(outer);
+      {
+        ast::ArenaScope inner_scope(inner);
+        Expect(ast::current_arena() == &inner).ToBe(true);
+      }
+      Expect(ast::current_arena() == &outer).ToBe(true);
+    });
+
+    it("should allocate nodes from the heap inside a heap scope", []() {
+      ast::Arena arena;
+      ast::Node kept;
+      {
+        ast::ArenaScope scope(arena);
+        {
+          ast::HeapScope heap;
+          kept = build_list(10);
+        }
+        Expect(ast::current_arena() == &arena).ToBe(true);
+      }
+      Expect(arena.bytes_allocated()).ToBe(static_cast<size_t>(0));
+      Expect(kept->as_array().size()).ToBe(static_cast<size_t>(10));
+    });
+
+    it("should count the nodes still referenced", []() {
+      ast::Arena arena;
+      {
+        ast::ArenaScope scope(arena);
+        ast::Node items = build_list(10);
+        Expect(arena.live_parts() > 10).ToBe(true);
+        ast::Node first = items->at(0);
+        items.reset();
+        Expect(arena.live_parts() > 0).ToBe(true);
+      }
+      Expect(arena.live_parts()).ToBe(static_cast<size_t>(0));
+    });
+
+    it("should serve allocations larger than one block", []() {
+      ast::Arena arena;
+      const size_t size = 256 * 1024;
+      char *small = static_cast<char *>(arena.allocate(16, 8));
+      char *large = static_cast<char *>(arena.allocate(size, 8));
+      memset(large, 'x', size);
+      memset(small, 'y', 16);
+      Expect(large[size - 1]).ToBe('x');
+      Expect(reinterpret_cast<uintptr_t>(large) % 8).ToBe(static_cast<uintptr_t>(0));
+      Expect(arena.bytes_allocated()).ToBe(size + 16);
+    }); });
+}
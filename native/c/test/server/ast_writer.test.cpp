@@ -0,0 +1,121 @@
+/**
+ * This program and the accompanying materials are made available under the terms of the
+ * Eclipse Public License v2.0 which accompanies this distribution, and is available at
+ * https://www.eclipse.org/legal/epl-v20.html
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Copyright Contributors to the Zowe Project.
+ *
+ */
+
+#include "ast_writer.test.hpp"
+#include "../ztest.hpp"
+#include "../../server/ast_writer.hpp"
+#include "../../server/validator.hpp"
+#include "../../zjson.hpp"
+
+#include <limits>
+#include <string>
+
+using namespace ztst;
+
+static std::string write_node(const ast::Node &node)
+{
+  std::string out;
+  AstWriter(out).write(node);
+  return out;
+}
+
+void server_ast_writer_tests()
+{
+  describe("AstWriter", []()
+           {
+    it("should write nodes as zjson writes the same values", []() {
+      ast::Node list = ast::arr();
+      list->push(ast::str("quote\" backslash\\ newline\n tab\t"));
+      list->push(ast::i64(-42));
+      list->push(ast::num(0.1));
+      list->push(ast::boolean(true));
+      list->push(ast::nil());
+      list->push(ast::Node());
+      list->push(ast::arr());
+      list->push(ast::obj());
+
+      zjson::Value expected = zjson::Value::create_array();
+      expected.add_to_array(zjson::Value(std::string("quote\" backslash\\ newline\n tab\t")));
+      expected.add_to_array(zjson::Value(-42LL));
+      expected.add_to_array(zjson::Value(0.1));
+      expected.add_to_array(zjson::Value(true));
+      expected.add_to_array(zjson::Value());
+      expected.add_to_array(zjson::Value());
+      expected.add_to_array(zjson::Value::create_array());
+      expected.add_to_array(zjson::Value::create_object());
+
+      std::string expected_json;
+      zjson::write_json(expected_json, expected);
+      Expect(write_node(list)).ToBe(expected_json);
+    });
+
+    it("should write numbers that JSON cannot represent as null", []() {
+      Expect(write_node(ast::num(std::numeric_limits<double>::infinity()))).ToBe(std::string("null"));
+      Expect(write_node(ast::num(std::numeric_limits<double>::quiet_NaN()))).ToBe(std::string("null"));
+    });
+
+    it("should add success to a result and replace the handler's member", []() {
+      ast::Node result = ast::obj();
+      result->set("success", ast::str("ignored"));
+      std::string out;
+      AstWriter(out).write_result(result, false, nullptr);
+      Expect(out).ToBe(std::string("{\"success\":false}"));
+
+      result = ast::obj();
+      result->set("items", ast::arr());
+      out.clear();
+      AstWriter(out).write_result(result, true, nullptr);
+      Expect(out).ToBe(std::string("{\"items\":[],\"success\":true}"));
+    });
+
+    it("should validate a result while writing it", []() {
+      validator::FieldDescriptor schema[] = {
+          validator::FieldDescriptor("success", validator::FieldType::TYPE_BOOL, true),
+          validator::FieldDescriptor("items", validator::FieldType::TYPE_ARRAY, true, validator::FieldType::TYPE_STRING)};
+
+      ast::Node result = ast::obj();
+      ast::Node items = ast::arr();
+      items->push(ast::str("a"));
+      result->set("items", items);
+
+      std::string out;
+      validator::ObjectValidator valid(validator::Schema{schema, 2, nullptr});
+      AstWriter(out).write_result(result, true, &valid);
+      Expect(valid.finish().is_valid).ToBe(true);
+
+      items->push(ast::i64(1));
+      result->set("extra", ast::i64(1));
+      out.clear();
+      validator::ObjectValidator invalid(validator::Schema{schema, 2, nullptr});
+      AstWriter(out).write_result(result, true, &invalid);
+      Expect(invalid.finish().error_message).ToBe(std::string("Unknown field: extra"));
+
+      ast::Node missing = ast::obj();
+      out.clear();
+      validator::ObjectValidator incomplete(validator::Schema{schema, 2, nullptr});
+      AstWriter(out).write_result(missing, true, &incomplete);
+      Expect(incomplete.finish().error_message).ToBe(std::string("Missing required field: items"));
+    });
+
+    it("should reject a result that is not an object", []() {
+      std::string out;
+      bool threw = false;
+      try
+      {
+        AstWriter(out).write_result(ast::arr(), true, nullptr);
+      }
+      catch (const std::exception &)
+      {
+        threw = true;
+      }
+      Expect(threw).ToBe(true);
+    }); });
+}
@@ -0,0 +1,203 @@
+/**
+ * This program and the accompanying materials are made available under the terms of the
+ * Eclipse Public License v2.0 which accompanies this distribution, and is available at
+ * https://www.eclipse.org/legal/epl-v20.html
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Copyright Contributors to the Zowe Project.
+ *
+ */
+
+#include "fifo_pool.test.hpp"
+#include "../ztest.hpp"
+#include "../../server/fifo_pool.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace ztst;
+
+/**
+ * @brief Starts a test with an empty pool
+ */
+static FifoPool &reset_pool()
+{
+  FifoPool &pool = FifoPool::get_instance();
+  pool.shutdown();
+  pool.configure(FifoPool::DEFAULT_MAX_IDLE, std::chrono::minutes(10));
+  return pool;
+}
+
+static bool is_fifo(const std::string &path)
+{
+  struct stat st;
+  return lstat(path.c_str(), &st) == 0 && S_ISFIFO(st.st_mode);
+}
+
+static std::string lease_path(FifoPool &pool)
+{
+  std::string path;
+  std::string error;
+  if (!pool.lease(path, error))
+    throw std::runtime_error(error);
+  return path;
+}
+
+void server_fifo_pool_tests()
+{
+  describe("FifoPool", []()
+           {
+    it("should lease a FIFO named for the user and process with 0600 permissions", []() {
+      FifoPool &pool = reset_pool();
+      const std::string path = lease_path(pool);
+
+      const char *tmp_dir = std::getenv("TMPDIR");
+      const std::string prefix = std::string(tmp_dir != nullptr && tmp_dir[0] != '\0' ? tmp_dir : "/tmp") + "/zowex_" +
+                                 std::to_string(geteuid()) + "_" + std::to_string(getpid()) + "_";
+      Expect(path.compare(0, prefix.size(), prefix)).ToBe(0);
+      Expect(path.compare(path.size() - 5, 5, "_fifo")).ToBe(0);
+
+      struct stat st;
+      Expect(lstat(path.c_str(), &st)).ToBe(0);
+      Expect(S_ISFIFO(st.st_mode)).ToBe(true);
+      Expect(static_cast<int>(st.st_mode & 0777)).ToBe(0600);
+
+      pool.release(path, true);
+      pool.shutdown();
+      Expect(is_fifo(path)).ToBe(false);
+    });
+
+    it("should reuse the channel of a request that succeeded", []() {
+      FifoPool &pool = reset_pool();
+      const std::string first = lease_path(pool);
+      pool.release(first, true);
+
+      const size_t reused = pool.get_stats().reused;
+      const std::string second = lease_path(pool);
+      Expect(second).ToBe(first);
+      Expect(pool.get_stats().reused).ToBe(reused + 1);
+      pool.release(second, true);
+      pool.shutdown();
+    });
+
+    it("should remove the channel of a request that failed", []() {
+      FifoPool &pool = reset_pool();
+      const std::string first = lease_path(pool);
+      pool.release(first, false);
+      Expect(is_fifo(first)).ToBe(false);
+
+      const std::string second = lease_path(pool);
+      Expect(second == first).ToBe(false);
+      pool.release(second, true);
+      pool.shutdown();
+    });
+
+    it("should not reuse a channel a reader still holds open", []() {
+      FifoPool &pool = reset_pool();
+      const std::string first = lease_path(pool);
+      const int reader = open(first.c_str(), O_RDONLY | O_NONBLOCK);
+      Expect(reader >= 0).ToBe(true);
+      pool.release(first, true);
+
+      const std::string second = lease_path(pool);
+      close(reader);
+      Expect(second == first).ToBe(false);
+      Expect(is_fifo(first)).ToBe(false);
+      pool.release(second, true);
+      pool.shutdown();
+    });
+
+    it("should not reuse a channel a writer is still attached to", []() {
+      FifoPool &pool = reset_pool();
+      const std::string first = lease_path(pool);
+      const int reader = open(first.c_str(), O_RDONLY | O_NONBLOCK);
+      const int writer = open(first.c_str(), O_WRONLY | O_NONBLOCK);
+      Expect(writer >= 0).ToBe(true);
+      close(reader);
+      pool.release(first, true);
+
+      const std::string second = lease_path(pool);
+      close(writer);
+      Expect(second == first).ToBe(false);
+      pool.release(second, true);
+      pool.shutdown();
+    });
+
+    it("should not reuse a channel replaced by another FIFO", []() {
+      FifoPool &pool = reset_pool();
+      const std::string first = lease_path(pool);
+      pool.release(first, true);
+      // Keep the original in place under another name, so the new FIFO cannot get its inode
+      const std::string moved = first + ".moved";
+      Expect(rename(first.c_str(), moved.c_str())).ToBe(0);
+      Expect(mkfifo(first.c_str(), 0600)).ToBe(0);
+
+      const std::string second = lease_path(pool);
+      unlink(moved.c_str());
+      Expect(second == first).ToBe(false);
+      Expect(is_fifo(first)).ToBe(false);
+      pool.release(second, true);
+      pool.shutdown();
+    });
+
+    it("should reclaim leases held past the lease timeout", []() {
+      FifoPool &pool = reset_pool();
+      pool.configure(FifoPool::DEFAULT_MAX_IDLE, std::chrono::milliseconds(50));
+      const std::string path = lease_path(pool);
+      Expect(pool.reclaim_stale(std::chrono::steady_clock::now())).ToBe(static_cast<size_t>(0));
+      Expect(pool.reclaim_stale(std::chrono::steady_clock::now() + std::chrono::milliseconds(100))).ToBe(static_cast<size_t>(1));
+      Expect(is_fifo(path)).ToBe(false);
+      Expect(pool.get_stats().leased).ToBe(static_cast<size_t>(0));
+
+      // Returning it afterwards changes nothing
+      pool.release(path, true);
+      Expect(pool.get_stats().idle).ToBe(static_cast<size_t>(0));
+      pool.shutdown();
+    });
+
+    it("should keep no more channels than configured", []() {
+      FifoPool &pool = reset_pool();
+      pool.configure(1, std::chrono::minutes(10));
+      const std::string first = lease_path(pool);
+      const std::string second = lease_path(pool);
+      pool.release(first, true);
+      pool.release(second, true);
+      Expect(pool.get_stats().idle).ToBe(static_cast<size_t>(1));
+      Expect(is_fifo(second)).ToBe(false);
+      pool.shutdown();
+    });
+
+    it("should reuse channels across requests instead of creating a FIFO per request", []() {
+      FifoPool &pool = reset_pool();
+      pool.prefill(FifoPool::DEFAULT_PREFILL);
+      const int iterations = 500;
+
+      const auto pool_start = std::chrono::steady_clock::now();
+      for (int i = 0; i < iterations; i++)
+        pool.release(lease_path(pool), true);
+      const auto pool_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - pool_start).count();
+      Expect(pool.get_stats().created).ToBeLessThan(static_cast<size_t>(iterations));
+
+      const std::string path = lease_path(pool);
+      pool.release(path, false);
+      const auto fifo_start = std::chrono::steady_clock::now();
+      for (int i = 0; i < iterations; i++)
+      {
+        unlink(path.c_str());
+        mkfifo(path.c_str(), 0600);
+        unlink(path.c_str());
+      }
+      const auto fifo_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - fifo_start).count();
+
+      TestLog("Set up and tear down of " + std::to_string(iterations) + " channels: pool " + std::to_string(pool_us) +
+              " us, mkfifo per request " + std::to_string(fifo_us) + " us");
+      pool.shutdown();
+    }); });
+}
@@ -0,0 +1,17 @@
+/**
+ * This program and the accompanying materials are made available under the terms of the
+ * Eclipse Public License v2.0 which accompanies this distribution, and is available at
+ * https://www.eclipse.org/legal/epl-v20.html
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Copyright Contributors to the Zowe Project.
+ *
+ */
+
+#ifndef FIFO_POOL_TEST_HPP
+#define FIFO_POOL_TEST_HPP
+
+void server_fifo_pool_tests();
+
+#endif // FIFO_POOL_TEST_HPP
@@ -0,0 +1,490 @@
+/**
+ * This program and the accompanying materials are made available under the terms of the
+ * Eclipse Public License v2.0 which accompanies this distribution, and is available at
+ * https://www.eclipse.org/legal/epl-v20.html
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Copyright Contributors to the Zowe Project.
+ *
+ */
+
+#include "frame.test.hpp"
+#include "../ztest.hpp"
+#include "../../server/frame.hpp"
+#include "../../server/rpcio.hpp"
+#include "../../server/response_writer.hpp"
+#include "../../zbase64.h"
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+using namespace ztst;
+
+/**
+ * @brief Runs a test body with the response channel redirected to a pipe, reading the pipe while the body runs
+ * @return Everything written to the response channel
+ */
+template <typename Body>
+static std::string capture_output(Body body)
+{
+  int fds[2];
+  if (pipe(fds) != 0)
+    throw std::runtime_error("Failed to create pipe");
+
+  std::string data;
+  std::thread reader([&data, fds]()
+                     {
+    char buffer[65536];
+    ssize_t n;
+    while ((n = read(fds[0], buffer, sizeof(buffer))) > 0)
+      data.append(buffer, static_cast<size_t>(n)); });
+
+  ResponseWriter &writer = ResponseWriter::get_instance();
+  writer.start(fds[1], fds[1]);
+  body();
+  writer.stop();
+  close(fds[1]);
+  reader.join();
+  close(fds[0]);
+  return data;
+}
+
+static std::string make_payload(size_t size)
+{
+  std::string payload(size, '\0');
+  unsigned int state = 12345;
+  for (auto &byte : payload)
+  {
+    state = state * 1103515245 + 12345;
+    byte = static_cast<char>(state >> 16);
+  }
+  return payload;
+}
+
+/**
+ * @brief Builds a frame as it travels between client and server
+ */
+static std::string frame_bytes(unsigned char flags, int32_t request_id, const std::string &payload)
+{
+  char header[frame::HEADER_SIZE];
+  frame::encode_header(frame::Header{flags, request_id, static_cast<uint32_t>(payload.size())}, header);
+  std::string bytes = std::string(header, frame::HEADER_SIZE) + payload;
+  frame::to_wire(&bytes[0], bytes.size());
+  return bytes;
+}
+
+/**
+ * @brief Reads the frames of one payload, up to the frame marked final
+ */
+static bool read_payload_frames(std::istream &in, std::string &payload, size_t &frames)
+{
+  payload.clear();
+  frames = 0;
+  frame::Header header{};
+  do
+  {
+    std::string data;
+    if (!frame::read_frame(in, header, data))
+      return false;
+    payload += data;
+    ++frames;
+  } while ((header.flags & frame::FLAG_FINAL) == 0);
+  return true;
+}
+
+/**
+ * @brief Decodes Base64 text as the client would read it off the wire
+ *
+ * zbase64::encode writes the alphabet in the native character set and zbase64::decode reads it in
+ * EBCDIC, so off z/OS the text is mapped to EBCDIC through the zbase64 tables first.
+ */
+static std::string decode_wire_base64(std::string text)
+{
+#if !defined(__MVS__)
+  unsigned char to_ebcdic[256];
+  for (int i = 0; i < 256; i++)
+    to_ebcdic[i] = static_cast<unsigned char>(i);
+  const unsigned char *decode_table = zbase64::get_ebcdic_decode_table();
+  for (int ebcdic = 0; ebcdic < 256; ebcdic++)
+  {
+    if (decode_table[ebcdic] < 64)
+      to_ebcdic[static_cast<unsigned char>(zbase64::encode_table_ascii[decode_table[ebcdic]])] = static_cast<unsigned char>(ebcdic);
+  }
+  to_ebcdic[static_cast<unsigned char>('=')] = 126; // EBCDIC '='
+  for (auto &c : text)
+    c = static_cast<char>(to_ebcdic[static_cast<unsigned char>(c)]);
+#endif
+  return zbase64::decode(text);
+}
+
+static double cpu_ms(std::clock_t start)
+{
+  return 1000.0 * static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+}
+
+void server_frame_tests()
+{
+  describe("frame header", []()
+           {
+    it("should encode the request id and length big-endian after the marker and flags", []() {
+      char header[frame::HEADER_SIZE];
+      frame::encode_header(frame::Header{frame::FLAG_FINAL, 0x01020304, 0x0A0B0C0D}, header);
+      const std::string bytes(header, frame::HEADER_SIZE);
+      Expect(bytes).ToBe(std::string("\x00\x01\x00\x00\x01\x02\x03\x04\x0A\x0B\x0C\x0D", frame::HEADER_SIZE));
+    });
+
+    it("should decode what it encodes, including negative ids", []() {
+      char bytes[frame::HEADER_SIZE];
+      frame::encode_header(frame::Header{0, -1, 4000000000U}, bytes);
+      frame::Header header{};
+      Expect(frame::decode_header(bytes, header)).ToBe(true);
+      Expect(static_cast<int>(header.flags)).ToBe(0);
+      Expect(header.request_id).ToBe(-1);
+      Expect(header.length).ToBe(4000000000U);
+    });
+
+    it("should not decode bytes that do not start with the marker", []() {
+      const char bytes[frame::HEADER_SIZE] = {'{', '"', 'j', 's', 'o', 'n', 'r', 'p', 'c', '"', ':', '"'};
+      frame::Header header{};
+      Expect(frame::decode_header(bytes, header)).ToBe(false);
+    });
+
+    it("should not decode a header with reserved flags or bytes set", []() {
+      char bytes[frame::HEADER_SIZE];
+      frame::encode_header(frame::Header{frame::FLAG_FINAL, 1, 1}, bytes);
+      frame::Header header{};
+      bytes[1] = static_cast<char>(0x81);
+      Expect(frame::decode_header(bytes, header)).ToBe(false);
+      bytes[1] = static_cast<char>(frame::FLAG_FINAL);
+      bytes[3] = 1;
+      Expect(frame::decode_header(bytes, header)).ToBe(false);
+    });
+
+    it("should read frames and leave the JSON line after them in the stream", []() {
+      const std::string payload("line one\nline\0two", 17);
+      std::istringstream in(frame_bytes(frame::FLAG_FINAL, 7, payload) + frame_bytes(frame::FLAG_FINAL, 8, "") + "{\"id\":7}\n");
+
+      frame::Header header{};
+      std::string data;
+      Expect(in.peek()).ToBe(static_cast<int>(frame::MARKER));
+      Expect(frame::read_frame(in, header, data)).ToBe(true);
+      Expect(header.request_id).ToBe(7);
+      Expect(data).ToBe(payload);
+      Expect(frame::read_frame(in, header, data)).ToBe(true);
+      Expect(header.request_id).ToBe(8);
+      Expect(data).ToBe(std::string());
+
+      std::string line;
+      std::getline(in, line);
+      Expect(line).ToBe(std::string("{\"id\":7}"));
+    });
+
+    it("should fail on a frame cut short", []() {
+      std::istringstream in(frame_bytes(frame::FLAG_FINAL, 1, "0123456789").substr(0, frame::HEADER_SIZE + 4));
+      frame::Header header{};
+      std::string data;
+      Expect(frame::read_frame(in, header, data)).ToBe(false);
+    });
+
+    it("should not read a frame longer than the frame limit", []() {
+      char bytes[frame::HEADER_SIZE];
+      frame::encode_header(frame::Header{frame::FLAG_FINAL, 1, 0xFFFFFFFFU}, bytes);
+      frame::to_wire(bytes, frame::HEADER_SIZE);
+      std::istringstream in(std::string(bytes, frame::HEADER_SIZE));
+      frame::Header header{};
+      std::string data;
+      Expect(frame::read_frame(in, header, data)).ToBe(false);
+      Expect(data.empty()).ToBe(true);
+    }); });
+
+  describe("FrameChannel", []()
+           {
+    it("should hand out a payload only once its final frame has arrived", []() {
+      FrameChannel &channel = FrameChannel::get_instance();
+      channel.set_binary(true);
+
+      channel.receive(frame::Header{0, 5, 3}, "abc");
+      std::string payload;
+      Expect(channel.take_payload(5, payload)).ToBe(false);
+      channel.receive(frame::Header{frame::FLAG_FINAL, 5, 3}, "def");
+      Expect(channel.pending_bytes()).ToBe(static_cast<size_t>(6));
+      Expect(channel.take_payload(5, payload)).ToBe(true);
+      Expect(payload).ToBe(std::string("abcdef"));
+      Expect(channel.take_payload(5, payload)).ToBe(false);
+      Expect(channel.pending_bytes()).ToBe(static_cast<size_t>(0));
+
+      channel.set_binary(false);
+    });
+
+    it("should drop a payload its request did not use", []() {
+      FrameChannel &channel = FrameChannel::get_instance();
+      channel.set_binary(true);
+
+      channel.receive(frame::Header{frame::FLAG_FINAL, 9, 4}, "data");
+      {
+        const FrameChannel::PayloadGuard guard(9);
+      }
+      std::string payload;
+      Expect(channel.take_payload(9, payload)).ToBe(false);
+      Expect(channel.pending_bytes()).ToBe(static_cast<size_t>(0));
+
+      channel.receive(frame::Header{frame::FLAG_FINAL, 10, 4}, "data");
+      channel.set_binary(false);
+      Expect(channel.pending_bytes()).ToBe(static_cast<size_t>(0));
+    });
+
+    it("should skip frames sent while binary framing is off and fail their request", []() {
+      FrameChannel &channel = FrameChannel::get_instance();
+      std::istringstream in(frame_bytes(frame::FLAG_FINAL, 11, "data") + "{\"id\":11}\n");
+      Expect(channel.read_frame(in)).ToBe(true);
+      Expect(channel.pending_bytes()).ToBe(static_cast<size_t>(0));
+
+      std::string line;
+      std::getline(in, line);
+      Expect(line).ToBe(std::string("{\"id\":11}"));
+
+      std::string reason;
+      Expect(channel.take_rejection(11, reason)).ToBe(true);
+      Expect(reason).ToContain("not enabled");
+      Expect(channel.take_rejection(11, reason)).ToBe(false);
+    });
+
+    it("should skip a frame longer than the frame limit without keeping its bytes", []() {
+      FrameChannel &channel = FrameChannel::get_instance();
+      channel.set_binary(true);
+
+      const std::string payload = make_payload(frame::MAX_FRAME_PAYLOAD + 1);
+      std::istringstream in(frame_bytes(0, 12, payload) + frame_bytes(frame::FLAG_FINAL, 12, "tail") + "{\"id\":12}\n");
+      Expect(channel.read_frame(in)).ToBe(true);
+      Expect(channel.read_frame(in)).ToBe(true);
+      Expect(channel.pending_bytes()).ToBe(static_cast<size_t>(0));
+
+      std::string line;
+      std::getline(in, line);
+      Expect(line).ToBe(std::string("{\"id\":12}"));
+
+      std::string data;
+      Expect(channel.take_payload(12, data)).ToBe(false);
+      std::string reason;
+      Expect(channel.take_rejection(12, reason)).ToBe(true);
+      Expect(reason).ToContain("per frame");
+
+      channel.set_binary(false);
+    });
+
+    it("should reject frames once the payloads held reach the pending limit", []() {
+      FrameChannel &channel = FrameChannel::get_instance();
+      channel.set_binary(true);
+
+      const std::string chunk(frame::MAX_FRAME_PAYLOAD, 'x');
+      const size_t frames = frame::MAX_PENDING_BYTES / frame::MAX_FRAME_PAYLOAD;
+      for (size_t i = 0; i < frames; ++i)
+        Expect(channel.receive(frame::Header{0, 13, static_cast<uint32_t>(chunk.size())}, chunk)).ToBe(true);
+      Expect(channel.pending_bytes()).ToBe(frame::MAX_PENDING_BYTES);
+
+      Expect(channel.receive(frame::Header{frame::FLAG_FINAL, 14, 1}, "y")).ToBe(false);
+      std::string reason;
+      Expect(channel.take_rejection(14, reason)).ToBe(true);
+      Expect(reason).ToContain("waiting");
+
+      // The payload that reached the limit is still whole
+      Expect(channel.receive(frame::Header{frame::FLAG_FINAL, 13, 0}, "")).ToBe(true);
+      std::string data;
+      Expect(channel.take_payload(13, data)).ToBe(true);
+      Expect(data.size()).ToBe(frame::MAX_PENDING_BYTES);
+      Expect(channel.pending_bytes()).ToBe(static_cast<size_t>(0));
+
+      channel.set_binary(false);
+    });
+
+    it("should skip a frame with a malformed header up to the next line", []() {
+      FrameChannel &channel = FrameChannel::get_instance();
+      channel.set_binary(true);
+
+      std::string bytes = frame_bytes(frame::FLAG_FINAL, 15, "data\nmore");
+      bytes[1] = static_cast<char>(0x80);
+      std::istringstream in(bytes + "{\"id\":16}\n");
+      Expect(channel.read_frame(in)).ToBe(true);
+      std::string line;
+      std::getline(in, line);
+      Expect(line).ToBe(std::string("more{\"id\":16}"));
+      Expect(channel.pending_bytes()).ToBe(static_cast<size_t>(0));
+
+      channel.set_binary(false);
+    });
+
+    it("should report input that ends inside a frame", []() {
+      FrameChannel &channel = FrameChannel::get_instance();
+      channel.set_binary(true);
+
+      std::istringstream in(frame_bytes(frame::FLAG_FINAL, 17, "0123456789").substr(0, frame::HEADER_SIZE + 4));
+      Expect(channel.read_frame(in)).ToBe(false);
+
+      channel.set_binary(false);
+    });
+
+    it("should drop payloads whose request does not arrive", []() {
+      FrameChannel &channel = FrameChannel::get_instance();
+      channel.set_binary(true);
+
+      channel.receive(frame::Header{frame::FLAG_FINAL, 18, 4}, "data");
+      channel.receive(frame::Header{0, 19, 4}, "part");
+      Expect(channel.expire_stale(std::chrono::steady_clock::now())).ToBe(static_cast<size_t>(0));
+      Expect(channel.pending_bytes()).ToBe(static_cast<size_t>(8));
+      Expect(channel.expire_stale(std::chrono::steady_clock::now() + std::chrono::hours(1))).ToBe(static_cast<size_t>(2));
+      Expect(channel.pending_bytes()).ToBe(static_cast<size_t>(0));
+
+      std::string data;
+      Expect(channel.take_payload(18, data)).ToBe(false);
+
+      channel.set_binary(false);
+    });
+
+    it("should write a payload as a frame ahead of the response queued after it", []() {
+      const std::string payload("raw\n\0bytes", 10);
+      const std::string output = capture_output([&payload]() {
+        FrameChannel::get_instance().send_payload(3, payload);
+        ResponseWriter::get_instance().write_line(ResponseWriter::Output, "{\"id\":3}");
+      });
+      Expect(output).ToBe(frame_bytes(frame::FLAG_FINAL, 3, payload) + "{\"id\":3}\n");
+    });
+
+    it("should split a payload longer than the frame limit over several frames", []() {
+      const std::string payload = make_payload(2 * frame::MAX_FRAME_PAYLOAD + 100);
+      const std::string output = capture_output([&payload]() {
+        FrameChannel::get_instance().send_payload(4, payload);
+        ResponseWriter::get_instance().write_line(ResponseWriter::Output, "{\"id\":4}");
+      });
+
+      std::istringstream in(output);
+      std::string data;
+      size_t frames = 0;
+      Expect(read_payload_frames(in, data, frames)).ToBe(true);
+      Expect(frames).ToBe(static_cast<size_t>(3));
+      Expect(data == payload).ToBe(true);
+
+      std::string line;
+      std::getline(in, line);
+      Expect(line).ToBe(std::string("{\"id\":4}"));
+    }); });
+
+  describe("MiddlewareContext byte buffers", []()
+           {
+    it("should move output bytes out without leaving a copy behind", []() {
+      ByteSink sink;
+      std::ostream out(&sink);
+      out << "abc" << 12 << '\n';
+      out.write("\0z", 2);
+      Expect(sink.data()).ToBe(std::string("abc12\n\0z", 8));
+      Expect(sink.take()).ToBe(std::string("abc12\n\0z", 8));
+      Expect(sink.data().empty()).ToBe(true);
+    });
+
+    it("should read input bytes in place", []() {
+      ByteSource source;
+      source.assign(std::string("first\nsecond\0", 13));
+      std::istream in(&source);
+      std::string line;
+      std::getline(in, line);
+      Expect(line).ToBe(std::string("first"));
+      const std::string rest((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+      Expect(rest).ToBe(std::string("second\0", 7));
+
+      source.assign(std::string());
+      in.clear();
+      Expect(in.peek()).ToBe(std::char_traits<char>::eof());
+    }); });
+
+  describe("binary framing loopback", []()
+           {
+    it("should move bulk data in fewer wire bytes than Base64 in JSON", []() {
+      const size_t size = 8 * 1024 * 1024;
+      const double megabytes = static_cast<double>(size) / (1024 * 1024);
+      const std::string payload = make_payload(size);
+      const size_t frames_per_payload = (size + frame::MAX_FRAME_PAYLOAD - 1) / frame::MAX_FRAME_PAYLOAD;
+
+      // Read: the server writes the data of a response, the client extracts it
+      const std::string read_prefix = "{\"jsonrpc\":\"2.0\",\"result\":{\"success\":true,\"data\":\"";
+      const std::string read_suffix = "\"},\"id\":1}";
+      std::clock_t start = std::clock();
+      std::string wire = capture_output([&]() {
+        const std::string encoded = zbase64::encode(payload);
+        ResponseWriter::get_instance().write_line(ResponseWriter::Output, std::vector<std::string>{read_prefix, encoded, read_suffix});
+      });
+      const size_t start_of_data = wire.find("\"data\":\"") + 8;
+      const std::string json_read = decode_wire_base64(wire.substr(start_of_data, wire.find('"', start_of_data) - start_of_data));
+      const double json_read_ms = cpu_ms(start);
+      const size_t json_read_bytes = wire.size();
+
+      const std::string read_line = "{\"jsonrpc\":\"2.0\",\"result\":{\"success\":true,\"data\":\"\"},\"id\":1}";
+      start = std::clock();
+      wire = capture_output([&]() {
+        FrameChannel::get_instance().send_payload(1, payload);
+        ResponseWriter::get_instance().write_line(ResponseWriter::Output, read_line);
+      });
+      std::istringstream frames(wire);
+      std::string frame_read;
+      size_t frame_count = 0;
+      Expect(read_payload_frames(frames, frame_read, frame_count)).ToBe(true);
+      const double frame_read_ms = cpu_ms(start);
+      const size_t frame_read_bytes = wire.size();
+
+      // Write: the client sends the data of a request, the server takes it
+      const std::string write_prefix = "{\"jsonrpc\":\"2.0\",\"method\":\"writeFile\",\"params\":{\"fspath\":\"/tmp/f\",\"data\":\"";
+      const std::string write_suffix = "\"},\"id\":2}";
+      start = std::clock();
+      std::string line = write_prefix + zbase64::encode(payload) + write_suffix + "\n";
+      const size_t json_write_bytes = line.size();
+      std::istringstream json_in(std::move(line));
+      std::getline(json_in, line);
+      const size_t data_start = line.find("\"data\":\"") + 8;
+      const std::string json_write = decode_wire_base64(line.substr(data_start, line.find('"', data_start) - data_start));
+      const double json_write_ms = cpu_ms(start);
+
+      const std::string write_line = "{\"jsonrpc\":\"2.0\",\"method\":\"writeFile\",\"params\":{\"fspath\":\"/tmp/f\"},\"id\":2}";
+      start = std::clock();
+      std::string request;
+      for (size_t offset = 0; offset < payload.size(); offset += frame::MAX_FRAME_PAYLOAD)
+      {
+        const size_t length = std::min(frame::MAX_FRAME_PAYLOAD, payload.size() - offset);
+        request += frame_bytes(offset + length == payload.size() ? frame::FLAG_FINAL : 0, 2, payload.substr(offset, length));
+      }
+      request += write_line + "\n";
+      const size_t frame_write_bytes = request.size();
+      std::istringstream frame_in(std::move(request));
+      std::string frame_write;
+      FrameChannel &channel = FrameChannel::get_instance();
+      channel.set_binary(true);
+      while (frame_in.peek() == frame::MARKER)
+        Expect(channel.read_frame(frame_in)).ToBe(true);
+      Expect(channel.take_payload(2, frame_write)).ToBe(true);
+      channel.set_binary(false);
+      const double frame_write_ms = cpu_ms(start);
+
+      Expect(json_read == payload).ToBe(true);
+      Expect(frame_read == payload).ToBe(true);
+      Expect(json_write == payload).ToBe(true);
+      Expect(frame_write == payload).ToBe(true);
+
+      // Base64 adds a third to the data; frames add a header per MB
+      Expect(frame_count).ToBe(frames_per_payload);
+      Expect(json_read_bytes).ToBe(read_prefix.size() + zbase64::encoded_size(size) + read_suffix.size() + 1);
+      Expect(json_write_bytes).ToBe(write_prefix.size() + zbase64::encoded_size(size) + write_suffix.size() + 1);
+      Expect(frame_read_bytes).ToBe(frames_per_payload * frame::HEADER_SIZE + size + read_line.size() + 1);
+      Expect(frame_write_bytes).ToBe(frames_per_payload * frame::HEADER_SIZE + size + write_line.size() + 1);
+
+      // CPU time depends on the machine and its load, so it is reported rather than compared
+      TestLog("Read of " + std::to_string(size) + " bytes: Base64 " + std::to_string(json_read_bytes) + " wire bytes, " + std::to_string(json_read_ms / megabytes) +
+              " ms CPU/MB; frames " + std::to_string(frame_read_bytes) + " wire bytes, " + std::to_string(frame_read_ms / megabytes) + " ms CPU/MB");
+      TestLog("Write of " + std::to_string(size) + " bytes: Base64 " + std::to_string(json_write_bytes) + " wire bytes, " + std::to_string(json_write_ms / megabytes) +
+              " ms CPU/MB; frames " + std::to_string(frame_write_bytes) + " wire bytes, " + std::to_string(frame_write_ms / megabytes) + " ms CPU/MB");
+    }); });
+}
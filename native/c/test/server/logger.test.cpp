@@ -0,0 +1,216 @@
+/**
+ * This program and the accompanying materials are made available under the terms of the
+ * Eclipse Public License v2.0 which accompanies this distribution, and is available at
+ * https://www.eclipse.org/legal/epl-v20.html
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Copyright Contributors to the Zowe Project.
+ *
+ */
+
+#include "logger.test.hpp"
+#include "../ztest.hpp"
+#include "../../server/logger.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace ztst;
+
+/**
+ * @brief Temporary executable directory; the logger writes into its logs subdirectory
+ */
+struct TempLogDir
+{
+  std::string dir;
+
+  TempLogDir()
+  {
+    char path[] = "/tmp/zowex_logger_test_XXXXXX";
+    if (mkdtemp(path) == nullptr)
+      throw std::runtime_error("Failed to create temporary directory");
+    dir = path;
+  }
+
+  ~TempLogDir()
+  {
+    server::Logger::shutdown();
+    for (int i = 0; i <= server::Logger::MAX_LOG_FILES; i++)
+      unlink(log_path(i).c_str());
+    rmdir((dir + "/logs").c_str());
+    rmdir(dir.c_str());
+  }
+
+  // Path of the active log file, or of the rotated file with the given number
+  std::string log_path(int number = 0) const
+  {
+    const std::string path = dir + "/logs/zowex_server.log";
+    return number == 0 ? path : path + "." + std::to_string(number);
+  }
+
+  bool exists(int number) const
+  {
+    struct stat st;
+    return stat(log_path(number).c_str(), &st) == 0;
+  }
+
+  std::string read(int number = 0) const
+  {
+    std::ifstream file(log_path(number));
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+  }
+};
+
+static std::vector<std::string> split_lines(const std::string &text)
+{
+  std::vector<std::string> lines;
+  std::stringstream stream(text);
+  std::string line;
+  while (std::getline(stream, line))
+    lines.push_back(line);
+  return lines;
+}
+
+void server_logger_tests()
+{
+  describe("server::Logger", []()
+           {
+    it("should write every line, keeping each thread's lines in order", []() {
+      TempLogDir temp;
+      server::Logger::init_logger(temp.dir.c_str(), false, true);
+
+      const int thread_count = 4;
+      const int lines_per_thread = 2000;
+      std::vector<std::thread> threads;
+      for (int t = 0; t < thread_count; t++)
+      {
+        threads.emplace_back([t]() {
+          for (int i = 0; i < lines_per_thread; i++)
+            LOG_INFO("%d:%d", t, i);
+        });
+      }
+      for (auto &thread : threads)
+        thread.join();
+      server::Logger::shutdown();
+
+      const auto lines = split_lines(temp.read());
+      Expect(lines.size()).ToBe(static_cast<size_t>(thread_count * lines_per_thread));
+
+      std::vector<int> next(thread_count, 0);
+      bool ordered = true;
+      for (const auto &line : lines)
+      {
+        const std::string message = line.substr(line.find("[INFO] ") + 7);
+        const int t = std::stoi(message.substr(0, message.find(':')));
+        const int i = std::stoi(message.substr(message.find(':') + 1));
+        ordered = ordered && i == next[t];
+        next[t] = i + 1;
+      }
+      Expect(ordered).ToBe(true);
+    });
+
+    it("should skip debug lines unless verbose logging is enabled", []() {
+      TempLogDir temp;
+      server::Logger::init_logger(temp.dir.c_str(), false, true);
+      LOG_DEBUG("hidden");
+      LOG_WARN("shown");
+      server::Logger::shutdown();
+
+      const std::string content = temp.read();
+      Expect(content.find("hidden")).ToBe(std::string::npos);
+      Expect(content.find("[WARN] shown") != std::string::npos).ToBe(true);
+    });
+
+    it("should not evaluate the arguments of a disabled level", []() {
+      TempLogDir temp;
+      server::Logger::init_logger(temp.dir.c_str(), false, true);
+      int evaluations = 0;
+      const auto argument = [&evaluations]() {
+        evaluations++;
+        return "argument";
+      };
+      LOG_DEBUG("%s", argument());
+      LOG_INFO("%s", argument());
+      server::Logger::shutdown();
+
+      Expect(evaluations).ToBe(1);
+    });
+
+    it("should format deferred records on the writer thread", []() {
+      TempLogDir temp;
+      server::Logger::init_logger(temp.dir.c_str(), true, true);
+      char name[] = "worker";
+      server::Logger::log_deferred(server::Logger::Debug, "%s %d state -> %s (%zu, %.1f, %c)", name, 7, "Idle", static_cast<size_t>(12), 1.5, 'z');
+      strcpy(name, "reused"); // C strings are captured by value
+      server::Logger::log_deferred(server::Logger::Warn, "no arguments");
+      server::Logger::shutdown();
+
+      const auto lines = split_lines(temp.read());
+      Expect(lines.size()).ToBe(static_cast<size_t>(3));
+      Expect(lines[1].substr(lines[1].find(" [") + 1)).ToBe("[DEBUG] worker 7 state -> Idle (12, 1.5, z)");
+      Expect(lines[2].substr(lines[2].find(" [") + 1)).ToBe("[WARN] no arguments");
+    });
+
+    it("should format a deferred record right away when its arguments are too large to capture", []() {
+      TempLogDir temp;
+      server::Logger::init_logger(temp.dir.c_str(), false, true);
+      const std::string large(2 * server::Logger::LOG_BUFFER_SIZE, 'y');
+      server::Logger::log_deferred(server::Logger::Info, "large %s", large.c_str());
+      server::Logger::log_deferred(server::Logger::Debug, "hidden %s", large.c_str());
+      server::Logger::shutdown();
+
+      const auto lines = split_lines(temp.read());
+      Expect(lines.size()).ToBe(static_cast<size_t>(1));
+      Expect(lines[0].find("[INFO] large yyyy") != std::string::npos).ToBe(true);
+      Expect(lines[0].size() < 2 * server::Logger::LOG_BUFFER_SIZE).ToBe(true);
+    });
+
+    it("should rotate to numbered files once the size limit is reached", []() {
+      TempLogDir temp;
+      const size_t max_file_size = 4096;
+      server::Logger::init_logger(temp.dir.c_str(), false, true, max_file_size, 3);
+      const std::string padding(100, 'x');
+      for (int i = 0; i < 1000; i++)
+      {
+        LOG_INFO("%d %s", i, padding.c_str());
+        if (i % 50 == 0)
+          usleep(1000); // Let the writer thread catch up, so that several rotations happen
+      }
+      server::Logger::shutdown();
+
+      Expect(temp.exists(0)).ToBe(true);
+      Expect(temp.exists(1)).ToBe(true);
+      Expect(temp.exists(2)).ToBe(true);
+      Expect(temp.exists(3)).ToBe(false);
+      const std::string content = temp.read();
+      Expect(content.find("[INFO] Log file rotated due to size limit") != std::string::npos).ToBe(true);
+      Expect(content.find("[INFO] 999 ") != std::string::npos).ToBe(true);
+    });
+
+    it("should truncate instead of rotating when keeping a single file", []() {
+      TempLogDir temp;
+      server::Logger::init_logger(temp.dir.c_str(), false, true, 4096, 1);
+      const std::string padding(100, 'x');
+      for (int i = 0; i < 1000; i++)
+        LOG_INFO("%d %s", i, padding.c_str());
+      server::Logger::shutdown();
+
+      Expect(temp.exists(0)).ToBe(true);
+      Expect(temp.exists(1)).ToBe(false);
+      const std::string content = temp.read();
+      Expect(content.find("[INFO] Log file truncated due to size limit") != std::string::npos).ToBe(true);
+      Expect(content.find("[INFO] 999 ") != std::string::npos).ToBe(true);
+    }); });
+}
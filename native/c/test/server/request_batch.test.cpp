@@ -0,0 +1,181 @@
+/**
+ * This program and the accompanying materials are made available under the terms of the
+ * Eclipse Public License v2.0 which accompanies this distribution, and is available at
+ * https://www.eclipse.org/legal/epl-v20.html
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Copyright Contributors to the Zowe Project.
+ *
+ */
+
+#include "request_batch.test.hpp"
+#include "../ztest.hpp"
+#include "../../server/request_batch.hpp"
+#include "../../server/response_writer.hpp"
+
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+using namespace ztst;
+
+/**
+ * @brief Runs a test body with the response channel redirected to a pipe
+ * @return Everything written to the response channel
+ */
+template <typename Body>
+static std::string capture_responses(Body body)
+{
+  int fds[2];
+  if (pipe(fds) != 0)
+    throw std::runtime_error("Failed to create pipe");
+
+  ResponseWriter &writer = ResponseWriter::get_instance();
+  writer.start(fds[1], fds[1]);
+  body();
+  writer.stop();
+  close(fds[1]);
+
+  std::string data;
+  char buffer[4096];
+  ssize_t n;
+  while ((n = read(fds[0], buffer, sizeof(buffer))) > 0)
+    data.append(buffer, static_cast<size_t>(n));
+  close(fds[0]);
+  return data;
+}
+
+static std::vector<RequestBatch::Member> make_members(int count)
+{
+  std::vector<RequestBatch::Member> members;
+  for (int i = 0; i < count; i++)
+    members.push_back(RequestBatch::Member{std::to_string(i + 1), "method" + std::to_string(i + 1)});
+  return members;
+}
+
+void server_request_batch_tests()
+{
+  describe("RequestBatch", []()
+           {
+    it("should write the responses in batch order once all have completed", []() {
+      const std::string output = capture_responses([]() {
+        auto batch = std::make_shared<RequestBatch>(make_members(3), std::chrono::seconds(60));
+        Expect(batch->complete(2, {"{\"id\":3}"})).ToBe(true);
+        Expect(batch->complete(0, {"{\"id\":", "1}"})).ToBe(true);
+        Expect(batch->is_finished()).ToBe(false);
+        Expect(batch->complete(1, {"{\"id\":2}"})).ToBe(true);
+        Expect(batch->is_finished()).ToBe(true);
+      });
+      Expect(output).ToBe("[{\"id\":1},{\"id\":2},{\"id\":3}]\n");
+    });
+
+    it("should keep the first response of a member and drop responses after the batch is written", []() {
+      const std::string output = capture_responses([]() {
+        auto batch = std::make_shared<RequestBatch>(make_members(2), std::chrono::seconds(60));
+        Expect(batch->complete(0, {"first"})).ToBe(true);
+        Expect(batch->complete(0, {"second"})).ToBe(false);
+        Expect(batch->complete(1, {"last"})).ToBe(true);
+        Expect(batch->complete(1, {"late"})).ToBe(false);
+        Expect(batch->complete(5, {"unknown"})).ToBe(false);
+      });
+      Expect(output).ToBe("[first,last]\n");
+    });
+
+    it("should answer unanswered members with a timeout error once the deadline has passed", []() {
+      const std::string output = capture_responses([]() {
+        std::vector<RequestBatch::Member> members = make_members(2);
+        members.push_back(RequestBatch::Member{"null", "unknown"});
+        auto batch = std::make_shared<RequestBatch>(std::move(members), std::chrono::milliseconds(20));
+        batch->complete(1, {"{\"id\":2}"});
+        Expect(batch->expire(std::chrono::steady_clock::now())).ToBe(false);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        Expect(batch->expire(std::chrono::steady_clock::now())).ToBe(true);
+        Expect(batch->complete(0, {"{\"id\":1}"})).ToBe(false);
+      });
+      Expect(output.front()).ToBe('[');
+      Expect(output.substr(output.size() - 3)).ToBe("}]\n");
+      Expect(output).ToContain("\"code\":-32001");
+      Expect(output).ToContain("\"id\":null");
+
+      // The timeout errors take the place of the missing responses
+      const size_t first = output.find("\"message\":\"Batch timed out after 20 ms (method: method1)\"");
+      const size_t second = output.find(",{\"id\":2},");
+      const size_t third = output.find("(method: unknown)");
+      Expect(first != std::string::npos && first < second && second < third && third != std::string::npos).ToBe(true);
+    });
+
+    it("should echo the id of an unanswered member exactly as the client sent it", []() {
+      const std::string output = capture_responses([]() {
+        std::vector<RequestBatch::Member> members;
+        members.push_back(RequestBatch::Member{"\"req-1\"", "method1"});
+        members.push_back(RequestBatch::Member{"9007199254740993", "method2"});
+        auto batch = std::make_shared<RequestBatch>(std::move(members), std::chrono::milliseconds(0));
+        Expect(batch->expire(std::chrono::steady_clock::now())).ToBe(true);
+      });
+      Expect(output).ToContain("\"id\":\"req-1\"}");
+      Expect(output).ToContain("\"id\":9007199254740993}");
+    });
+
+    it("should answer invalid members in their slot and write once the others complete", []() {
+      const std::string output = capture_responses([]() {
+        std::vector<RequestBatch::Member> members = make_members(2);
+        members.insert(members.begin() + 1, RequestBatch::Member{"null", "", "Batch element must be a request object"});
+        auto batch = std::make_shared<RequestBatch>(std::move(members), std::chrono::seconds(60));
+        Expect(batch->write_if_answered()).ToBe(false);
+        Expect(batch->complete(1, {"taken"})).ToBe(false);
+        Expect(batch->complete(0, {"{\"id\":1}"})).ToBe(true);
+        Expect(batch->complete(2, {"{\"id\":2}"})).ToBe(true);
+        Expect(batch->is_finished()).ToBe(true);
+      });
+      Expect(output.find("[{\"id\":1},{\"jsonrpc\":\"2.0\",\"error\":{")).ToBe(static_cast<size_t>(0));
+      Expect(output).ToContain("\"code\":-32600");
+      Expect(output).ToContain("\"message\":\"Batch element must be a request object\"");
+      Expect(output.substr(output.find("},\"id\":null},"))).ToBe(std::string("},\"id\":null},{\"id\":2}]\n"));
+    });
+
+    it("should write a batch whose members were all answered when it was created", []() {
+      const std::string output = capture_responses([]() {
+        std::vector<RequestBatch::Member> members;
+        members.push_back(RequestBatch::Member{"null", "", "Batch element must be a request object"});
+        members.push_back(RequestBatch::Member{"\"a\"", "getInfo", "Request id must be an integer"});
+        auto batch = std::make_shared<RequestBatch>(std::move(members), std::chrono::seconds(60));
+        Expect(batch->write_if_answered()).ToBe(true);
+        Expect(batch->is_finished()).ToBe(true);
+      });
+      Expect(output.front()).ToBe('[');
+      Expect(output).ToContain("\"id\":null},{");
+      Expect(output).ToContain("\"id\":\"a\"}]");
+    });
+
+    it("should route responses to the batch member in scope on the current thread", []() {
+      const std::string output = capture_responses([]() {
+        auto batch = std::make_shared<RequestBatch>(make_members(2), std::chrono::seconds(60));
+        std::vector<std::string> response = {"outside"};
+        Expect(RequestBatch::complete_current(response)).ToBe(false);
+        {
+          RequestBatch::Scope none(nullptr, 0);
+          Expect(RequestBatch::in_scope()).ToBe(false);
+        }
+
+        std::thread other([batch]() {
+          RequestBatch::Scope scope(batch, 1);
+          std::vector<std::string> segments = {"b"};
+          RequestBatch::complete_current(segments);
+        });
+        other.join();
+
+        RequestBatch::Scope scope(batch, 0);
+        Expect(RequestBatch::in_scope()).ToBe(true);
+        response = {"a"};
+        Expect(RequestBatch::complete_current(response)).ToBe(true);
+      });
+      Expect(RequestBatch::in_scope()).ToBe(false);
+      Expect(output).ToBe("[a,b]\n");
+    }); });
+}
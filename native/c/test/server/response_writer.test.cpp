@@ -0,0 +1,135 @@
+/**
+ * This program and the accompanying materials are made available under the terms of the
+ * Eclipse Public License v2.0 which accompanies this distribution, and is available at
+ * https://www.eclipse.org/legal/epl-v20.html
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Copyright Contributors to the Zowe Project.
+ *
+ */
+
+#include "response_writer.test.hpp"
+#include "../ztest.hpp"
+#include "../../server/response_writer.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+using namespace ztst;
+
+/**
+ * @brief Pipe whose read end is drained on a background thread, so that the
+ * output thread never blocks on a full pipe while a test is still writing.
+ */
+struct CapturedOutput
+{
+  int fds[2] = {-1, -1};
+  std::string data;
+  std::thread reader;
+
+  CapturedOutput()
+  {
+    if (pipe(fds) != 0)
+      throw std::runtime_error("Failed to create pipe");
+
+    reader = std::thread([this]()
+                         {
+      char buffer[4096];
+      ssize_t n;
+      while ((n = read(fds[0], buffer, sizeof(buffer))) > 0)
+        data.append(buffer, static_cast<size_t>(n)); });
+  }
+
+  // Close the write end and return everything written to the pipe
+  const std::string &finish()
+  {
+    close(fds[1]);
+    reader.join();
+    close(fds[0]);
+    return data;
+  }
+};
+
+static std::vector<std::string> split_lines(const std::string &text)
+{
+  std::vector<std::string> lines;
+  size_t start = 0;
+  size_t end;
+  while ((end = text.find('\n', start)) != std::string::npos)
+  {
+    lines.push_back(text.substr(start, end - start));
+    start = end + 1;
+  }
+  return lines;
+}
+
+void server_response_writer_tests()
+{
+  describe("ResponseWriter", []()
+           {
+    ResponseWriter &writer = ResponseWriter::get_instance();
+
+    it("should keep each producer's lines in order on one channel", [&]() {
+      CapturedOutput output;
+      writer.start(output.fds[1], output.fds[1]);
+
+      const int producer_count = 4;
+      const int lines_per_producer = 500;
+      std::vector<std::thread> producers;
+      for (int p = 0; p < producer_count; p++)
+      {
+        producers.emplace_back([&writer, p]() {
+          for (int i = 0; i < lines_per_producer; i++)
+            writer.write_line(ResponseWriter::Output, std::to_string(p) + ":" + std::to_string(i));
+        });
+      }
+      for (auto &producer : producers)
+        producer.join();
+
+      writer.stop();
+      const auto lines = split_lines(output.finish());
+      Expect(lines.size()).ToBe(static_cast<size_t>(producer_count * lines_per_producer));
+
+      std::vector<int> next(producer_count, 0);
+      bool ordered = true;
+      for (const auto &line : lines)
+      {
+        const int p = std::stoi(line.substr(0, line.find(':')));
+        const int i = std::stoi(line.substr(line.find(':') + 1));
+        ordered = ordered && i == next[p];
+        next[p] = i + 1;
+      }
+      Expect(ordered).ToBe(true);
+    });
+
+    it("should interleave responses, errors and large lines in queue order", [&]() {
+      CapturedOutput output;
+      writer.start(output.fds[1], output.fds[1]);
+
+      const std::string large(200 * 1024, 'x');
+      writer.write_line(ResponseWriter::Output, "first");
+      writer.write_line(ResponseWriter::Error, "error");
+      writer.write_line(ResponseWriter::Output, large);
+      writer.write_line(ResponseWriter::Output, "last");
+
+      writer.stop();
+      Expect(output.finish()).ToBe("first\nerror\n" + large + "\nlast\n");
+    });
+
+    it("should write a line queued in pieces as one line", [&]() {
+      CapturedOutput output;
+      writer.start(output.fds[1], output.fds[1]);
+
+      const std::string large(300 * 1024, 'y');
+      std::vector<std::string> segments = {"{\"data\":\"", large, "\",\"size\":1}"};
+      writer.write_line(ResponseWriter::Output, "first");
+      writer.write_line(ResponseWriter::Output, std::move(segments));
+      writer.write_line(ResponseWriter::Output, std::vector<std::string>{"sm", "all"});
+
+      writer.stop();
+      Expect(output.finish()).ToBe("first\n{\"data\":\"" + large + "\",\"size\":1}\nsmall\n");
+    }); });
+}
@@ -15,6 +15,7 @@
 
 #include "../ztest.hpp"
 #include "../../server/validator.hpp"
+#include "../../extend/plugin.hpp"
 #include "../../zjson.hpp"
 #include <string>
 
@@ -30,6 +31,62 @@ static zjson::Value create_test_object(const std::string &json_str)
   return zjson::parse_json_string(json_str);
 }
 
+static ValidationResult validate_streaming(const std::string &json_str, const Schema &schema, bool allow_unknown_fields)
+{
+  zjson::Reader reader(json_str);
+  ObjectValidator object_validator(schema, allow_unknown_fields);
+  reader.read_object([&](const std::string &key)
+                     {
+                       std::string_view raw;
+                       if (!object_validator.check_member(key, reader, raw))
+                       {
+                         reader.skip_value();
+                       } });
+  reader.finish();
+  return object_validator.finish();
+}
+
+// Build the AST a command handler would produce for a parsed value
+static ast::Node to_ast(const zjson::Value &value)
+{
+  switch (value.get_type())
+  {
+  case zjson::Value::Bool:
+    return ast::boolean(value.as_bool());
+  case zjson::Value::Number:
+    return value.is_integer() ? ast::i64(value.as_int64()) : ast::num(value.as_double());
+  case zjson::Value::String:
+    return ast::str(value.as_string());
+  case zjson::Value::Array:
+  {
+    ast::Node array = ast::arr();
+    for (const auto &element : value.as_array())
+      array->push(to_ast(element));
+    return array;
+  }
+  case zjson::Value::Object:
+  {
+    ast::Node object = ast::obj();
+    for (const auto &member : value.as_object())
+      object->set(member.first, to_ast(member.second));
+    return object;
+  }
+  default:
+    return ast::nil();
+  }
+}
+
+static ValidationResult validate_ast(const std::string &json_str, const Schema &schema, bool allow_unknown_fields)
+{
+  const ast::Node object = to_ast(create_test_object(json_str));
+  ObjectValidator object_validator(schema, allow_unknown_fields);
+  for (const auto &member : object->as_object())
+  {
+    object_validator.check_member(member.first, member.second);
+  }
+  return object_validator.finish();
+}
+
 // ============================================================================
 // BASIC VALIDATION TESTS
 // ============================================================================
@@ -429,6 +486,101 @@ void test_error_cases()
         }); });
 }
 
+// ============================================================================
+// STREAMING VALIDATION TESTS
+// ============================================================================
+
+void test_streaming_validation()
+{
+  describe("Streaming Validation Tests", []()
+           {
+        it("should sort schema fields by name at compile time", []() {
+            static constexpr FieldDescriptor schema[] = {
+                FieldDescriptor("pattern", FieldType::TYPE_STRING, true),
+                FieldDescriptor("attributes", FieldType::TYPE_BOOL, false),
+                FieldDescriptor("maxItems", FieldType::TYPE_NUMBER, false)
+            };
+            static constexpr auto order = sort_fields(schema);
+
+            Expect(order[0]).ToBe(1);
+            Expect(order[1]).ToBe(2);
+            Expect(order[2]).ToBe(0);
+        });
+
+        it("should report the same errors as validate_schema", []() {
+            FieldDescriptor nested_schema[] = {
+                FieldDescriptor("host", FieldType::TYPE_STRING, true),
+                FieldDescriptor("port", FieldType::TYPE_NUMBER, false)
+            };
+            FieldDescriptor schema[] = {
+                FieldDescriptor("name", FieldType::TYPE_STRING, true),
+                FieldDescriptor("count", FieldType::TYPE_NUMBER, false),
+                FieldDescriptor("config", FieldType::TYPE_OBJECT, false, nested_schema, 2),
+                FieldDescriptor("servers", FieldType::TYPE_ARRAY, false, FieldType::TYPE_OBJECT, nested_schema, 2),
+                FieldDescriptor("tags", FieldType::TYPE_ARRAY, false, FieldType::TYPE_STRING)
+            };
+            const uint16_t order[] = {2, 1, 0, 3, 4};
+
+            const char *cases[] = {
+                R"({"name": "a"})",
+                R"({"count": 1})",
+                R"({"count": "x", "name": 1})",
+                R"({"name": "a", "count": null})",
+                R"({"name": null})",
+                R"({"name": "a", "config": {"port": 1}})",
+                R"({"name": "a", "config": {"host": "h", "extra": 1}})",
+                R"({"name": "a", "servers": [{"host": 1}, "skipped"]})",
+                R"({"name": "a", "tags": [1, "b"]})",
+                R"({"name": "a", "tags": []})",
+                R"({"name": "a", "extra": true})",
+                R"({"name": 1, "name": "a"})"
+            };
+
+            for (const char *json : cases)
+            {
+                for (bool allow_unknown : {true, false})
+                {
+                    auto expected = validate_schema(create_test_object(json), schema, 5, allow_unknown);
+                    auto linear = validate_streaming(json, Schema{schema, 5, nullptr}, allow_unknown);
+                    auto sorted = validate_streaming(json, Schema{schema, 5, order}, allow_unknown);
+                    auto from_ast = validate_ast(json, Schema{schema, 5, order}, allow_unknown);
+
+                    ExpectWithContext(linear.is_valid, json).ToBe(expected.is_valid);
+                    ExpectWithContext(linear.error_message, json).ToBe(expected.error_message);
+                    ExpectWithContext(sorted.error_message, json).ToBe(expected.error_message);
+                    ExpectWithContext(from_ast.error_message, json).ToBe(expected.error_message);
+                }
+            }
+        });
+
+        it("should return the raw text of arrays and objects it inspects", []() {
+            FieldDescriptor schema[] = {
+                FieldDescriptor("tags", FieldType::TYPE_ARRAY, true, FieldType::TYPE_STRING),
+                FieldDescriptor("name", FieldType::TYPE_STRING, true)
+            };
+
+            zjson::Reader reader(R"({"tags": ["a", "b"], "name": "n"})");
+            ObjectValidator object_validator(Schema{schema, 2, nullptr}, false);
+            std::string tags;
+            std::string name;
+            reader.read_object([&](const std::string &key)
+                               {
+                                 std::string_view raw;
+                                 if (object_validator.check_member(key, reader, raw))
+                                 {
+                                   tags = std::string(raw);
+                                 }
+                                 else
+                                 {
+                                   reader.read_string(name);
+                                 } });
+
+            Expect(object_validator.finish().is_valid).ToBe(true);
+            Expect(tags).ToBe(std::string(R"(["a", "b"])"));
+            Expect(name).ToBe(std::string("n"));
+        }); });
+}
+
 // ============================================================================
 // TEST RUNNER
 // ============================================================================
@@ -441,4 +593,5 @@ void server_validator_tests()
   test_array_validation();
   test_nested_validation();
   test_error_cases();
+  test_streaming_validation();
 }
\ No newline at end of file
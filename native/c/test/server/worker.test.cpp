@@ -13,16 +13,24 @@
 #include "../ztest.hpp"
 #include "../../server/worker.hpp"
 #include "../../server/logger.hpp"
+#include "../../server/request_batch.hpp"
+#include "../../server/response_writer.hpp"
 
+#include <algorithm>
+#include <map>
 #include <string>
 #include <stdexcept>
+#include <vector>
 #include <functional>
 #include <atomic>
 #include <mutex>
+#include <condition_variable>
 #include <cstdarg>
 #include <cstdio>
 #include <thread>
 #include <chrono>
+#include <fcntl.h>
+#include <unistd.h>
 
 using namespace ztst;
 
@@ -48,9 +56,16 @@ public:
   // Counts how many timeout errors have been sent to clients
   std::atomic<int> timeout_error_count{0};
 
+  // Requests with data starting "gated" are running but held at the gate
+  std::atomic<int> gated_count{0};
+
   // Stores the last request data received
   std::string last_processed_request;
-  std::mutex mtx; // Protects last_processed_request
+  // Completion time of each processed request, for latency measurements
+  std::map<std::string, std::chrono::steady_clock::time_point> completed_at;
+  // Processed requests in the order they completed
+  std::vector<std::string> completion_order;
+  std::mutex mtx; // Protects last_processed_request, completed_at and completion_order
 
   /**
    * @brief Get the singleton instance.
@@ -95,9 +110,36 @@ public:
       throw std::runtime_error("Simulated worker fault");
     }
 
-    // Default behavior (simulating normal work)
-    // Sleep for a short duration to make state transitions observable
-    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    // Hold the request until the test opens the gate, so that tests decide when it finishes
+    if (data.rfind("gated", 0) == 0)
+    {
+      std::unique_lock<std::mutex> lock(gate_mtx);
+      gated_count++;
+      gate_condition.wait(lock, [this]()
+                          { return gate_open; });
+      gated_count--;
+    }
+    // Simulate a long-running transfer
+    else if (data.rfind("slow", 0) == 0)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    }
+    else
+    {
+      // Default behavior (simulating normal work)
+      // Sleep for a short duration to make state transitions observable
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      completed_at[data] = std::chrono::steady_clock::now();
+      completion_order.push_back(data);
+    }
+
+    // Answer batch members into their batch, as the real server does when it queues a response
+    std::vector<std::string> response = {"\"" + data + "\""};
+    RequestBatch::complete_current(response);
     processed_count++;
   }
 
@@ -115,6 +157,37 @@ public:
     (void)request_data; // Suppress unused parameter warning
   }
 
+  /**
+   * @brief Hold "gated" requests until open_gate is called
+   */
+  void close_gate()
+  {
+    std::lock_guard<std::mutex> lock(gate_mtx);
+    gate_open = false;
+  }
+
+  /**
+   * @brief Let every held and future "gated" request finish
+   */
+  void open_gate()
+  {
+    {
+      std::lock_guard<std::mutex> lock(gate_mtx);
+      gate_open = true;
+    }
+    gate_condition.notify_all();
+  }
+
+  /**
+   * @brief Position of a request in the completion order, or -1 if it has not completed
+   */
+  int completion_index(const std::string &data)
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    const auto it = std::find(completion_order.begin(), completion_order.end(), data);
+    return it == completion_order.end() ? -1 : static_cast<int>(it - completion_order.begin());
+  }
+
   /**
    * @brief Resets the mock server's state.
    * Called before tests.
@@ -122,13 +195,20 @@ public:
   void reset()
   {
     hang_request.store(false);
+    open_gate();
     processed_count.store(0);
     timeout_error_count.store(0);
     std::lock_guard<std::mutex> lock(mtx);
     last_processed_request.clear();
+    completed_at.clear();
+    completion_order.clear();
   }
 
 private:
+  std::mutex gate_mtx;
+  std::condition_variable gate_condition;
+  bool gate_open = true; // Protected by gate_mtx
+
   // Private constructor/destructor for singleton
   RpcServer() = default;
   ~RpcServer() = default;
@@ -179,6 +259,7 @@ void server_worker_tests()
   afterEach([&]()
             {
     TestLog("Shutting down worker pool...");
+    server.open_gate();
     if (pool)
     {
       pool->shutdown();
@@ -253,6 +334,76 @@ void server_worker_tests()
       Expect(server.processed_count.load()).ToBe(1);
     });
 
+    it("should serve queued interactive requests before queued bulk requests", [&]() {
+      worker = std::make_shared<Worker>(0);
+      worker->start();
+
+      server.reset();
+      server.close_gate();
+      worker->add_request(RequestMetadata("gated1", 0, "", SchedulingClass::Bulk));
+      bool became_running = wait_for([&]() { return server.gated_count.load() == 1; }, 2000ms);
+      Expect(became_running).ToBe(true);
+
+      // Both requests queue behind gated1; the interactive one arrives last but runs first
+      worker->add_request(RequestMetadata("gated2", 0, "", SchedulingClass::Bulk));
+      worker->add_request(RequestMetadata("fast1", 0, "", SchedulingClass::Interactive));
+      Expect(worker->get_queue_depth()).ToBe(static_cast<size_t>(2));
+      Expect(worker->get_interactive_queue_depth()).ToBe(static_cast<size_t>(1));
+
+      server.open_gate();
+      bool all_processed = wait_for([&]() { return server.processed_count.load() == 3; }, 2000ms);
+      Expect(all_processed).ToBe(true);
+      Expect(server.completion_index("gated1")).ToBe(0);
+      Expect(server.completion_index("fast1")).ToBe(1);
+      Expect(server.completion_index("gated2")).ToBe(2);
+    });
+
+    it("should bound each lane and drain queued requests in order", [&]() {
+      // Not started, so nothing is consumed while the lanes fill up
+      worker = std::make_shared<Worker>(0);
+
+      size_t accepted = 0;
+      while (worker->add_request(RequestMetadata("req" + std::to_string(accepted))))
+        accepted++;
+      Expect(accepted).ToBe(static_cast<size_t>(256));
+      Expect(worker->get_queue_depth()).ToBe(accepted);
+
+      // The bulk lane has its own capacity
+      Expect(worker->add_request(RequestMetadata("bulk", 0, "", SchedulingClass::Bulk))).ToBe(true);
+
+      auto drained = worker->drain_pending_requests();
+      Expect(drained.size()).ToBe(accepted + 1);
+      Expect(drained.front().data).ToBe(std::string("req0"));
+      Expect(drained[accepted - 1].data).ToBe("req" + std::to_string(accepted - 1));
+      Expect(drained.back().data).ToBe(std::string("bulk"));
+      Expect(worker->get_queue_depth()).ToBe(static_cast<size_t>(0));
+    });
+
+    it("should signal a stop without waiting for the request in progress", [&]() {
+      worker = std::make_shared<Worker>(0);
+      worker->start();
+
+      server.reset();
+      server.close_gate();
+      worker->add_request(RequestMetadata("gated1"));
+      bool became_running = wait_for([&]() { return server.gated_count.load() == 1; }, 2000ms);
+      Expect(became_running).ToBe(true);
+
+      // Returns while the request is still held
+      worker->request_stop();
+      Expect(worker->is_stop_requested()).ToBe(true);
+      Expect(server.gated_count.load()).ToBe(1);
+
+      server.open_gate();
+      bool exited = wait_for([&]() { return worker->get_state() == WorkerState::Exited; }, 2000ms);
+      Expect(exited).ToBe(true);
+      Expect(server.processed_count.load()).ToBe(1);
+
+      // Joins the thread that already left its loop
+      worker->stop();
+      Expect(worker->get_state() == WorkerState::Exited).ToBe(true);
+    });
+
     it("should stop cleanly and transition to Exited state", [&]() {
       worker = std::make_shared<Worker>(0);
       worker->start();
@@ -299,6 +450,210 @@ void server_worker_tests()
       Expect(all_processed).ToBe(true);
       Expect(server.processed_count.load()).ToBe(3); });
 
+             it("should fan a batch out across workers and answer it once all requests complete", [&]()
+                {
+      long long num_workers = 4LL;
+      pool = std::make_shared<WorkerPool>(num_workers, 5000ms);
+
+      bool all_ready = wait_for([&]() { return pool->get_available_workers_count() == num_workers; }, 1000ms);
+      Expect(all_ready).ToBe(true);
+
+      server.reset();
+      const int null_fd = open("/dev/null", O_WRONLY);
+      ResponseWriter::get_instance().start(null_fd, null_fd);
+
+      // Each request is held at the gate, so all of them are held at once only if the batch runs in parallel
+      server.close_gate();
+      std::vector<std::string> requests;
+      for (int i = 0; i < num_workers; i++)
+        requests.push_back("gated" + std::to_string(i));
+      const std::vector<SchedulingClass> scheduling(requests.size(), SchedulingClass::Interactive);
+      auto batch = std::make_shared<RequestBatch>(std::vector<RequestBatch::Member>(requests.size()), 60s);
+
+      const auto start = std::chrono::steady_clock::now();
+      pool->distribute_batch(batch, requests, scheduling);
+      bool all_running = wait_for([&]() { return server.gated_count.load() == static_cast<int>(requests.size()); }, 3000ms);
+      Expect(all_running).ToBe(true);
+      Expect(batch->is_finished()).ToBe(false);
+
+      server.open_gate();
+      bool finished = wait_for([&]() { return batch->is_finished(); }, 3000ms);
+      const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+      ResponseWriter::get_instance().stop();
+      close(null_fd);
+
+      TestLog("Batch of " + std::to_string(requests.size()) + " held requests answered after " + std::to_string(elapsed) + " ms");
+      Expect(finished).ToBe(true);
+      Expect(server.processed_count.load()).ToBe(static_cast<int>(requests.size())); });
+
+             it("should answer a batch once its deadline passes, even with a request still running", [&]()
+                {
+      long long num_workers = 2LL;
+      pool = std::make_shared<WorkerPool>(num_workers, 5000ms);
+
+      bool all_ready = wait_for([&]() { return pool->get_available_workers_count() == num_workers; }, 1000ms);
+      Expect(all_ready).ToBe(true);
+
+      server.reset();
+      const int null_fd = open("/dev/null", O_WRONLY);
+      ResponseWriter::get_instance().start(null_fd, null_fd);
+
+      auto batch = std::make_shared<RequestBatch>(std::vector<RequestBatch::Member>(2), 200ms);
+      pool->distribute_batch(batch, {"fast", "hang"}, {SchedulingClass::Interactive, SchedulingClass::Interactive});
+
+      // The supervisor answers the batch; the hung request has not hit the request timeout
+      bool finished = wait_for([&]() { return batch->is_finished(); }, 2000ms);
+      Expect(finished).ToBe(true);
+      Expect(server.processed_count.load()).ToBe(1);
+      Expect(server.timeout_error_count.load()).ToBe(0);
+
+      server.hang_request.store(false);
+      bool hang_finished = wait_for([&]() { return server.processed_count.load() == 2; }, 1000ms);
+
+      ResponseWriter::get_instance().stop();
+      close(null_fd);
+      Expect(hang_finished).ToBe(true); });
+
+             it("should keep fast requests from queueing behind slow ones", [&]()
+                {
+      long long num_workers = 4LL;
+      pool = std::make_shared<WorkerPool>(num_workers, 5000ms);
+
+      bool all_ready = wait_for([&]() { return pool->get_available_workers_count() == num_workers; }, 1000ms);
+      Expect(all_ready).ToBe(true);
+
+      server.reset();
+
+      // Two transfers, held until the end, arrive just before a burst of fast metadata requests
+      server.close_gate();
+      const int fast_count = 20;
+      std::map<std::string, std::chrono::steady_clock::time_point> submitted_at;
+      std::vector<std::string> requests = {"gated1", "gated2"};
+      for (int i = 0; i < fast_count; i++)
+        requests.push_back("fast" + std::to_string(i));
+
+      for (const auto &request : requests)
+      {
+        submitted_at[request] = std::chrono::steady_clock::now();
+        pool->distribute_request(request);
+      }
+
+      // Every fast request completes while both transfers are still held, so none queued behind one
+      bool fast_processed = wait_for([&]() { return server.processed_count.load() == fast_count; }, 5000ms);
+      Expect(fast_processed).ToBe(true);
+      Expect(server.gated_count.load()).ToBe(2);
+
+      std::vector<long long> fast_latencies;
+      {
+        std::lock_guard<std::mutex> lock(server.mtx);
+        for (int i = 0; i < fast_count; i++)
+        {
+          const std::string request = "fast" + std::to_string(i);
+          const auto it = server.completed_at.find(request);
+          if (it != server.completed_at.end())
+            fast_latencies.push_back(std::chrono::duration_cast<std::chrono::milliseconds>(it->second - submitted_at[request]).count());
+        }
+      }
+      Expect(fast_latencies.size()).ToBe(static_cast<size_t>(fast_count));
+      std::sort(fast_latencies.begin(), fast_latencies.end());
+
+      const long long p50 = fast_latencies[fast_latencies.size() / 2];
+      const long long p99 = fast_latencies[(fast_latencies.size() * 99) / 100];
+      const long long max = fast_latencies.back();
+      TestLog("Fast request latency with 2 held requests on 4 workers: p50=" + std::to_string(p50) +
+              " ms, p99=" + std::to_string(p99) + " ms, max=" + std::to_string(max) + " ms");
+
+      server.open_gate();
+      bool all_processed = wait_for([&]() { return server.processed_count.load() == static_cast<int>(requests.size()); }, 2000ms);
+      Expect(all_processed).ToBe(true);
+      Expect(server.completion_index("gated1")).Not().ToBeLessThan(fast_count);
+      Expect(server.completion_index("gated2")).Not().ToBeLessThan(fast_count); });
+
+             it("should keep reserved workers free for interactive requests under bulk load", [&]()
+                {
+      long long num_workers = 3LL;
+      pool = std::make_shared<WorkerPool>(num_workers, 5000ms, 1LL);
+
+      bool all_ready = wait_for([&]() { return pool->get_available_workers_count() == num_workers; }, 1000ms);
+      Expect(all_ready).ToBe(true);
+
+      server.reset();
+
+      // Four held bulk transfers occupy the two unreserved workers and queue behind them
+      server.close_gate();
+      const auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < 4; i++)
+        pool->distribute_request("gated" + std::to_string(i), SchedulingClass::Bulk);
+      bool bulk_running = wait_for([&]() { return server.gated_count.load() == 2; }, 2000ms);
+      Expect(bulk_running).ToBe(true);
+
+      const int fast_count = 5;
+      std::map<std::string, std::chrono::steady_clock::time_point> submitted_at;
+      for (int i = 0; i < fast_count; i++)
+      {
+        const std::string request = "fast" + std::to_string(i);
+        submitted_at[request] = std::chrono::steady_clock::now();
+        pool->distribute_request(request, SchedulingClass::Interactive);
+      }
+
+      // Interactive requests never wait for a transfer, and no transfer ran on the reserved worker
+      bool fast_processed = wait_for([&]() { return server.processed_count.load() == fast_count; }, 5000ms);
+      Expect(fast_processed).ToBe(true);
+      Expect(server.gated_count.load()).ToBe(2);
+
+      server.open_gate();
+      bool all_processed = wait_for([&]() { return server.processed_count.load() == 4 + fast_count; }, 5000ms);
+      Expect(all_processed).ToBe(true);
+
+      std::lock_guard<std::mutex> lock(server.mtx);
+      long long max_fast = 0;
+      for (const auto &entry : submitted_at)
+        max_fast = std::max<long long>(max_fast, std::chrono::duration_cast<std::chrono::milliseconds>(server.completed_at[entry.first] - entry.second).count());
+      long long last_bulk = 0;
+      for (int i = 0; i < 4; i++)
+        last_bulk = std::max<long long>(last_bulk, std::chrono::duration_cast<std::chrono::milliseconds>(server.completed_at["gated" + std::to_string(i)] - start).count());
+      TestLog("Interactive latency under bulk load: max=" + std::to_string(max_fast) + " ms, last bulk completed after " + std::to_string(last_bulk) + " ms");
+
+      for (int i = 0; i < fast_count; i++)
+        Expect(server.completion_order[i].rfind("fast", 0)).ToBe(static_cast<size_t>(0)); });
+
+             it("should start workers under load and retire them once idle", [&]()
+                {
+      long long max_workers = 4LL;
+      pool = std::make_shared<WorkerPool>(max_workers, 5000ms, 0LL, 1LL, 300ms);
+
+      bool min_ready = wait_for([&]() { return pool->get_available_workers_count() == 1; }, 1000ms);
+      Expect(min_ready).ToBe(true);
+      Expect(pool->get_worker_count()).ToBe(static_cast<size_t>(1));
+
+      server.reset();
+
+      // Each request arriving while every worker holds one starts another worker, which takes it
+      server.close_gate();
+      const int request_count = 4;
+      for (int i = 0; i < request_count; i++)
+      {
+        pool->distribute_request("gated" + std::to_string(i));
+        bool started = wait_for([&]() { return server.gated_count.load() == i + 1; }, 2000ms);
+        Expect(started).ToBe(true);
+      }
+      Expect(pool->get_worker_count()).ToBe(static_cast<size_t>(max_workers));
+
+      server.open_gate();
+      bool all_processed = wait_for([&]() { return server.processed_count.load() == request_count; }, 2000ms);
+      Expect(all_processed).ToBe(true);
+
+      // The extra workers exit one per supervisor sweep after the idle timeout
+      bool scaled_down = wait_for([&]() { return pool->get_worker_count() == 1; }, 10000ms);
+      Expect(scaled_down).ToBe(true);
+      Expect(pool->get_available_workers_count()).ToBe(1);
+
+      // The shrunken pool still serves requests
+      pool->distribute_request("after_scale_down");
+      bool processed = wait_for([&]() { return server.processed_count.load() == request_count + 1; }, 1000ms);
+      Expect(processed).ToBe(true); });
+
              it("should replace a faulted worker and redistribute its requests", [&]()
                 {
       long long num_workers = 1LL;
@@ -0,0 +1,101 @@
+/**
+ * This program and the accompanying materials are made available under the terms of the
+ * Eclipse Public License v2.0 which accompanies this distribution, and is available at
+ * https://www.eclipse.org/legal/epl-v20.html
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Copyright Contributors to the Zowe Project.
+ *
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "ztest.hpp"
+#include "../zbase64.h"
+
+using namespace ztst;
+
+// Bytes pushed through each kernel per size, so that small inputs run long enough to time
+static const size_t BENCH_VOLUME = 64 * 1024 * 1024;
+
+static double megabytes_per_second(size_t bytes, std::chrono::steady_clock::duration elapsed)
+{
+  const double seconds = std::chrono::duration<double>(elapsed).count();
+  return seconds > 0 ? bytes / (1024.0 * 1024.0) / seconds : 0;
+}
+
+// Encode and decode `size` bytes repeatedly, logging throughput in MB/s of unencoded data
+static void run_benchmark(const std::string &label, size_t size)
+{
+  std::vector<char> input(size);
+  for (size_t i = 0; i < size; i++)
+  {
+    input[i] = static_cast<char>(i * 131 + 7);
+  }
+
+  // decode reads the EBCDIC alphabet, so build its input from the decode table
+  const unsigned char *decode_table = zbase64::get_ebcdic_decode_table();
+  char alphabet[64];
+  for (int c = 0; c < 256; c++)
+  {
+    if (decode_table[c] < 64)
+      alphabet[decode_table[c]] = static_cast<char>(c);
+  }
+  std::vector<char> encoded_input(size / 3 * 4);
+  for (size_t i = 0; i < encoded_input.size(); i++)
+  {
+    encoded_input[i] = alphabet[(i * 37) % 64];
+  }
+
+  const size_t iterations = size >= BENCH_VOLUME ? 1 : BENCH_VOLUME / size;
+  size_t checksum = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; i++)
+  {
+    checksum += zbase64::encode(input.data(), input.size()).size();
+  }
+  const double encode_rate = megabytes_per_second(size * iterations, std::chrono::steady_clock::now() - start);
+
+  start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; i++)
+  {
+    checksum += zbase64::decode(encoded_input.data(), encoded_input.size()).size();
+  }
+  const double decode_rate = megabytes_per_second(encoded_input.size() / 4 * 3 * iterations, std::chrono::steady_clock::now() - start);
+
+  char message[128];
+  snprintf(message, sizeof(message), "%s: encode %.1f MB/s, decode %.1f MB/s", label.c_str(), encode_rate, decode_rate);
+  TestLog(message);
+
+  Expect(checksum).ToBe(iterations * (zbase64::encoded_size(size) + encoded_input.size() / 4 * 3));
+}
+
+void zbase64_benchmarks()
+{
+  describe("zb64 throughput",
+           []() -> void
+           {
+             it("should report throughput for 1 KB inputs",
+                []() -> void
+                {
+                  run_benchmark("1 KB", 1024);
+                });
+
+             it("should report throughput for 64 KB inputs",
+                []() -> void
+                {
+                  run_benchmark("64 KB", 64 * 1024);
+                });
+
+             it("should report throughput for 64 MB inputs",
+                []() -> void
+                {
+                  run_benchmark("64 MB", 64 * 1024 * 1024);
+                });
+           });
+}
@@ -9,6 +9,7 @@
  *
  */
 
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
 #include <string>
@@ -30,6 +31,42 @@ std::string e2a_convert(const std::string &ebcdic_str)
   return ascii_str;
 }
 
+// Straightforward one-group-at-a-time encoder to check the block kernels against
+std::string reference_encode(const unsigned char *input, size_t input_len)
+{
+  std::string output;
+  for (size_t i = 0; i < input_len; i += 3)
+  {
+    const size_t remaining = input_len - i;
+    const unsigned int combined = (input[i] << 16) | (remaining > 1 ? input[i + 1] << 8 : 0) | (remaining > 2 ? input[i + 2] : 0);
+    output.push_back(zbase64::encode_table_ascii[(combined >> 18) & 0x3F]);
+    output.push_back(zbase64::encode_table_ascii[(combined >> 12) & 0x3F]);
+    output.push_back(remaining > 1 ? zbase64::encode_table_ascii[(combined >> 6) & 0x3F] : '=');
+    output.push_back(remaining > 2 ? zbase64::encode_table_ascii[combined & 0x3F] : '=');
+  }
+  return output;
+}
+
+// Map ASCII Base64 text onto the EBCDIC alphabet accepted by decode
+std::string to_ebcdic_base64(const std::string &ascii)
+{
+  const unsigned char *decode_table = zbase64::get_ebcdic_decode_table();
+  char ebcdic[64];
+  for (int c = 0; c < 256; c++)
+  {
+    if (decode_table[c] < 64)
+      ebcdic[decode_table[c]] = static_cast<char>(c);
+  }
+
+  std::string result;
+  for (char c : ascii)
+  {
+    const char *pos = static_cast<const char *>(std::memchr(zbase64::encode_table_ascii, c, 64));
+    result.push_back(pos ? ebcdic[pos - zbase64::encode_table_ascii] : static_cast<char>(126));
+  }
+  return result;
+}
+
 void zbase64_tests()
 {
   describe("zb64 encode tests",
@@ -461,4 +498,185 @@ void zbase64_tests()
                   }
                 });
            });
+
+  describe("zb64 block kernel tests",
+           []() -> void
+           {
+             it("should match the reference encoder for every length and alignment",
+                []() -> void
+                {
+                  std::vector<unsigned char> data(300);
+                  for (size_t i = 0; i < data.size(); i++)
+                  {
+                    data[i] = static_cast<unsigned char>(i * 167 + 13);
+                  }
+
+                  bool identical = true;
+                  for (size_t offset = 0; offset < 8; offset++)
+                  {
+                    for (size_t len = 0; len + offset <= data.size(); len++)
+                    {
+                      std::vector<char> result = zbase64::encode(reinterpret_cast<const char *>(&data[offset]), len);
+                      identical = identical && std::string(result.begin(), result.end()) == reference_encode(&data[offset], len);
+                    }
+                  }
+                  Expect(identical).ToBe(true);
+                });
+
+             it("should round-trip every length through the EBCDIC alphabet",
+                []() -> void
+                {
+                  std::vector<unsigned char> data(300);
+                  for (size_t i = 0; i < data.size(); i++)
+                  {
+                    data[i] = static_cast<unsigned char>(i * 61 + 7);
+                  }
+
+                  bool identical = true;
+                  for (size_t len = 0; len <= data.size(); len++)
+                  {
+                    const std::string encoded = to_ebcdic_base64(reference_encode(&data[0], len));
+                    std::vector<char> decoded = zbase64::decode(encoded.data(), encoded.size());
+                    identical = identical && decoded.size() == len && (len == 0 || std::memcmp(decoded.data(), &data[0], len) == 0);
+                  }
+                  Expect(identical).ToBe(true);
+                });
+
+             it("should reject an invalid character after a run of valid blocks",
+                []() -> void
+                {
+                  std::string input = "QUJDREVGR0hJSktMTU5PUFFSU1RV";
+                  input[21] = '$'; // $ is not valid base64
+                  try
+                  {
+                    zbase64::decode(input.data(), input.size());
+                    Expect(false).ToBe(true);
+                  }
+                  catch (const std::invalid_argument &)
+                  {
+                    Expect(true).ToBe(true);
+                  }
+                });
+
+             it("should end a group early at padding inside the input",
+                []() -> void
+                {
+                  // "Zg==" followed by "Zm9v" decodes to "f" then "foo", as before the block kernels
+                  const std::string input = "Zg==Zm9vZm9vYmFy";
+                  std::vector<char> decoded = zbase64::decode(input.data(), input.size());
+                  const char expected[] = {0x66, 0x66, 0x6F, 0x6F, 0x66, 0x6F, 0x6F, 0x62, 0x61, 0x72};
+                  Expect(decoded.size()).ToBe(sizeof(expected));
+                  Expect(std::memcmp(decoded.data(), expected, sizeof(expected))).ToBe(0);
+                });
+           });
+
+  describe("zb64 streaming tests",
+           []() -> void
+           {
+             it("should encode in chunks exactly as in one call",
+                []() -> void
+                {
+                  std::vector<char> data(1000);
+                  for (size_t i = 0; i < data.size(); i++)
+                  {
+                    data[i] = static_cast<char>(i * 89 + 3);
+                  }
+                  const std::vector<char> expected = zbase64::encode(data.data(), data.size());
+
+                  bool identical = true;
+                  for (size_t chunk_size = 1; chunk_size <= 10; chunk_size++)
+                  {
+                    zbase64::Encoder encoder;
+                    std::vector<char> buffer;
+                    std::string result;
+                    for (size_t pos = 0; pos < data.size(); pos += chunk_size)
+                    {
+                      const size_t len = std::min(chunk_size, data.size() - pos);
+                      const size_t written = encoder.update(&data[pos], len, buffer);
+                      result.append(buffer.data(), written);
+                    }
+                    char tail[4];
+                    result.append(tail, encoder.finish(tail));
+                    identical = identical && result == std::string(expected.begin(), expected.end());
+                  }
+                  Expect(identical).ToBe(true);
+                });
+
+             it("should map bytes in chunks exactly as encoding the mapped data",
+                []() -> void
+                {
+                  unsigned char byte_map[256];
+                  for (int i = 0; i < 256; i++)
+                  {
+                    byte_map[i] = static_cast<unsigned char>(255 - i);
+                  }
+                  std::vector<char> data(1000);
+                  std::vector<char> mapped(data.size());
+                  for (size_t i = 0; i < data.size(); i++)
+                  {
+                    data[i] = static_cast<char>(i * 89 + 3);
+                    mapped[i] = static_cast<char>(byte_map[static_cast<unsigned char>(data[i])]);
+                  }
+                  const std::vector<char> expected = zbase64::encode(mapped.data(), mapped.size());
+
+                  bool identical = true;
+                  for (size_t chunk_size = 1; chunk_size <= 20; chunk_size++)
+                  {
+                    zbase64::Encoder encoder;
+                    std::vector<char> buffer(zbase64::Encoder::max_output_size(chunk_size));
+                    std::string result;
+                    for (size_t pos = 0; pos < data.size(); pos += chunk_size)
+                    {
+                      const size_t len = std::min(chunk_size, data.size() - pos);
+                      result.append(buffer.data(), encoder.update_mapped(&data[pos], len, byte_map, buffer.data()));
+                    }
+                    char tail[4];
+                    result.append(tail, encoder.finish(tail));
+                    identical = identical && result == std::string(expected.begin(), expected.end());
+                  }
+                  Expect(identical).ToBe(true);
+                });
+
+             it("should decode in chunks exactly as in one call",
+                []() -> void
+                {
+                  // Many complete groups followed by a padded one
+                  std::string input;
+                  for (int i = 0; i < 60; i++)
+                  {
+                    input += "Zm9vYmFy";
+                  }
+                  input += "Zg==";
+                  const std::vector<char> expected = zbase64::decode(input.data(), input.size());
+
+                  bool identical = true;
+                  for (size_t chunk_size = 1; chunk_size <= 9; chunk_size++)
+                  {
+                    zbase64::Decoder decoder;
+                    std::vector<char> buffer;
+                    std::vector<char> result;
+                    for (size_t pos = 0; pos < input.size(); pos += chunk_size)
+                    {
+                      const size_t len = std::min(chunk_size, input.size() - pos);
+                      const size_t written = decoder.update(&input[pos], len, buffer);
+                      result.insert(result.end(), buffer.begin(), buffer.begin() + written);
+                    }
+                    identical = identical && result == expected && decoder.pending_size() == 0;
+                  }
+                  Expect(identical).ToBe(true);
+                });
+
+             it("should keep reusing the caller's buffer once it fits a chunk",
+                []() -> void
+                {
+                  std::vector<char> data(3000, 'x');
+                  zbase64::Encoder encoder;
+                  std::vector<char> buffer;
+                  encoder.update(data.data(), 1000, buffer);
+                  const char *storage = buffer.data();
+                  encoder.update(data.data() + 1000, 1000, buffer);
+                  encoder.update(data.data() + 2000, 1000, buffer);
+                  Expect(buffer.data() == storage).ToBe(true);
+                });
+           });
 }
@@ -0,0 +1,32 @@
+/**
+ * This program and the accompanying materials are made available under the terms of the
+ * Eclipse Public License v2.0 which accompanies this distribution, and is available at
+ * https://www.eclipse.org/legal/epl-v20.html
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Copyright Contributors to the Zowe Project.
+ *
+ */
+
+// Throughput benchmarks, kept out of ztest_runner so unit test runs stay short; run with `make bench`
+
+#include "zbase64.bench.hpp"
+#include "zut.bench.hpp"
+#include "ztest.hpp"
+
+using namespace ztst;
+
+#pragma runopts("TRAP(ON,NOSPIE)")
+int main(int argc, char *argv[])
+{
+  int rc = tests(
+      argc, argv,
+      []() -> void
+      {
+        zbase64_benchmarks();
+        zut_benchmarks();
+      });
+
+  return rc;
+}
@@ -156,6 +156,144 @@ void zjb_tests()
                   rc = zjb_delete(&zjb, correlator);
                   ExpectWithContext(rc, zjb.diag.e_msg).ToBe(RTNCD_SUCCESS); 
                 }); });
+
+  describe("JobDDCache", []() -> void
+           {
+             JobDDCache &cache = JobDDCache::get_instance();
+
+             // Job phases (STAT___ equates in iazssst.h)
+             const unsigned char executing = 253;      // stat___exec
+             const unsigned char awaiting_output = 20; // stat___outpt
+
+             const auto make_dds = [](const std::string &jobid, int count) -> std::vector<ZJobDD>
+             {
+               std::vector<ZJobDD> dds;
+               for (int i = 0; i < count; i++)
+               {
+                 ZJobDD dd{};
+                 dd.jobid = jobid;
+                 dd.ddn = "SYSPRINT";
+                 dd.dsn = "IBMUSER.IEFBR14$." + jobid + ".D000000" + std::to_string(i + 2) + ".SYSPRINT";
+                 dd.key = i + 2;
+                 dds.push_back(dd);
+               }
+               return dds;
+             };
+
+             beforeEach([]() -> void
+                        {
+                          JobDDCache &cache = JobDDCache::get_instance();
+                          cache.clear();
+                          cache.configure(JobDDCache::default_max_entries, JobDDCache::default_max_dds, JobDDCache::default_active_ttl, JobDDCache::default_complete_ttl);
+                        });
+
+             it("should serve the DDs of a finished job until they are invalidated", [&]() -> void
+                {
+                  const JobDDCache::Stats before = cache.get_stats();
+                  std::vector<ZJobDD> dds;
+                  unsigned char phase = 0;
+                  Expect(cache.get("JOB00123", dds, phase)).ToBe(false);
+
+                  cache.put("JOB00123", make_dds("JOB00123", 3), awaiting_output, true);
+                  Expect(cache.get("JOB00123", dds, phase)).ToBe(true);
+                  Expect(dds.size()).ToBe(static_cast<size_t>(3));
+                  Expect(dds[1].dsn).ToBe("IBMUSER.IEFBR14$.JOB00123.D0000003.SYSPRINT");
+                  Expect(static_cast<int>(phase)).ToBe(static_cast<int>(awaiting_output));
+
+                  cache.invalidate("JOB00123");
+                  Expect(cache.get("JOB00123", dds, phase)).ToBe(false);
+
+                  const JobDDCache::Stats after = cache.get_stats();
+                  Expect(after.hits - before.hits).ToBe(1ULL);
+                  Expect(after.misses - before.misses).ToBe(2ULL);
+                  Expect(after.invalidations - before.invalidations).ToBe(1ULL);
+                  Expect(after.entries).ToBe(static_cast<size_t>(0));
+                });
+
+             it("should drop the DDs of an active job after the active TTL", [&]() -> void
+                {
+                  cache.configure(JobDDCache::default_max_entries, JobDDCache::default_max_dds, std::chrono::milliseconds(20), JobDDCache::default_complete_ttl);
+                  cache.put("JOB00124", make_dds("JOB00124", 2), executing, false);
+                  cache.put("JOB00125", make_dds("JOB00125", 2), awaiting_output, true);
+
+                  std::vector<ZJobDD> dds;
+                  unsigned char phase = 0;
+                  Expect(cache.get("JOB00124", dds, phase)).ToBe(true);
+                  std::this_thread::sleep_for(std::chrono::milliseconds(40));
+
+                  const JobDDCache::Stats before = cache.get_stats();
+                  Expect(cache.get("JOB00124", dds, phase)).ToBe(false);
+                  Expect(cache.get("JOB00125", dds, phase)).ToBe(true);
+                  Expect(cache.get_stats().expirations - before.expirations).ToBe(1ULL);
+                });
+
+             it("should drop the DDs of a finished job after the complete TTL", [&]() -> void
+                {
+                  cache.configure(JobDDCache::default_max_entries, JobDDCache::default_max_dds, JobDDCache::default_active_ttl, std::chrono::milliseconds(20));
+                  cache.put("JOB00132", make_dds("JOB00132", 2), awaiting_output, true);
+
+                  std::vector<ZJobDD> dds;
+                  unsigned char phase = 0;
+                  Expect(cache.get("JOB00132", dds, phase)).ToBe(true);
+                  std::this_thread::sleep_for(std::chrono::milliseconds(40));
+
+                  const JobDDCache::Stats before = cache.get_stats();
+                  Expect(cache.get("JOB00132", dds, phase)).ToBe(false);
+                  Expect(cache.get_stats().expirations - before.expirations).ToBe(1ULL);
+                });
+
+             it("should look up jobs regardless of case and trailing blanks", [&]() -> void
+                {
+                  cache.put("job00126", make_dds("JOB00126", 1), awaiting_output, true);
+
+                  std::vector<ZJobDD> dds;
+                  unsigned char phase = 0;
+                  Expect(cache.get("JOB00126  ", dds, phase)).ToBe(true);
+                  cache.invalidate("Job00126");
+                  Expect(cache.get("JOB00126", dds, phase)).ToBe(false);
+                });
+
+             it("should look up a job by any form of its job id", [&]() -> void
+                {
+                  cache.put("J126", make_dds("J126", 1), awaiting_output, true);
+                  cache.put("STC00042", make_dds("STC00042", 1), awaiting_output, true);
+
+                  std::vector<ZJobDD> dds;
+                  unsigned char phase = 0;
+                  Expect(cache.get("JOB00126", dds, phase)).ToBe(true);
+                  Expect(cache.get("J0000126", dds, phase)).ToBe(true);
+                  Expect(cache.get("S42", dds, phase)).ToBe(true);
+                  Expect(cache.get("JOB00042", dds, phase)).ToBe(false);
+                  Expect(cache.get("TSU00126", dds, phase)).ToBe(false);
+
+                  cache.invalidate("JOB00126");
+                  Expect(cache.get("J126", dds, phase)).ToBe(false);
+                });
+
+             it("should evict the least recently used job to stay within its bounds", [&]() -> void
+                {
+                  cache.configure(2, 5, JobDDCache::default_active_ttl, JobDDCache::default_complete_ttl);
+                  cache.put("JOB00127", make_dds("JOB00127", 2), awaiting_output, true);
+                  cache.put("JOB00128", make_dds("JOB00128", 2), awaiting_output, true);
+
+                  std::vector<ZJobDD> dds;
+                  unsigned char phase = 0;
+                  Expect(cache.get("JOB00127", dds, phase)).ToBe(true);
+
+                  // Over the job bound: JOB00128 is the least recently used
+                  cache.put("JOB00129", make_dds("JOB00129", 2), awaiting_output, true);
+                  Expect(cache.get("JOB00128", dds, phase)).ToBe(false);
+                  Expect(cache.get("JOB00127", dds, phase)).ToBe(true);
+
+                  // Over the DD bound: both others are evicted to make room
+                  cache.put("JOB00130", make_dds("JOB00130", 4), awaiting_output, true);
+                  Expect(cache.get_stats().entries).ToBe(static_cast<size_t>(1));
+                  Expect(cache.get_stats().dds).ToBe(static_cast<size_t>(4));
+
+                  // More DDs than the bound are never cached
+                  cache.put("JOB00131", make_dds("JOB00131", 6), awaiting_output, true);
+                  Expect(cache.get("JOB00131", dds, phase)).ToBe(false);
+                }); });
 }
 
 void sleep_on_status(std::string status, std::string jobid)
@@ -429,6 +429,126 @@ void test_basic_api()
             Expect(error_msg.length() > 0).ToBe(true);
         });
 
+        it("should append JSON to a caller-supplied buffer or stream", []() {
+            zjson::Value obj = zjson::Value::create_object();
+            obj["list"] = zjson::Value::create_array();
+            obj["list"][0] = zjson::Value("a\"b");
+            obj["empty"] = zjson::Value::create_object();
+
+            std::string buffer = "prefix:";
+            auto written = zjson::write_to(buffer, obj);
+            Expect(written.has_value()).ToBe(true);
+            Expect(written.value()).ToBe(buffer.size() - 7);
+            Expect(buffer.substr(0, 7)).ToBe(std::string("prefix:"));
+
+            std::stringstream ss;
+            auto streamed = zjson::write_to(ss, obj);
+            Expect(streamed.has_value()).ToBe(true);
+            Expect(ss.str()).ToBe(buffer.substr(7));
+            Expect(ss.str().find(R"("a\"b")") != std::string::npos).ToBe(true);
+            Expect(ss.str().find(R"("empty":{})") != std::string::npos).ToBe(true);
+        });
+
+        it("should indent pretty output in a single pass", []() {
+            zjson::Value arr = zjson::Value::create_array();
+            arr[0] = zjson::Value(1);
+            arr[1] = zjson::Value::create_object();
+            arr[1]["k"] = zjson::Value(true);
+
+            auto pretty = zjson::to_string_pretty(arr);
+            Expect(pretty.has_value()).ToBe(true);
+            Expect(pretty.value()).ToBe(std::string("[\n  1,\n  {\n    \"k\": true\n  }\n]"));
+        });
+
+        it("should reject malformed JSON documents", []() {
+            const char *malformed[] = {"", "{", "[1,]", R"({"a":1,})", R"({"a" 1})", R"({"a":1} trailing)",
+                                       R"(["unterminated])", R"(["bad \q escape"])", "01", "-", "tru", "1.", "1e"};
+            for (const char *json : malformed)
+            {
+                auto result = zjson::from_str<zjson::Value>(json);
+                ExpectWithContext(result.has_value(), json).ToBe(false);
+            }
+        });
+
+        it("should report the position of parse errors", []() {
+            auto result = zjson::from_str<zjson::Value>("{\n  \"a\": tru\n}");
+            Expect(result.has_value()).ToBe(false);
+            Expect(result.error().line()).ToBe(2);
+            Expect(result.error().column()).ToBe(8);
+        });
+
+        it("should parse numbers, literals and escapes", []() {
+            auto result = zjson::from_str<zjson::Value>(R"({"i":-42,"d":2.5e1,"big":18446744073709551616,"t":true,"f":false,"n":null,"s":"a\"b\\c\ndA"})");
+            Expect(result.has_value()).ToBe(true);
+
+            const zjson::Value &root = result.value();
+            Expect(root["i"].as_int64()).ToBe(-42);
+            Expect(root["d"].as_double()).ToBe(25.0);
+            Expect(root["big"].is_double()).ToBe(true);
+            Expect(root["t"].as_bool()).ToBe(true);
+            Expect(root["f"].as_bool()).ToBe(false);
+            Expect(root["n"].is_null()).ToBe(true);
+            Expect(root["s"].as_string()).ToBe(std::string("a\"b\\c\ndA"));
+        });
+
+        it("should walk a document with the pull reader", []() {
+            zjson::Reader reader(R"({"name":"x","list":[1,2,3],"skip":{"a":[true,null]}})");
+            std::string name;
+            long long sum = 0;
+            std::string skipped;
+
+            reader.read_object([&](const std::string &key) {
+                if (key == "name")
+                {
+                    reader.read_string(name);
+                }
+                else if (key == "list")
+                {
+                    reader.read_array([&]() { sum += reader.read_value().as_int64(); });
+                }
+                else
+                {
+                    skipped = std::string(reader.skip_value());
+                }
+            });
+            reader.finish();
+
+            Expect(name).ToBe(std::string("x"));
+            Expect(sum).ToBe(6);
+            Expect(skipped).ToBe(std::string(R"({"a":[true,null]})"));
+        });
+
+        it("should find a member without reading the rest of the object", []() {
+            std::string method;
+            zjson::Reader reader(R"({"params":{"data":[1,{"x":"}"}]},"method":"readFile","id":)");
+            Expect(reader.find_member("method")).ToBe(true);
+            reader.read_string(method);
+            Expect(method).ToBe(std::string("readFile"));
+
+            zjson::Reader missing(R"({"id":1,"params":{"method":"x"}})");
+            Expect(missing.find_member("method")).ToBe(false);
+        });
+
+        it("should let a hook intercept members while decoding a struct", []() {
+            std::string raw_name;
+            auto result = zjson::from_str<SimpleStruct>(R"({"id":7,"name":{"first":"a"}})",
+                [&](const std::string &key, zjson::Reader &reader, SimpleStruct &partial) {
+                    if (key != "name")
+                    {
+                        return false;
+                    }
+                    raw_name = std::string(reader.skip_value());
+                    return true;
+                });
+            Expect(result.has_value()).ToBe(true);
+            Expect(result.value().id).ToBe(7);
+            Expect(raw_name).ToBe(std::string(R"({"first":"a"})"));
+
+            auto malformed = zjson::from_str<SimpleStruct>(R"({"id":"7","name":"n"} x)");
+            Expect(malformed.has_value()).ToBe(false);
+            Expect(std::string(malformed.error().what()).find("trailing") != std::string::npos).ToBe(true);
+        });
+
         it("should support chained access patterns", []() {
             // Test parsing and chained access together
             std::string json = R"({
@@ -171,6 +171,24 @@ void zlogger_tests()
             Expect(contents).ToContain("This should be logged");
         });
 
+        it("should not evaluate macro arguments below the log level", []() {
+            ZLogger& logger = ZLogger::get_instance();
+            logger.set_log_level(ZLOGLEVEL_WARN);
+
+            int evaluations = 0;
+            const auto argument = [&evaluations]() {
+                evaluations++;
+                return "macro argument";
+            };
+            ZLOG_TRACE("Skipped %s", argument());
+            ZLOG_DEBUG("Skipped %s", argument());
+            ZLOG_WARN("Logged %s", argument());
+
+            Expect(evaluations).ToBe(1);
+            Expect(logger.is_enabled(ZLOGLEVEL_DEBUG)).ToBe(false);
+            Expect(logger.is_enabled(ZLOGLEVEL_WARN)).ToBe(true);
+        });
+
         it("should handle variadic log function", []() {
             ZLogger& logger = ZLogger::get_instance();
             logger.set_log_level(ZLOGLEVEL_INFO);
@@ -269,6 +269,33 @@ void zowex_job_manage_tests(std::vector<std::string> &_jobs, std::vector<std::st
                   Expect(duplicate_response).ToBe(response);
                 });
 
+             it("should view all job files",
+                [&]()
+                {
+                  std::string response;
+                  int rc = execute_command_with_output(zowex_command + " job view-all-files " + _jobid, response);
+                  ExpectWithContext(rc, response).ToBe(0);
+                  Expect(response).ToContain("JESMSGLG (");
+                  Expect(response).ToContain("JESJCL (");
+                  Expect(response).ToContain("IEFBR14");
+
+                  std::string alias_response;
+                  rc = execute_command_with_output(zowex_command + " job vaf " + _jobid, alias_response);
+                  ExpectWithContext(rc, alias_response).ToBe(0);
+                  Expect(alias_response).ToBe(response);
+                });
+
+             it("should list the job files left out at --max-bytes",
+                [&]()
+                {
+                  std::string response;
+                  int rc = execute_command_with_output(zowex_command + " job view-all-files " + _jobid + " --max-bytes 1", response);
+                  ExpectWithContext(rc, response).ToBe(1);
+                  Expect(response).ToContain("max bytes reached");
+                  Expect(response).ToContain("JESMSGLG (");
+                  Expect(response).ToContain("not read, max bytes reached");
+                });
+
              it("should view job file with --encoding option",
                 [&]()
                 {
@@ -9,6 +9,7 @@
  *
  */
 
+#include <chrono>
 #include <stdexcept>
 #include <csignal>
 #include <unistd.h>
@@ -16,6 +17,8 @@
 #include <sys/stat.h>
 #include <fstream>
 #include <fcntl.h>
+#include <string>
+#include <vector>
 #include "ztest.hpp"
 #include "../ztype.h"
 #include "../commands/server.hpp"
@@ -61,6 +64,46 @@ std::string read_line_from_server(ServerHandle &handle, int timeout_ms = 5000)
   throw std::runtime_error("Failed to read from server");
 }
 
+/**
+ * Read whole lines straight from the server's output, however long they are. Only
+ * use once the stream has no buffered output left (e.g. after the ready message).
+ */
+std::vector<std::string> read_lines_from_server(ServerHandle &handle, size_t count, int timeout_ms = 10000)
+{
+  const int fd = fileno(handle.output_stream);
+  std::vector<std::string> lines;
+  std::string pending;
+  while (lines.size() < count)
+  {
+    fd_set read_fds;
+    FD_ZERO(&read_fds);
+    FD_SET(fd, &read_fds);
+    struct timeval timeout;
+    timeout.tv_sec = timeout_ms / 1000;
+    timeout.tv_usec = (timeout_ms % 1000) * 1000;
+    if (select(fd + 1, &read_fds, nullptr, nullptr, &timeout) <= 0)
+    {
+      throw std::runtime_error("Timeout waiting for server output");
+    }
+
+    char buffer[4096];
+    const ssize_t n = read(fd, buffer, sizeof(buffer));
+    if (n <= 0)
+    {
+      throw std::runtime_error("Failed to read from server");
+    }
+    pending.append(buffer, static_cast<size_t>(n));
+
+    size_t newline;
+    while ((newline = pending.find('\n')) != std::string::npos)
+    {
+      lines.push_back(pending.substr(0, newline));
+      pending.erase(0, newline + 1);
+    }
+  }
+  return lines;
+}
+
 void write_to_server(ServerHandle &handle, const std::string &input)
 {
   if (fputs(input.c_str(), handle.input_stream) == EOF || fflush(handle.input_stream) != 0)
@@ -139,6 +182,11 @@ void stop_server(ServerHandle &handle)
 const std::string zowex_dir = "./../build-out";
 const std::string zowex_server_command = zowex_dir + "/zowex server";
 
+static std::string get_info_request(int id)
+{
+  return "{\"jsonrpc\":\"2.0\",\"method\":\"getInfo\",\"params\":{},\"id\":" + std::to_string(id) + "}";
+}
+
 void zowex_server_tests()
 {
 
@@ -242,5 +290,174 @@ void zowex_server_tests()
 
                   Expect(buildDate.length()).ToBeGreaterThanOrEqualTo(11); // MMM DD YYYY at minimum
                 });
+
+             it("should list USS files with attributes",
+                []() -> void
+                {
+                  char dir_template[] = "/tmp/zowex_list_XXXXXX";
+                  const char *dir = mkdtemp(dir_template);
+                  Expect(dir != nullptr).ToBe(true);
+                  // A comma in the name must not split the entry
+                  const std::string file_path = std::string(dir) + "/a,b.txt";
+                  {
+                    std::ofstream file(file_path);
+                    file << "hello";
+                  }
+
+                  ServerHandle server = start_server(zowex_server_command, true);
+                  write_to_server(server, "{\"jsonrpc\":\"2.0\",\"method\":\"listFiles\",\"params\":{\"fspath\":\"" + std::string(dir) + "\",\"long\":true},\"id\":1}\n");
+                  std::string response = read_line_from_server(server);
+                  stop_server(server);
+                  unlink(file_path.c_str());
+                  rmdir(dir);
+
+                  Expect(response).ToContain("\"success\":true");
+                  Expect(response).ToContain("\"name\":\"a,b.txt\"");
+                  Expect(response).ToContain("\"size\":5");
+                  Expect(response).ToContain("\"returnedRows\":1");
+                });
+
+             it("should answer a batch request with one array of responses in request order",
+                []() -> void
+                {
+                  ServerHandle server = start_server(zowex_server_command, true);
+                  write_to_server(server, "[" + get_info_request(1) + ",{\"jsonrpc\":\"2.0\",\"method\":\"noSuchMethod\",\"id\":2}," + get_info_request(3) + "]\n");
+                  const std::vector<std::string> lines = read_lines_from_server(server, 1);
+                  stop_server(server);
+
+                  const std::string &response = lines[0];
+                  Expect(response.front()).ToBe('[');
+                  Expect(response.back()).ToBe(']');
+                  Expect(response).ToContain("\"code\":-32601");
+
+                  const size_t first = response.find("\"id\":1");
+                  const size_t second = response.find("\"id\":2");
+                  const size_t third = response.find("\"id\":3");
+                  Expect(first != std::string::npos && first < second && second < third && third != std::string::npos).ToBe(true);
+                });
+
+             it("should run notifications in a batch without answering them",
+                []() -> void
+                {
+                  char dir_template[] = "/tmp/zowex_notify_XXXXXX";
+                  const char *dir = mkdtemp(dir_template);
+                  Expect(dir != nullptr).ToBe(true);
+                  const std::string file_path = std::string(dir) + "/created.txt";
+                  const std::string notification = "{\"jsonrpc\":\"2.0\",\"method\":\"getInfo\"}";
+                  const std::string create_file = "{\"jsonrpc\":\"2.0\",\"method\":\"createFile\",\"params\":{\"fspath\":\"" + file_path + "\"}}";
+
+                  ServerHandle server = start_server(zowex_server_command, true);
+                  write_to_server(server, "[" + notification + "," + notification + "]\n");
+                  write_to_server(server, "[" + get_info_request(1) + "," + create_file + "," + get_info_request(2) + "]\n");
+                  const std::vector<std::string> lines = read_lines_from_server(server, 1);
+
+                  // The notification is not part of the batch, so it may still be running
+                  bool created = false;
+                  for (int attempt = 0; attempt < 50 && !created; attempt++)
+                  {
+                    created = access(file_path.c_str(), F_OK) == 0;
+                    if (!created)
+                      usleep(100 * 1000);
+                  }
+                  stop_server(server);
+                  unlink(file_path.c_str());
+                  rmdir(dir);
+
+                  // The first line answers the second batch, with one response per request
+                  const std::string &response = lines[0];
+                  Expect(response.front()).ToBe('[');
+                  Expect(response).ToContain("\"id\":1");
+                  Expect(response).ToContain("\"id\":2");
+                  Expect(response.find("\"id\":null")).ToBe(std::string::npos);
+                  Expect(response.find("createFile")).ToBe(std::string::npos);
+                  Expect(created).ToBe(true);
+                });
+
+             it("should answer elements that are not requests in their place in the batch",
+                []() -> void
+                {
+                  ServerHandle server = start_server(zowex_server_command, true);
+                  write_to_server(server, "[" + get_info_request(1) + ",5," + get_info_request(3) + "]\n");
+                  write_to_server(server, "[1,2]\n");
+                  const std::vector<std::string> lines = read_lines_from_server(server, 2);
+                  stop_server(server);
+
+                  const std::string &response = lines[0];
+                  const size_t first = response.find("\"id\":1");
+                  const size_t invalid = response.find("\"code\":-32600");
+                  const size_t third = response.find("\"id\":3");
+                  Expect(first != std::string::npos && first < invalid && invalid < third && third != std::string::npos).ToBe(true);
+                  Expect(response).ToContain("\"id\":null");
+
+                  // A batch of invalid elements only is still answered with one error per element
+                  Expect(lines[1].front()).ToBe('[');
+                  Expect(lines[1].find("-32600")).Not().ToBe(lines[1].rfind("-32600"));
+                });
+
+             it("should echo ids it cannot use exactly as they were sent",
+                []() -> void
+                {
+                  ServerHandle server = start_server(zowex_server_command, true);
+                  write_to_server(server, "[{\"jsonrpc\":\"2.0\",\"method\":\"getInfo\",\"id\":\"req-1\"},{\"jsonrpc\":\"2.0\",\"method\":\"getInfo\",\"id\":9007199254740993}]\n");
+                  const std::vector<std::string> lines = read_lines_from_server(server, 1);
+                  stop_server(server);
+
+                  Expect(lines[0]).ToContain("\"id\":\"req-1\"");
+                  Expect(lines[0]).ToContain("\"id\":9007199254740993");
+                });
+
+             it("should reject an empty batch and a batch over the size limit",
+                []() -> void
+                {
+                  ServerHandle server = start_server(zowex_server_command + " --max-batch-size 2", true);
+                  write_to_server(server, "[]\n");
+                  write_to_server(server, "[" + get_info_request(1) + "," + get_info_request(2) + "," + get_info_request(3) + "]\n");
+                  const std::vector<std::string> lines = read_lines_from_server(server, 2);
+                  stop_server(server);
+
+                  Expect(lines[0]).ToContain("\"code\":-32600");
+                  Expect(lines[1]).ToContain("\"code\":-32600");
+                  Expect(lines[1]).ToContain("Batch of 3 requests exceeds the limit of 2");
+                });
+
+             it("should report round-trip time for 100 single requests and one 100-request batch (benchmark)",
+                []() -> void
+                {
+                  const int request_count = 100;
+                  ServerHandle server = start_server(zowex_server_command, true);
+
+                  // Single requests: each waits for its response, as a client does for dependent calls
+                  auto start = std::chrono::steady_clock::now();
+                  for (int i = 1; i <= request_count; i++)
+                  {
+                    write_to_server(server, get_info_request(i) + "\n");
+                    read_lines_from_server(server, 1);
+                  }
+                  const auto single_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+                  // One batch: all requests share a single round-trip
+                  std::string batch = "[";
+                  for (int i = 1; i <= request_count; i++)
+                  {
+                    batch += (i > 1 ? "," : "") + get_info_request(i);
+                  }
+                  batch += "]\n";
+                  start = std::chrono::steady_clock::now();
+                  write_to_server(server, batch);
+                  const std::vector<std::string> lines = read_lines_from_server(server, 1);
+                  const auto batch_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+                  stop_server(server);
+
+                  TestLog(std::to_string(request_count) + " single requests: " + std::to_string(single_ms) + " ms, one batch of " +
+                          std::to_string(request_count) + ": " + std::to_string(batch_ms) + " ms");
+
+                  size_t successes = 0;
+                  for (size_t pos = 0; (pos = lines[0].find("\"success\":true", pos)) != std::string::npos; pos++)
+                  {
+                    successes++;
+                  }
+                  Expect(successes).ToBe(static_cast<size_t>(request_count));
+                  Expect(lines[0]).ToContain("\"id\":" + std::to_string(request_count) + "}]");
+                });
            });
 }
@@ -27,6 +27,13 @@
 #include "zowex.server.test.hpp"
 #include "server/worker.test.hpp"
 #include "server/validator.test.hpp"
+#include "server/response_writer.test.hpp"
+#include "server/logger.test.hpp"
+#include "server/arena.test.hpp"
+#include "server/ast_writer.test.hpp"
+#include "server/request_batch.test.hpp"
+#include "server/frame.test.hpp"
+#include "server/fifo_pool.test.hpp"
 #include "ztest.hpp"
 
 using namespace ztst;
@@ -56,6 +63,13 @@ int main(int argc, char *argv[])
         zowex_server_tests();
         server_worker_tests();
         server_validator_tests();
+        server_response_writer_tests();
+        server_logger_tests();
+        server_arena_tests();
+        server_ast_writer_tests();
+        server_request_batch_tests();
+        server_frame_tests();
+        server_fifo_pool_tests();
       });
 
   return rc;
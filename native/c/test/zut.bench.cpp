@@ -0,0 +1,140 @@
+/**
+ * This program and the accompanying materials are made available under the terms of the
+ * Eclipse Public License v2.0 which accompanies this distribution, and is available at
+ * https://www.eclipse.org/legal/epl-v20.html
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * Copyright Contributors to the Zowe Project.
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "ztest.hpp"
+#include "../zut.hpp"
+
+using namespace ztst;
+
+// Size of the source pushed through each read path
+static const size_t BENCH_VOLUME = 64 * 1024 * 1024;
+// Chunk size used by the streamed read handlers
+static const size_t BENCH_CHUNK_SIZE = 48 * 1024;
+
+static double megabytes_per_second(size_t bytes, std::chrono::steady_clock::duration elapsed)
+{
+  const double seconds = std::chrono::duration<double>(elapsed).count();
+  return seconds > 0 ? bytes / (1024.0 * 1024.0) / seconds : 0;
+}
+
+// Read path before the pipeline: each chunk is transcoded into a new buffer, encoded into a second one, then written
+static size_t read_with_separate_stages(const std::vector<char> &source, const IconvGuard *transcoder, FILE *sink)
+{
+  ZDIAG diag = {0};
+  zbase64::Encoder encoder;
+  std::vector<char> encoded;
+  size_t content_length = 0;
+  for (size_t offset = 0; offset < source.size(); offset += BENCH_CHUNK_SIZE)
+  {
+    const size_t chunk_len = std::min(BENCH_CHUNK_SIZE, source.size() - offset);
+    std::vector<char> transcoded;
+    const char *chunk = source.data() + offset;
+    size_t len = chunk_len;
+    if (transcoder != nullptr)
+    {
+      transcoded = zut_encode(chunk, chunk_len, *transcoder, diag);
+      chunk = transcoded.data();
+      len = transcoded.size();
+    }
+
+    content_length += len;
+    fwrite(encoded.data(), 1, encoder.update(chunk, len, encoded), sink);
+  }
+
+  char tail[4];
+  fwrite(tail, 1, encoder.finish(tail), sink);
+  return content_length;
+}
+
+static size_t read_with_pipeline(const std::vector<char> &source, const IconvGuard *transcoder, FILE *sink)
+{
+  Base64ReadPipeline pipeline(sink, transcoder);
+  for (size_t offset = 0; offset < source.size(); offset += BENCH_CHUNK_SIZE)
+  {
+    pipeline.write(source.data() + offset, std::min(BENCH_CHUNK_SIZE, source.size() - offset));
+  }
+  pipeline.flush_transcoder();
+  pipeline.finish();
+  return pipeline.content_length();
+}
+
+// Push the same source through both read paths, logging throughput in MB/s of source data
+static void run_benchmark(const std::string &label, const std::vector<char> &source, const char *from, const char *to)
+{
+  FILE *sink = fopen("/dev/null", "w");
+  Expect(sink != nullptr).ToBe(true);
+
+  IconvGuard transcoder(to, from);
+  const IconvGuard *stage = from != nullptr ? &transcoder : nullptr;
+
+  auto start = std::chrono::steady_clock::now();
+  const size_t separate_length = read_with_separate_stages(source, stage, sink);
+  const double separate_rate = megabytes_per_second(source.size(), std::chrono::steady_clock::now() - start);
+
+  start = std::chrono::steady_clock::now();
+  const size_t pipeline_length = read_with_pipeline(source, stage, sink);
+  const double pipeline_rate = megabytes_per_second(source.size(), std::chrono::steady_clock::now() - start);
+  fclose(sink);
+
+  char message[160];
+  snprintf(message, sizeof(message), "%s: separate stages %.1f MB/s, pipeline %.1f MB/s", label.c_str(), separate_rate, pipeline_rate);
+  TestLog(message);
+
+  Expect(pipeline_length).ToBe(separate_length);
+}
+
+void zut_benchmarks()
+{
+  describe("Base64ReadPipeline throughput",
+           []() -> void
+           {
+             it("should report throughput for binary data",
+                []() -> void
+                {
+                  std::vector<char> source(BENCH_VOLUME);
+                  for (size_t i = 0; i < source.size(); i++)
+                  {
+                    source[i] = static_cast<char>(i * 131 + 7);
+                  }
+                  run_benchmark("binary", source, nullptr, nullptr);
+                });
+
+             it("should report throughput for IBM-1047 text converted to ISO8859-1",
+                []() -> void
+                {
+                  const std::string line = "The quick brown fox jumps over the lazy dog 0123456789\n";
+                  std::vector<char> source(BENCH_VOLUME);
+                  for (size_t i = 0; i < source.size(); i++)
+                  {
+                    source[i] = line[i % line.size()];
+                  }
+                  run_benchmark("IBM-1047 -> ISO8859-1", source, "IBM-1047", "ISO8859-1");
+                });
+
+             it("should report throughput for IBM-1047 text converted to UTF-8",
+                []() -> void
+                {
+                  const std::string line = "The quick brown fox jumps over the lazy dog 0123456789\n";
+                  std::vector<char> source(BENCH_VOLUME);
+                  for (size_t i = 0; i < source.size(); i++)
+                  {
+                    source[i] = line[i % line.size()];
+                  }
+                  run_benchmark("IBM-1047 -> UTF-8", source, "IBM-1047", "UTF-8");
+                });
+           });
+}
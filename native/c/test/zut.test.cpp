@@ -9,8 +9,10 @@
  *
  */
 
+#include <algorithm>
 #include <cstdio>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <stdexcept>
 #include "ztest.hpp"
@@ -853,5 +855,265 @@ void zut_tests()
                              expect(roundtrip).ToBe(input_str);
                            });
                       });
+
+             describe("IconvCache",
+                      []() -> void
+                      {
+                        IconvCache &cache = IconvCache::get_instance();
+
+                        beforeEach([]() -> void
+                                   { IconvCache::get_instance().clear(); });
+
+                        it("should reuse a converter for repeated conversions of the same pair",
+                           [&]() -> void
+                           {
+                             ZDIAG diag = {0};
+                             const IconvCache::Stats before = cache.get_stats();
+
+                             // A pair without a codepage table, so that iconv is used
+                             zut_encode("Hello", "IBM-1047", "UCS-2", diag);
+                             zut_encode("World", "IBM-1047", "UCS-2", diag);
+
+                             const IconvCache::Stats after = cache.get_stats();
+                             expect(after.misses - before.misses).ToBe(1ULL);
+                             expect(after.hits - before.hits).ToBe(1ULL);
+                             expect(after.open).ToBe(static_cast<size_t>(1));
+                           });
+
+                        it("should reset a reused converter to its initial shift state",
+                           [&]() -> void
+                           {
+                             ZDIAG diag = {0};
+                             {
+                               // Leave the converter in its double-byte state by not flushing
+                               IconvGuard guard("IBM-939", "UTF-8");
+                               zut_encode(std::string("\xE3\x81\x82"), guard.get(), diag);
+                             }
+
+                             const std::string result = zut_encode(std::string("\x41"), "UTF-8", "IBM-939", diag);
+                             expect(diag.e_msg_len).ToBe(0);
+                             expect(result.size()).ToBe(static_cast<size_t>(1));
+                             expect(static_cast<unsigned char>(result[0])).ToBe(static_cast<unsigned char>(0xC1));
+                           });
+
+                        it("should keep at most its capacity of converters open",
+                           [&]() -> void
+                           {
+                             {
+                               std::vector<std::unique_ptr<IconvGuard>> guards;
+                               for (size_t i = 0; i <= IconvCache::capacity; i++)
+                               {
+                                 guards.emplace_back(new IconvGuard("ISO8859-1", "IBM-1047"));
+                               }
+                               expect(cache.get_stats().open).ToBe(IconvCache::capacity + 1);
+                             }
+                             expect(cache.get_stats().open).ToBe(IconvCache::capacity);
+
+                             // A new pair replaces the least recently returned idle converter
+                             const IconvCache::Stats before = cache.get_stats();
+                             {
+                               IconvGuard guard("IBM-1047", "ISO8859-1");
+                               expect(guard.is_valid()).ToBe(true);
+                             }
+                             const IconvCache::Stats after = cache.get_stats();
+                             expect(after.evictions - before.evictions).ToBe(1ULL);
+                             expect(after.open).ToBe(IconvCache::capacity);
+                           });
+                      });
+
+             describe("CodepageTableRegistry",
+                      []() -> void
+                      {
+                        // Convert with a descriptor of our own, bypassing the codepage tables
+                        const auto iconv_reference = [](const std::vector<char> &input, const char *from, const char *to) -> std::vector<char>
+                        {
+                          iconv_t cd = iconv_open(to, from);
+                          std::vector<char> output(input.size() * 4 + 16);
+                          char *in_ptr = const_cast<char *>(input.data());
+                          char *out_ptr = &output[0];
+                          size_t in_left = input.size();
+                          size_t out_left = output.size();
+                          iconv(cd, &in_ptr, &in_left, &out_ptr, &out_left);
+                          iconv(cd, nullptr, nullptr, &out_ptr, &out_left);
+                          iconv_close(cd);
+                          output.resize(out_ptr - &output[0]);
+                          return output;
+                        };
+
+                        std::vector<char> all_bytes(256);
+                        std::vector<char> ascii_bytes(128);
+                        for (int i = 0; i < 256; i++)
+                        {
+                          all_bytes[i] = static_cast<char>(i);
+                          if (i < 128)
+                            ascii_bytes[i] = static_cast<char>(i);
+                        }
+
+                        it("should match iconv for all 256 bytes of each single-byte pair",
+                           [&]() -> void
+                           {
+                             const char *pairs[][2] = {{"IBM-1047", "ISO8859-1"}, {"ISO8859-1", "IBM-1047"}, {"IBM-037", "ISO8859-1"},
+                                                       {"ISO8859-1", "IBM-037"}, {"IBM-037", "IBM-1047"}, {"IBM-1047", "UTF-8"},
+                                                       {"IBM-037", "UTF-8"}, {"1047", "819"}};
+                             for (const auto &pair : pairs)
+                             {
+                               ZDIAG diag = {0};
+                               expect(CodepageTableRegistry::get_instance().find(pair[1], pair[0]) != nullptr).ToBe(true);
+                               const std::vector<char> result = zut_encode(all_bytes.data(), all_bytes.size(), pair[0], pair[1], diag);
+                               expect(result == iconv_reference(all_bytes, pair[0], pair[1])).ToBe(true);
+                             }
+                           });
+
+                        it("should match iconv for all ASCII bytes from UTF-8",
+                           [&]() -> void
+                           {
+                             for (const char *to : {"IBM-1047", "IBM-037", "ISO8859-1"})
+                             {
+                               ZDIAG diag = {0};
+                               expect(CodepageTableRegistry::get_instance().find(to, "UTF-8") != nullptr).ToBe(true);
+                               const std::vector<char> result = zut_encode(ascii_bytes.data(), ascii_bytes.size(), "UTF-8", to, diag);
+                               expect(result == iconv_reference(ascii_bytes, "UTF-8", to)).ToBe(true);
+                             }
+                           });
+
+                        it("should round-trip all 256 bytes through each pair",
+                           [&]() -> void
+                           {
+                             const char *pairs[][2] = {{"IBM-1047", "ISO8859-1"}, {"IBM-037", "ISO8859-1"}, {"IBM-1047", "IBM-037"}, {"IBM-1047", "UTF-8"}};
+                             for (const auto &pair : pairs)
+                             {
+                               ZDIAG diag = {0};
+                               // Non-ASCII UTF-8 goes back through iconv
+                               const std::vector<char> there = zut_encode(all_bytes.data(), all_bytes.size(), pair[0], pair[1], diag);
+                               const std::vector<char> back = zut_encode(there.data(), there.size(), pair[1], pair[0], diag);
+                               expect(back == all_bytes).ToBe(true);
+                             }
+                           });
+
+                        it("should convert through a leased descriptor with the same result",
+                           [&]() -> void
+                           {
+                             ZDIAG diag = {0};
+                             IconvGuard guard("ISO8859-1", "IBM-1047");
+                             expect(guard.table() != nullptr).ToBe(true);
+                             const std::vector<char> result = zut_encode(all_bytes.data(), all_bytes.size(), guard, diag);
+                             expect(result == iconv_reference(all_bytes, "IBM-1047", "ISO8859-1")).ToBe(true);
+                           });
+
+                        it("should leave DBCS and stateful codepages to iconv",
+                           []() -> void
+                           {
+                             expect(CodepageTableRegistry::get_instance().find("IBM-939", "UTF-8") == nullptr).ToBe(true);
+                             expect(CodepageTableRegistry::get_instance().find("UTF-8", "IBM-939") == nullptr).ToBe(true);
+                             expect(CodepageTableRegistry::get_instance().find("UCS-2", "IBM-1047") == nullptr).ToBe(true);
+                           });
+                      });
+
+             describe("Base64ReadPipeline",
+                      []() -> void
+                      {
+                        // Push `input` through a pipeline in chunks of `chunk_size` and return the Base64 text it wrote
+                        const auto run_pipeline = [](const std::vector<char> &input, size_t chunk_size, const IconvGuard *transcoder, size_t &content_length) -> std::vector<char>
+                        {
+                          FILE *sink = tmpfile();
+                          Base64ReadPipeline pipeline(sink, transcoder);
+                          for (size_t offset = 0; offset < input.size(); offset += chunk_size)
+                          {
+                            pipeline.write(input.data() + offset, std::min(chunk_size, input.size() - offset));
+                          }
+                          pipeline.flush_transcoder();
+                          pipeline.finish();
+                          content_length = pipeline.content_length();
+
+                          std::vector<char> output(ftell(sink));
+                          rewind(sink);
+                          output.resize(fread(output.data(), 1, output.size(), sink));
+                          fclose(sink);
+                          return output;
+                        };
+
+                        std::vector<char> input(100 * 1024 + 7);
+                        for (size_t i = 0; i < input.size(); i++)
+                        {
+                          input[i] = static_cast<char>(i * 131 + 7);
+                        }
+
+                        it("should encode bytes as they are without a transcoder",
+                           [&]() -> void
+                           {
+                             for (size_t chunk_size : {1, 1000, 48 * 1024, 200 * 1024})
+                             {
+                               size_t content_length = 0;
+                               const std::vector<char> output = run_pipeline(input, chunk_size, nullptr, content_length);
+                               expect(output == zbase64::encode(input.data(), input.size())).ToBe(true);
+                               expect(content_length).ToBe(input.size());
+                             }
+                           });
+
+                        it("should match zut_encode when the pair has a codepage table",
+                           [&]() -> void
+                           {
+                             ZDIAG diag = {0};
+                             IconvGuard guard("UTF-8", "IBM-1047");
+                             expect(guard.table() != nullptr).ToBe(true);
+                             const std::vector<char> expected = zut_encode(input.data(), input.size(), "IBM-1047", "UTF-8", diag);
+
+                             size_t content_length = 0;
+                             const std::vector<char> output = run_pipeline(input, 48 * 1024, &guard, content_length);
+                             expect(output == zbase64::encode(expected.data(), expected.size())).ToBe(true);
+                             expect(content_length).ToBe(expected.size());
+                           });
+
+                        it("should match zut_encode when the pair has a single-byte codepage table",
+                           [&]() -> void
+                           {
+                             ZDIAG diag = {0};
+                             IconvGuard guard("ISO8859-1", "IBM-1047");
+                             expect(guard.table() != nullptr && guard.table()->byte_map() != nullptr).ToBe(true);
+                             const std::vector<char> expected = zut_encode(input.data(), input.size(), "IBM-1047", "ISO8859-1", diag);
+
+                             for (size_t chunk_size : {1000, 48 * 1024})
+                             {
+                               size_t content_length = 0;
+                               const std::vector<char> output = run_pipeline(input, chunk_size, &guard, content_length);
+                               expect(output == zbase64::encode(expected.data(), expected.size())).ToBe(true);
+                               expect(content_length).ToBe(expected.size());
+                             }
+                           });
+
+                        it("should match zut_encode when the pair is converted by iconv",
+                           [&]() -> void
+                           {
+                             ZDIAG diag = {0};
+                             IconvGuard guard("UCS-2", "IBM-1047");
+                             expect(guard.table() == nullptr).ToBe(true);
+                             const std::vector<char> expected = zut_encode(input.data(), input.size(), "IBM-1047", "UCS-2", diag);
+
+                             size_t content_length = 0;
+                             const std::vector<char> output = run_pipeline(input, 48 * 1024, &guard, content_length);
+                             expect(output == zbase64::encode(expected.data(), expected.size())).ToBe(true);
+                             expect(content_length).ToBe(expected.size());
+                           });
+
+                        it("should throw when a chunk cannot be converted",
+                           []() -> void
+                           {
+                             IconvGuard guard("IBM-1047", "UTF-8");
+                             FILE *sink = tmpfile();
+                             Base64ReadPipeline pipeline(sink, &guard);
+                             const char invalid[] = {'\xC3', '\x28'};
+                             bool threw = false;
+                             try
+                             {
+                               pipeline.write(invalid, sizeof(invalid));
+                             }
+                             catch (const std::exception &e)
+                             {
+                               threw = true;
+                             }
+                             fclose(sink);
+                             expect(threw).ToBe(true);
+                           });
+                      });
            });
 }
@@ -79,5 +79,5 @@ LOG_FLAGS=-DZLOG_ENABLE
 DEBUGGER_FLAGS=-g
 OTHER_C_FLAGS=-H -dM
 .ELSIF $(BuildType) == RELEASE
-RELEASE_FLAGS=-g0 -O2
+RELEASE_FLAGS=-g0 -O2 -DNDEBUG
 .END
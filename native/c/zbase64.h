@@ -12,6 +12,8 @@
 #ifndef ZBASE64_H
 #define ZBASE64_H
 
+#include <cstdint>
+#include <cstring>
 #include <string>
 #include <vector>
 #include <stdexcept>
@@ -97,79 +99,105 @@ static const unsigned char *get_ebcdic_decode_table()
   return table;
 }
 
-// Fast inline function to calculate encoded size
-inline size_t encoded_size(size_t input_size)
+// Every 12-bit value mapped to its two Base64 characters, so that each 3-byte group
+// is encoded with two lookups instead of four
+struct EncodePairTable
 {
-  return (input_size + 2) / 3 * 4;
-}
+  char pairs[4096][2];
 
-// Fast inline function to calculate maximum decoded size
-inline size_t max_decoded_size(size_t input_size)
-{
-  return (input_size / 4) * 3;
-}
+  EncodePairTable()
+  {
+    for (int i = 0; i < 4096; ++i)
+    {
+      pairs[i][0] = encode_table_ascii[i >> 6];
+      pairs[i][1] = encode_table_ascii[i & 0x3F];
+    }
+  }
+};
 
-inline size_t load_leftover(const char *input, size_t input_len, std::vector<char> &left_over, std::vector<char> &temp_storage)
+inline const EncodePairTable &get_encode_pair_table()
 {
-  // Handle leftover data combination
-  size_t total_size = left_over.size() + input_len;
-  temp_storage.resize(total_size);
-
-  std::memcpy(&temp_storage[0], &left_over[0], left_over.size());
-  std::memcpy(&temp_storage[0] + left_over.size(), input, input_len);
-
-  left_over.clear();
-  return total_size;
+  static const EncodePairTable table;
+  return table;
 }
 
-inline size_t store_leftover(const char *combined_input, size_t input_len, std::vector<char> *left_over, int byte_multiple)
+// Set in a decoded group when any of its characters is invalid or padding
+static const uint32_t decode_invalid = 0x01000000;
+
+// The EBCDIC decode table with each character's 6 bits already shifted into place for
+// positions 0-3 of a group, so that a group decodes with four lookups and three ORs
+struct DecodeShiftTables
 {
-  // Calculate how many bytes are leftover
-  size_t extra_count = input_len % byte_multiple;
-  size_t total_size = input_len - extra_count;
+  uint32_t shifted[4][256];
 
-  // Copy leftover bytes to be processed later
-  if (left_over != nullptr && extra_count > 0)
+  DecodeShiftTables(const unsigned char *decode_table)
   {
-    left_over->resize(extra_count);
-    std::memcpy(&(*left_over)[0], combined_input + total_size, extra_count);
+    for (int c = 0; c < 256; ++c)
+    {
+      const unsigned char value = decode_table[c];
+      for (int position = 0; position < 4; ++position)
+      {
+        shifted[position][c] = (value & 0x80) ? decode_invalid : static_cast<uint32_t>(value) << (18 - 6 * position);
+      }
+    }
   }
+};
 
-  return total_size;
+inline const DecodeShiftTables &get_decode_shift_tables()
+{
+  static const DecodeShiftTables tables(get_ebcdic_decode_table());
+  return tables;
 }
 
-// High-performance encode function (produces ASCII Base64 output)
-inline std::vector<char> encode(const char *input, size_t input_len)
+// Load 8 bytes as a big-endian 64-bit word
+inline uint64_t load_be64(const unsigned char *src)
 {
-  if (input_len == 0)
-  {
-    return std::vector<char>();
-  }
+  uint64_t word;
+  std::memcpy(&word, src, sizeof(word));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  word = __builtin_bswap64(word);
+#endif
+  return word;
+}
 
-  const size_t output_len = encoded_size(input_len);
+// Fast inline function to calculate encoded size
+inline size_t encoded_size(size_t input_size)
+{
+  return (input_size + 2) / 3 * 4;
+}
 
-  std::vector<char> output;
-  output.resize(output_len); // Pre-allocate exact size
-  char *dst = &output[0];    // Direct pointer to output buffer
+// Fast inline function to calculate maximum decoded size
+inline size_t max_decoded_size(size_t input_size)
+{
+  return (input_size / 4) * 3;
+}
 
+// Encode input into output as ASCII Base64, which needs room for encoded_size(input_len)
+// characters; returns the number of characters written
+inline size_t encode_into(const char *input, size_t input_len, char *output)
+{
+  char *dst = output;
   const unsigned char *src = reinterpret_cast<const unsigned char *>(input);
   const size_t full_blocks = input_len / 3;
+  const char(*pairs)[2] = get_encode_pair_table().pairs;
 
-  // Process blocks of 12 bytes (4 x 3-byte groups) at a time
+  // Process 12 bytes (4 x 3-byte groups) at a time from two 64-bit loads, using the top
+  // 48 bits of each; the loads may look ahead 2 bytes, so stop 2 bytes short of the end
   size_t i = 0;
-  for (; i + 4 <= full_blocks; i += 4)
+  for (; (i + 4) * 3 + 2 <= input_len; i += 4)
   {
-    for (size_t j = 0; j < 4; j++)
-    {
-      const unsigned char *block = src + (i + j) * 3;
-      const unsigned int combined = (block[0] << 16) | (block[1] << 8) | block[2];
-
-      dst[0] = encode_table_ascii[(combined >> 18) & 0x3F];
-      dst[1] = encode_table_ascii[(combined >> 12) & 0x3F];
-      dst[2] = encode_table_ascii[(combined >> 6) & 0x3F];
-      dst[3] = encode_table_ascii[combined & 0x3F];
-      dst += 4;
-    }
+    const uint64_t first = load_be64(src + i * 3);
+    const uint64_t second = load_be64(src + i * 3 + 6);
+
+    std::memcpy(dst, pairs[(first >> 52) & 0xFFF], 2);
+    std::memcpy(dst + 2, pairs[(first >> 40) & 0xFFF], 2);
+    std::memcpy(dst + 4, pairs[(first >> 28) & 0xFFF], 2);
+    std::memcpy(dst + 6, pairs[(first >> 16) & 0xFFF], 2);
+    std::memcpy(dst + 8, pairs[(second >> 52) & 0xFFF], 2);
+    std::memcpy(dst + 10, pairs[(second >> 40) & 0xFFF], 2);
+    std::memcpy(dst + 12, pairs[(second >> 28) & 0xFFF], 2);
+    std::memcpy(dst + 14, pairs[(second >> 16) & 0xFFF], 2);
+    dst += 16;
   }
 
   // Process remaining full blocks
@@ -178,10 +206,8 @@ inline std::vector<char> encode(const char *input, size_t input_len)
     const unsigned char *block = src + i * 3;
     const unsigned int combined = (block[0] << 16) | (block[1] << 8) | block[2];
 
-    dst[0] = encode_table_ascii[(combined >> 18) & 0x3F];
-    dst[1] = encode_table_ascii[(combined >> 12) & 0x3F];
-    dst[2] = encode_table_ascii[(combined >> 6) & 0x3F];
-    dst[3] = encode_table_ascii[combined & 0x3F];
+    std::memcpy(dst, pairs[combined >> 12], 2);
+    std::memcpy(dst + 2, pairs[combined & 0xFFF], 2);
     dst += 4;
   }
 
@@ -199,74 +225,121 @@ inline std::vector<char> encode(const char *input, size_t input_len)
     dst[1] = encode_table_ascii[(combined >> 12) & 0x3F];
     dst[2] = (remaining > 1) ? encode_table_ascii[(combined >> 6) & 0x3F] : '=';
     dst[3] = '=';
+    dst += 4;
   }
 
-  return output;
+  return dst - output;
 }
 
-inline std::vector<char> encode(const char *input, size_t input_len, std::vector<char> *left_over)
+// Map each input byte through byte_map and encode the result as ASCII Base64 in the same
+// pass, so a single-byte transcode needs no intermediate buffer; output needs room for
+// encoded_size(input_len) characters. Returns the number of characters written.
+inline size_t encode_mapped_into(const char *input, size_t input_len, const unsigned char *byte_map, char *output)
 {
-  // Prepend leftover data to input string
-  const char *combined_input = input;
-  std::vector<char> temp_combined;
-  if (left_over != nullptr && !left_over->empty())
+  char *dst = output;
+  const unsigned char *src = reinterpret_cast<const unsigned char *>(input);
+  const size_t full_blocks = input_len / 3;
+  const char(*pairs)[2] = get_encode_pair_table().pairs;
+
+  // Process 4 groups at a time; the lookups are independent, so the loads can overlap
+  size_t i = 0;
+  for (; i + 4 <= full_blocks; i += 4)
   {
-    input_len = load_leftover(input, input_len, *left_over, temp_combined);
-    combined_input = &temp_combined[0];
+    const unsigned char *block = src + i * 3;
+    const unsigned int first = (byte_map[block[0]] << 16) | (byte_map[block[1]] << 8) | byte_map[block[2]];
+    const unsigned int second = (byte_map[block[3]] << 16) | (byte_map[block[4]] << 8) | byte_map[block[5]];
+    const unsigned int third = (byte_map[block[6]] << 16) | (byte_map[block[7]] << 8) | byte_map[block[8]];
+    const unsigned int fourth = (byte_map[block[9]] << 16) | (byte_map[block[10]] << 8) | byte_map[block[11]];
+
+    std::memcpy(dst, pairs[first >> 12], 2);
+    std::memcpy(dst + 2, pairs[first & 0xFFF], 2);
+    std::memcpy(dst + 4, pairs[second >> 12], 2);
+    std::memcpy(dst + 6, pairs[second & 0xFFF], 2);
+    std::memcpy(dst + 8, pairs[third >> 12], 2);
+    std::memcpy(dst + 10, pairs[third & 0xFFF], 2);
+    std::memcpy(dst + 12, pairs[fourth >> 12], 2);
+    std::memcpy(dst + 14, pairs[fourth & 0xFFF], 2);
+    dst += 16;
   }
-  else if (input_len == 0)
+
+  for (; i < full_blocks; i++)
   {
-    return temp_combined;
+    const unsigned char *block = src + i * 3;
+    const unsigned int combined = (byte_map[block[0]] << 16) | (byte_map[block[1]] << 8) | byte_map[block[2]];
+
+    std::memcpy(dst, pairs[combined >> 12], 2);
+    std::memcpy(dst + 2, pairs[combined & 0xFFF], 2);
+    dst += 4;
   }
 
-  // Encode only the complete part (multiple of 3 bytes)
-  input_len = store_leftover(combined_input, input_len, left_over, 3);
-  return encode(combined_input, input_len);
-}
+  // Map the remaining 0-2 bytes and let encode_into pad them
+  char tail[2];
+  const size_t remaining = input_len - full_blocks * 3;
+  for (size_t j = 0; j < remaining; j++)
+  {
+    tail[j] = static_cast<char>(byte_map[src[full_blocks * 3 + j]]);
+  }
+  dst += encode_into(tail, remaining, dst);
 
-// Convenience overload for string input
-inline std::string encode(const std::string &input)
-{
-  std::vector<char> result = encode(&input[0], input.size());
-  return std::string(result.begin(), result.end());
+  return dst - output;
 }
 
-// High-performance decode function (handles EBCDIC Base64 input)
-inline std::vector<char> decode(const char *input, size_t input_len)
+// High-performance encode function (produces ASCII Base64 output)
+inline std::vector<char> encode(const char *input, size_t input_len)
 {
   if (input_len == 0)
   {
     return std::vector<char>();
   }
 
-  // Validate input length (must be multiple of 4)
-  if (input_len % 4 != 0)
-  {
-    throw std::invalid_argument("Invalid base64 input length");
-  }
-
-  const unsigned char *decode_table = get_ebcdic_decode_table();
+  std::vector<char> output;
+  output.resize(encoded_size(input_len)); // Pre-allocate exact size
+  encode_into(input, input_len, &output[0]);
+  return output;
+}
 
-  // Count padding characters (EBCDIC '=' is 126)
-  size_t padding = 0;
-  if (input_len >= 2)
-  {
-    if (static_cast<unsigned char>(input[input_len - 1]) == 126)
-      padding++;
-    if (static_cast<unsigned char>(input[input_len - 2]) == 126)
-      padding++;
-  }
+// Convenience overload for string input
+inline std::string encode(const std::string &input)
+{
+  std::vector<char> result = encode(&input[0], input.size());
+  return std::string(result.begin(), result.end());
+}
 
-  const size_t output_len = max_decoded_size(input_len) - padding;
-  std::vector<char> output;
-  output.reserve(output_len);
+// Decode EBCDIC Base64 input, whose length must be a multiple of 4, into output, which
+// needs room for max_decoded_size(input_len) bytes; returns the number of bytes written.
+// Padding ends its group early wherever it appears. Throws std::invalid_argument on
+// characters outside the alphabet.
+inline size_t decode_into(const char *input, size_t input_len, char *output)
+{
+  const unsigned char *decode_table = get_ebcdic_decode_table();
+  char *dst = output;
 
+  const uint32_t(*shifted)[256] = get_decode_shift_tables().shifted;
   const unsigned char *src = reinterpret_cast<const unsigned char *>(input);
   const unsigned char *const src_end = src + input_len;
 
-  // Process 4 characters at a time for optimal performance
   while (src + 4 <= src_end)
   {
+    // Decode 8 characters at a time while they are all in the alphabet
+    if (src + 8 <= src_end)
+    {
+      const uint32_t first = shifted[0][src[0]] | shifted[1][src[1]] | shifted[2][src[2]] | shifted[3][src[3]];
+      const uint32_t second = shifted[0][src[4]] | shifted[1][src[5]] | shifted[2][src[6]] | shifted[3][src[7]];
+      if (((first | second) & decode_invalid) == 0)
+      {
+        dst[0] = static_cast<char>(first >> 16);
+        dst[1] = static_cast<char>(first >> 8);
+        dst[2] = static_cast<char>(first);
+        dst[3] = static_cast<char>(second >> 16);
+        dst[4] = static_cast<char>(second >> 8);
+        dst[5] = static_cast<char>(second);
+        dst += 6;
+        src += 8;
+        continue;
+      }
+    }
+
+    // Otherwise decode one group, handling padding and reporting invalid characters
     const unsigned char c0 = decode_table[src[0]];
     const unsigned char c1 = decode_table[src[1]];
     const unsigned char c2 = (src[2] == 126) ? 0 : decode_table[src[2]]; // 126 = EBCDIC '='
@@ -289,42 +362,53 @@ inline std::vector<char> decode(const char *input, size_t input_len)
     // Combine 4 x 6-bit values into 24 bits, then extract 3 bytes
     const unsigned int combined = (c0 << 18) | (c1 << 12) | (c2 << 6) | c3;
 
-    output.push_back(static_cast<char>((combined >> 16) & 0xFF));
+    *dst++ = static_cast<char>((combined >> 16) & 0xFF);
 
     if (src[2] != 126)
     {
-      output.push_back(static_cast<char>((combined >> 8) & 0xFF));
+      *dst++ = static_cast<char>((combined >> 8) & 0xFF);
 
       if (src[3] != 126)
       {
-        output.push_back(static_cast<char>(combined & 0xFF));
+        *dst++ = static_cast<char>(combined & 0xFF);
       }
     }
 
     src += 4;
   }
 
-  return output;
+  return dst - output;
 }
 
-inline std::vector<char> decode(const char *input, size_t input_len, std::vector<char> *left_over)
+// High-performance decode function (handles EBCDIC Base64 input)
+inline std::vector<char> decode(const char *input, size_t input_len)
 {
-  // Prepend leftover data to input string
-  const char *combined_input = input;
-  std::vector<char> temp_combined;
-  if (left_over != nullptr && !left_over->empty())
+  if (input_len == 0)
   {
-    input_len = load_leftover(input, input_len, *left_over, temp_combined);
-    combined_input = &temp_combined[0];
+    return std::vector<char>();
   }
-  else if (input_len == 0)
+
+  // Validate input length (must be multiple of 4)
+  if (input_len % 4 != 0)
+  {
+    throw std::invalid_argument("Invalid base64 input length");
+  }
+
+  // Count padding characters (EBCDIC '=' is 126)
+  size_t padding = 0;
+  if (input_len >= 2)
   {
-    return temp_combined;
+    if (static_cast<unsigned char>(input[input_len - 1]) == 126)
+      padding++;
+    if (static_cast<unsigned char>(input[input_len - 2]) == 126)
+      padding++;
   }
 
-  // Decode only the complete part (multiple of 4 bytes)
-  input_len = store_leftover(combined_input, input_len, left_over, 4);
-  return decode(combined_input, input_len);
+  // Padding inside the input also ends a group early, so size for the worst case and trim afterwards
+  std::vector<char> output;
+  output.resize(max_decoded_size(input_len) - padding);
+  output.resize(decode_into(input, input_len, &output[0]));
+  return output;
 }
 
 // Convenience overload for string input
@@ -334,6 +418,158 @@ inline std::string decode(const std::string &input)
   return std::string(result.begin(), result.end());
 }
 
+/**
+ * Incremental encoder for streaming loops. Each update() encodes the complete 3-byte
+ * groups seen so far into a caller-owned buffer and carries the 0-2 remaining bytes to
+ * the next call, so steady-state streaming does not allocate.
+ */
+class Encoder
+{
+public:
+  // Most characters that update() writes for input_len more bytes
+  static size_t max_output_size(size_t input_len)
+  {
+    return encoded_size(input_len);
+  }
+
+  // Encode into output, which needs room for max_output_size(input_len) characters;
+  // returns the number of characters written
+  size_t update(const char *input, size_t input_len, char *output)
+  {
+    return update_mapped(input, input_len, nullptr, output);
+  }
+
+  // As update(), but each input byte is first mapped through byte_map, a 256-entry
+  // single-byte codepage table; a null byte_map encodes the bytes as they are
+  size_t update_mapped(const char *input, size_t input_len, const unsigned char *byte_map, char *output)
+  {
+    size_t written = 0;
+    if (pending_len > 0)
+    {
+      // Complete the group left over from the previous call first
+      while (pending_len < 3 && input_len > 0)
+      {
+        pending[pending_len++] = map_byte(*input++, byte_map);
+        --input_len;
+      }
+      if (pending_len < 3)
+      {
+        return 0;
+      }
+      written = encode_into(pending, 3, output);
+      pending_len = 0;
+    }
+
+    const size_t complete_len = input_len - input_len % 3;
+    written += byte_map == nullptr ? encode_into(input, complete_len, output + written)
+                                   : encode_mapped_into(input, complete_len, byte_map, output + written);
+    pending_len = input_len - complete_len;
+    for (size_t i = 0; i < pending_len; i++)
+    {
+      pending[i] = map_byte(input[complete_len + i], byte_map);
+    }
+    return written;
+  }
+
+  // Encode into output, growing it when it is too small; callers reuse the same vector
+  // across calls so that it stops growing once it fits a chunk
+  size_t update(const char *input, size_t input_len, std::vector<char> &output)
+  {
+    const size_t needed = max_output_size(input_len);
+    if (output.size() < needed)
+    {
+      output.resize(needed);
+    }
+    return needed == 0 ? 0 : update(input, input_len, &output[0]);
+  }
+
+  // Encode the remaining bytes with padding into output, which needs room for 4
+  // characters; returns the number of characters written and resets the encoder
+  size_t finish(char *output)
+  {
+    const size_t written = encode_into(pending, pending_len, output);
+    pending_len = 0;
+    return written;
+  }
+
+private:
+  char pending[3];
+  size_t pending_len = 0;
+
+  static char map_byte(char c, const unsigned char *byte_map)
+  {
+    return byte_map == nullptr ? c : static_cast<char>(byte_map[static_cast<unsigned char>(c)]);
+  }
+};
+
+/**
+ * Incremental decoder for streaming loops. Each update() decodes the complete 4-character
+ * groups seen so far into a caller-owned buffer and carries the 0-3 remaining characters
+ * to the next call, so steady-state streaming does not allocate.
+ */
+class Decoder
+{
+public:
+  // Most bytes that update() writes for input_len more characters
+  static size_t max_output_size(size_t input_len)
+  {
+    return max_decoded_size(input_len + 3);
+  }
+
+  // Decode into output, which needs room for max_output_size(input_len) bytes; returns
+  // the number of bytes written. Throws std::invalid_argument on invalid characters.
+  size_t update(const char *input, size_t input_len, char *output)
+  {
+    size_t written = 0;
+    if (pending_len > 0)
+    {
+      // Complete the group left over from the previous call first
+      while (pending_len < 4 && input_len > 0)
+      {
+        pending[pending_len++] = *input++;
+        --input_len;
+      }
+      if (pending_len < 4)
+      {
+        return 0;
+      }
+      written = decode_into(pending, 4, output);
+      pending_len = 0;
+    }
+
+    const size_t complete_len = input_len - input_len % 4;
+    written += decode_into(input, complete_len, output + written);
+    pending_len = input_len - complete_len;
+    if (pending_len > 0)
+    {
+      std::memcpy(pending, input + complete_len, pending_len);
+    }
+    return written;
+  }
+
+  // Decode into output, growing it when it is too small; callers reuse the same vector
+  // across calls so that it stops growing once it fits a chunk
+  size_t update(const char *input, size_t input_len, std::vector<char> &output)
+  {
+    const size_t needed = max_output_size(input_len);
+    if (output.size() < needed)
+    {
+      output.resize(needed);
+    }
+    return needed == 0 ? 0 : update(input, input_len, &output[0]);
+  }
+
+  // Characters of an incomplete group still waiting for more input
+  size_t pending_size() const
+  {
+    return pending_len;
+  }
+
+private:
+  char pending[4];
+  size_t pending_len = 0;
+};
+
 } // namespace zbase64
 
 #endif // ZBASE64_H
@@ -1026,7 +1026,7 @@ static int encode_chunk_if_needed(const char *&chunk, int &chunk_len, std::vecto
 
   try
   {
-    temp_encoded = zut_encode(chunk, chunk_len, iconv_guard.get(), diag);
+    temp_encoded = zut_encode(chunk, chunk_len, iconv_guard, diag);
     chunk = &temp_encoded[0];
     chunk_len = temp_encoded.size();
     return RTNCD_SUCCESS;
@@ -1091,7 +1091,7 @@ static int encode_line_if_needed(std::string &line, const EncodingSetup &setup,
 
   try
   {
-    line = zut_encode(line, iconv_guard.get(), diag);
+    line = zut_encode(line, iconv_guard, diag);
     return RTNCD_SUCCESS;
   }
   catch (std::exception &e)
@@ -3580,9 +3580,6 @@ int zds_read_streamed(const ZDSReadOpts &opts, const std::string &pipe, size_t *
   const auto has_encoding = zds_use_codepage(zds);
   const auto codepage = std::string(zds->encoding_opts.codepage);
 
-  std::vector<char> temp_encoded;
-  std::vector<char> left_over;
-
   // Open iconv descriptor once for all chunks (for stateful encodings like IBM-939)
   const std::string source_encoding = has_encoding && std::strlen(zds->encoding_opts.source_codepage) > 0 ? std::string(zds->encoding_opts.source_codepage) : "UTF-8";
   IconvGuard iconv_guard(has_encoding ? source_encoding.c_str() : nullptr, has_encoding ? codepage.c_str() : nullptr);
@@ -3592,149 +3589,81 @@ int zds_read_streamed(const ZDSReadOpts &opts, const std::string &pipe, size_t *
     return RTNCD_FAILURE;
   }
 
-  if (is_asa)
+  // Transcode and Base64-encode each chunk straight into the output pipe
+  Base64ReadPipeline pipeline(fout, has_encoding ? &iconv_guard : nullptr);
+  try
   {
-    // For ASA, read record by record and append newlines between records
-    // This preserves the ASA control character as the first byte of each line
-    const int lrecl = attrs.lrecl > 0 ? attrs.lrecl : 32760;
-    std::vector<char> buf(lrecl);
-    size_t bytes_read;
-    bool first_record = true;
-
-    while ((bytes_read = fread(&buf[0], 1, lrecl, fin)) > 0)
+    if (is_asa)
     {
-      // Add newline before each record (except the first)
+      // For ASA, read record by record and append newlines between records
+      // This preserves the ASA control character as the first byte of each line
+      const int lrecl = attrs.lrecl > 0 ? attrs.lrecl : 32760;
+      std::vector<char> buf(lrecl);
+      size_t bytes_read;
+      bool first_record = true;
       std::string record_data;
-      if (!first_record)
-      {
-        record_data.append(1, '\n');
-      }
-      first_record = false;
 
-      // Trim trailing spaces from the record (fixed-length records are padded)
-      size_t actual_len = bytes_read;
-      while (actual_len > 0 && buf[actual_len - 1] == ' ')
+      while ((bytes_read = fread(&buf[0], 1, lrecl, fin)) > 0)
       {
-        actual_len--;
-      }
-
-      record_data.append(&buf[0], actual_len);
-
-      const char *chunk = record_data.c_str();
-      int chunk_len = record_data.length();
-
-      if (has_encoding)
-      {
-        try
+        // Add newline before each record (except the first)
+        record_data.clear();
+        if (!first_record)
         {
-          temp_encoded = zut_encode(chunk, chunk_len, iconv_guard.get(), zds->diag);
-          chunk = &temp_encoded[0];
-          chunk_len = temp_encoded.size();
+          record_data.append(1, '\n');
         }
-        catch (std::exception &e)
+        first_record = false;
+
+        // Trim trailing spaces from the record (fixed-length records are padded)
+        size_t actual_len = bytes_read;
+        while (actual_len > 0 && buf[actual_len - 1] == ' ')
         {
-          zds->diag.e_msg_len = sprintf(zds->diag.e_msg, "Failed to convert input data from %s to %s", codepage.c_str(), source_encoding.c_str());
-          return RTNCD_FAILURE;
+          actual_len--;
         }
-      }
 
-      *content_len += chunk_len;
-      temp_encoded = zbase64::encode(chunk, chunk_len, &left_over);
-      fwrite(&temp_encoded[0], 1, temp_encoded.size(), fout);
-    }
-
-    // Add trailing newline if we read any records
-    if (!first_record)
-    {
-      const char newline = '\n';
-      const char *chunk = &newline;
-      int chunk_len = 1;
+        record_data.append(&buf[0], actual_len);
+        pipeline.write(record_data.data(), record_data.length());
+      }
 
-      if (has_encoding)
+      // Add trailing newline if we read any records
+      if (!first_record)
       {
-        try
-        {
-          temp_encoded = zut_encode(chunk, chunk_len, iconv_guard.get(), zds->diag);
-          chunk = &temp_encoded[0];
-          chunk_len = temp_encoded.size();
-        }
-        catch (std::exception &e)
-        {
-          zds->diag.e_msg_len = sprintf(zds->diag.e_msg, "Failed to convert input data from %s to %s", codepage.c_str(), source_encoding.c_str());
-          return RTNCD_FAILURE;
-        }
+        const char newline = '\n';
+        pipeline.write(&newline, 1);
       }
-
-      *content_len += chunk_len;
-      temp_encoded = zbase64::encode(chunk, chunk_len, &left_over);
-      fwrite(&temp_encoded[0], 1, temp_encoded.size(), fout);
     }
-  }
-  else
-  {
-    // Non-ASA: read in chunks
-    const size_t chunk_size = FIFO_CHUNK_SIZE * 3 / 4;
-    std::vector<char> buf(chunk_size);
-    size_t bytes_read;
-
-    while ((bytes_read = fread(&buf[0], 1, chunk_size, fin)) > 0)
+    else
     {
-      int chunk_len = bytes_read;
-      const char *chunk = &buf[0];
+      // Non-ASA: read in chunks
+      const size_t chunk_size = FIFO_CHUNK_SIZE * 3 / 4;
+      std::vector<char> buf(chunk_size);
+      size_t bytes_read;
 
-      if (has_encoding)
+      while ((bytes_read = fread(&buf[0], 1, chunk_size, fin)) > 0)
       {
-        try
-        {
-          temp_encoded = zut_encode(chunk, chunk_len, iconv_guard.get(), zds->diag);
-          chunk = &temp_encoded[0];
-          chunk_len = temp_encoded.size();
-        }
-        catch (std::exception &e)
-        {
-          zds->diag.e_msg_len = sprintf(zds->diag.e_msg, "Failed to convert input data from %s to %s", codepage.c_str(), source_encoding.c_str());
-          return RTNCD_FAILURE;
-        }
+        pipeline.write(&buf[0], bytes_read);
       }
-
-      *content_len += chunk_len;
-      temp_encoded = zbase64::encode(chunk, chunk_len, &left_over);
-      fwrite(&temp_encoded[0], 1, temp_encoded.size(), fout);
     }
   }
+  catch (std::exception &e)
+  {
+    zds->diag.e_msg_len = sprintf(zds->diag.e_msg, "Failed to convert input data from %s to %s", codepage.c_str(), source_encoding.c_str());
+    return RTNCD_FAILURE;
+  }
 
   // Flush the shift state for stateful encodings after all chunks are processed
-  if (has_encoding && iconv_guard.is_valid())
+  try
   {
-    try
-    {
-      std::vector<char> flush_buffer = zut_iconv_flush(iconv_guard.get(), zds->diag);
-      if (flush_buffer.empty() && zds->diag.e_msg_len > 0)
-      {
-        return RTNCD_FAILURE;
-      }
-
-      // Write any shift sequence bytes that were generated
-      if (!flush_buffer.empty())
-      {
-        *content_len += flush_buffer.size();
-        temp_encoded = zbase64::encode(&flush_buffer[0], flush_buffer.size(), &left_over);
-        fwrite(&temp_encoded[0], 1, temp_encoded.size(), fout);
-      }
-    }
-    catch (std::exception &e)
-    {
-      zds->diag.e_msg_len = sprintf(zds->diag.e_msg, "Failed to flush encoding state");
-      return RTNCD_FAILURE;
-    }
+    pipeline.flush_transcoder();
   }
-
-  if (!left_over.empty())
+  catch (std::exception &e)
   {
-    temp_encoded = zbase64::encode(&left_over[0], left_over.size());
-    fwrite(&temp_encoded[0], 1, temp_encoded.size(), fout);
+    zds->diag.e_msg_len = sprintf(zds->diag.e_msg, "Failed to flush encoding state");
+    return RTNCD_FAILURE;
   }
 
+  pipeline.finish();
+  *content_len += pipeline.content_length();
+
   fflush(fout);
 
   return RTNCD_SUCCESS;
@@ -3795,7 +3724,8 @@ static int zds_write_sequential_streamed(ZDS *zds, const std::string &dsn, const
     std::vector<char> buf(FIFO_CHUNK_SIZE);
     size_t bytes_read;
     std::vector<char> temp_encoded;
-    std::vector<char> left_over;
+    zbase64::Decoder base64_decoder;
+    std::vector<char> decoded;
     bool write_failed = false;
 
     // Open iconv descriptor once for all chunks (for stateful encodings like IBM-939)
@@ -3809,9 +3739,8 @@ static int zds_write_sequential_streamed(ZDS *zds, const std::string &dsn, const
     // Write chunks directly - the C runtime handles ASA and record boundaries in text mode
     while ((bytes_read = fread(&buf[0], 1, FIFO_CHUNK_SIZE, fin)) > 0)
     {
-      temp_encoded = zbase64::decode(&buf[0], bytes_read, &left_over);
-      const char *chunk = &temp_encoded[0];
-      int chunk_len = temp_encoded.size();
+      int chunk_len = base64_decoder.update(&buf[0], bytes_read, decoded);
+      const char *chunk = decoded.data();
       *content_len += chunk_len;
 
       rc = encode_chunk_if_needed(chunk, chunk_len, temp_encoded, encoding, iconv_guard, zds->diag);
@@ -3968,8 +3897,8 @@ static int zds_write_member_bpam_streamed(ZDS *zds, const std::string &dsn, cons
 
   std::vector<char> buf(FIFO_CHUNK_SIZE);
   size_t bytes_read;
-  std::vector<char> temp_encoded;
-  std::vector<char> left_over;
+  zbase64::Decoder base64_decoder;
+  std::vector<char> decoded;
   std::string line_buffer; // Buffer for accumulating partial lines across chunks
 
   // Buffer the previous line so we can append flush bytes to the last one
@@ -3979,11 +3908,11 @@ static int zds_write_member_bpam_streamed(ZDS *zds, const std::string &dsn, cons
 
   while ((bytes_read = fread(&buf[0], 1, FIFO_CHUNK_SIZE, fin)) > 0)
   {
-    temp_encoded = zbase64::decode(&buf[0], bytes_read, &left_over);
-    *content_len += temp_encoded.size();
+    const size_t decoded_len = base64_decoder.update(&buf[0], bytes_read, decoded);
+    *content_len += decoded_len;
 
     // Append chunk to line buffer (before encoding for ASA processing)
-    line_buffer.append(temp_encoded.begin(), temp_encoded.end());
+    line_buffer.append(decoded.data(), decoded_len);
 
     size_t pos = 0;
     size_t newline_pos;
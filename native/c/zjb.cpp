@@ -9,6 +9,9 @@
  *
  */
 
+#include <algorithm>
+#include <cctype>
+#include <future>
 #include <sstream>
 #include <string>
 #include <cstring>
@@ -51,7 +54,14 @@ int zjb_read_jobs_output_by_key(ZJB *zjb, const std::string &jobid, int key, std
   if (0 != rc)
     return rc;
 
-  return zjb_read_job_content_by_dsn(zjb, job_dsn, response);
+  rc = zjb_read_job_content_by_dsn(zjb, job_dsn, response);
+  if (RTNCD_SUCCESS != rc)
+  {
+    // The data set name may have come from the DD cache after the job was purged
+    JobDDCache::get_instance().invalidate(jobid);
+  }
+
+  return rc;
 }
 
 int zjb_get_job_dsn_by_key(ZJB *zjb, const std::string &jobid, int key, std::string &job_dsn)
@@ -353,18 +363,12 @@ int zjb_read_syslog(ZJB *zjb, std::string &response, std::string &date, std::str
   return rc;
 }
 
-int zjb_read_job_content_by_dsn(ZJB *zjb, const std::string &dsn, std::string &response)
+// Read a spool data set allocated to ddname, then free the allocation
+static int zjb_read_allocated_job_content(ZJB *zjb, const std::string &dsn, const std::string &ddname, std::string &response)
 {
   int rc = 0;
-  std::string ddname;
   ZDS zds = {};
 
-  rc = zjb_read_job_dynamic_allocation(zjb, dsn, ddname);
-  if (0 != rc)
-  {
-    return rc;
-  }
-
   zds.encoding_opts.data_type = zjb->encoding_opts.data_type;
   memcpy((void *)&zds.encoding_opts.codepage, (const void *)&zjb->encoding_opts.codepage, sizeof(zjb->encoding_opts.codepage));
 
@@ -381,6 +385,136 @@ int zjb_read_job_content_by_dsn(ZJB *zjb, const std::string &dsn, std::string &r
   return rc;
 }
 
+int zjb_read_job_content_by_dsn(ZJB *zjb, const std::string &dsn, std::string &response)
+{
+  std::string ddname;
+
+  int rc = zjb_read_job_dynamic_allocation(zjb, dsn, ddname);
+  if (0 != rc)
+  {
+    return rc;
+  }
+
+  return zjb_read_allocated_job_content(zjb, dsn, ddname, response);
+}
+
+namespace
+{
+// Result of allocating a spool data set on the prefetch thread
+struct JobDDAllocation
+{
+  int rc;
+  std::string ddname;
+  ZDIAG diag;
+};
+
+JobDDAllocation zjb_allocate_job_dd(ZJB zjb, std::string dsn)
+{
+  JobDDAllocation allocation{};
+  memset(&zjb.diag, 0, sizeof(zjb.diag));
+  allocation.rc = zjb_read_job_dynamic_allocation(&zjb, dsn, allocation.ddname);
+  allocation.diag = zjb.diag;
+  return allocation;
+}
+
+// Wait for an allocation that will not be read and free it
+void zjb_discard_job_dd(ZJB *zjb, std::future<JobDDAllocation> &pending)
+{
+  if (!pending.valid())
+    return;
+
+  JobDDAllocation allocation = pending.get();
+  if (0 == allocation.rc)
+  {
+    DiagMsgGuard guard(&zjb->diag);
+    zjb_free_job_dynamic_allocation(zjb, allocation.ddname);
+  }
+}
+} // namespace
+
+int zjb_read_all_jobs_output(ZJB *zjb, const std::string &jobid, size_t max_bytes, const std::function<int(const ZJobDD &, std::string &, bool)> &on_file)
+{
+  std::vector<ZJobDD> dds;
+  int rc = zjb_list_dds(zjb, jobid, dds);
+  if (0 != rc && dds.empty())
+  {
+    return rc;
+  }
+
+  // A truncated list is read as far as it goes, and its warning is returned at the end
+  const int list_rc = rc;
+  const ZDIAG list_diag = zjb->diag;
+
+  // Allocating a spool data set takes about as long as reading a small one, so the next data set is
+  // allocated on another thread while the current one is read and handed to the caller
+  JobDDAllocation allocation = zjb_allocate_job_dd(*zjb, dds[0].dsn);
+  std::future<JobDDAllocation> pending;
+  size_t total_bytes = 0;
+
+  for (size_t i = 0; i < dds.size(); i++)
+  {
+    if (i > 0)
+    {
+      allocation = pending.get();
+    }
+    if (i + 1 < dds.size())
+    {
+      pending = std::async(std::launch::async, zjb_allocate_job_dd, *zjb, dds[i + 1].dsn);
+    }
+
+    if (0 != allocation.rc)
+    {
+      memcpy(&zjb->diag, &allocation.diag, sizeof(ZDIAG));
+      zjb_discard_job_dd(zjb, pending);
+      // The DD list may have come from the DD cache after the job was purged
+      JobDDCache::get_instance().invalidate(jobid);
+      return allocation.rc;
+    }
+
+    std::string content;
+    rc = zjb_read_allocated_job_content(zjb, dds[i].dsn, allocation.ddname, content);
+    if (0 != rc)
+    {
+      zjb_discard_job_dd(zjb, pending);
+      return rc;
+    }
+
+    if (0 != max_bytes && content.size() > max_bytes - total_bytes)
+    {
+      zjb_discard_job_dd(zjb, pending);
+
+      // The files left out are still passed on, without content, so that the caller can read them one at a time
+      std::string().swap(content);
+      for (size_t j = i; j < dds.size(); j++)
+      {
+        rc = on_file(dds[j], content, true);
+        if (0 != rc)
+        {
+          return rc;
+        }
+      }
+
+      zjb->diag.e_msg_len = sprintf(zjb->diag.e_msg, "max bytes reached '%zu', %zu of %zu spool files read", max_bytes, i, dds.size());
+      zjb->diag.detail_rc = ZJB_RSNCD_MAX_BYTES_REACHED;
+      return RTNCD_WARNING;
+    }
+    total_bytes += content.size();
+
+    rc = on_file(dds[i], content, false);
+    if (0 != rc)
+    {
+      zjb_discard_job_dd(zjb, pending);
+      return rc;
+    }
+  }
+
+  if (RTNCD_WARNING == list_rc)
+  {
+    zjb->diag = list_diag;
+  }
+  return list_rc;
+}
+
 int zjb_wait(ZJB *zjb, const std::string &status)
 {
   int rc = 0;
@@ -416,6 +550,7 @@ int zjb_delete(ZJB *zjb, const std::string &jobid)
     zut_uppercase_pad_truncate(zjb->correlator, jobid, sizeof(zjb->correlator));
   else
     zut_uppercase_pad_truncate(zjb->jobid, jobid, sizeof(zjb->jobid));
+  JobDDCache::get_instance().invalidate(jobid);
   return ZJBMPRG(zjb);
 }
 
@@ -425,6 +560,7 @@ int zjb_cancel(ZJB *zjb, const std::string &jobid)
     zut_uppercase_pad_truncate(zjb->correlator, jobid, sizeof(zjb->correlator));
   else
     zut_uppercase_pad_truncate(zjb->jobid, jobid, sizeof(zjb->jobid));
+  JobDDCache::get_instance().invalidate(jobid);
   return ZJBMCNL(zjb, 0);
 }
 
@@ -551,7 +687,7 @@ int zjb_submit(ZJB *zjb, const std::string &contents, std::string &jobid)
   return RTNCD_SUCCESS;
 }
 
-int zjb_list_dds(ZJB *zjb, const std::string &jobid, std::vector<ZJobDD> &jobDDs)
+static int zjb_list_dds_uncached(ZJB *zjb, const std::string &jobid, std::vector<ZJobDD> &jobDDs)
 {
   int rc = 0;
   STATSEVB *PTR64 sysoutInfo = nullptr;
@@ -850,3 +986,192 @@ void zjb_build_job_response(ZJB_JOB_INFO *PTR64 job_info, int entries, std::vect
     jobs.push_back(zjob);
   }
 }
+
+// Phases after execution, in which the spool data sets of a job no longer change until it is purged
+static bool zjb_is_phase_complete(unsigned char phase)
+{
+  switch (phase)
+  {
+  case stat___done:
+  case stat___outpt:
+  case stat___outque:
+  case stat___oswait:
+  case stat___cmplt:
+  case stat___wtbkdn:
+  case stat___postex:
+    return true;
+  default:
+    return false;
+  }
+}
+
+int zjb_list_dds(ZJB *zjb, const std::string &jobid, std::vector<ZJobDD> &jobDDs)
+{
+  if (0 == zjb->dds_max)
+    zjb->dds_max = ZJB_DEFAULT_MAX_DDS;
+
+  JobDDCache &cache = JobDDCache::get_instance();
+  std::vector<ZJobDD> cached;
+  unsigned char phase = 0;
+  if (cache.get(jobid, cached, phase) && cached.size() <= (size_t)zjb->dds_max)
+  {
+    // Leave the ZJB as a successful SSI query would
+    zjb->job_phase = phase;
+    zjb->diag.detail_rc = 0;
+    zjb->diag.e_msg_len = 0;
+    zjb->diag.e_msg[0] = '\0';
+    for (auto &dd : cached)
+    {
+      dd.jobid = jobid;
+      jobDDs.push_back(dd);
+    }
+    return RTNCD_SUCCESS;
+  }
+
+  const size_t first = jobDDs.size();
+  int rc = zjb_list_dds_uncached(zjb, jobid, jobDDs);
+
+  // Truncated lists and lookups that found nothing are not cached
+  if (RTNCD_SUCCESS == rc && 0 == zjb->diag.detail_rc)
+  {
+    cache.put(jobid, std::vector<ZJobDD>(jobDDs.begin() + first, jobDDs.end()), zjb->job_phase, zjb_is_phase_complete(zjb->job_phase));
+  }
+
+  return rc;
+}
+
+// Jobs are looked up by id or correlator without regard to case or trailing blanks. A job id is
+// reduced to its type and number, since JES accepts J123, JOB00123 and J0000123 for the same job.
+static std::string zjb_cache_key(const std::string &jobid)
+{
+  std::string key(jobid);
+  const size_t end = key.find_last_not_of(std::string(" \0", 2));
+  key.erase(end == std::string::npos ? 0 : end + 1);
+  std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c)
+                 { return static_cast<char>(std::toupper(c)); });
+
+  if (key.size() > sizeof(ZJB::jobid))
+  {
+    return key; // correlator
+  }
+
+  static const char *const prefixes[][2] = {{"JOB", "J"}, {"STC", "S"}, {"TSU", "T"}, {"J", "J"}, {"S", "S"}, {"T", "T"}};
+  for (const auto &prefix : prefixes)
+  {
+    const size_t len = strlen(prefix[0]);
+    if (key.size() > len && 0 == key.compare(0, len, prefix[0]) &&
+        key.find_first_not_of("0123456789", len) == std::string::npos)
+    {
+      const size_t digits = key.find_first_not_of('0', len);
+      return std::string(prefix[1]) + (digits == std::string::npos ? "0" : key.substr(digits));
+    }
+  }
+
+  return key;
+}
+
+void JobDDCache::configure(size_t max_entries_kept, size_t max_dds_kept, std::chrono::milliseconds active, std::chrono::milliseconds complete)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  max_entries = max_entries_kept;
+  max_dds = max_dds_kept;
+  active_ttl = active;
+  complete_ttl = complete;
+  while (!entries.empty() && (entries.size() > max_entries || stats.dds > max_dds))
+  {
+    erase(std::prev(entries.end()));
+    stats.evictions++;
+  }
+}
+
+bool JobDDCache::get(const std::string &jobid, std::vector<ZJobDD> &dds, unsigned char &phase)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  const auto found = index.find(zjb_cache_key(jobid));
+  if (found == index.end())
+  {
+    stats.misses++;
+    return false;
+  }
+
+  const auto it = found->second;
+  if (std::chrono::steady_clock::now() >= it->expires_at)
+  {
+    erase(it);
+    stats.expirations++;
+    stats.misses++;
+    return false;
+  }
+
+  entries.splice(entries.begin(), entries, it);
+  dds = it->dds;
+  phase = it->phase;
+  stats.hits++;
+  return true;
+}
+
+void JobDDCache::put(const std::string &jobid, const std::vector<ZJobDD> &dds, unsigned char phase, bool complete)
+{
+  const std::string key = zjb_cache_key(jobid);
+  std::lock_guard<std::mutex> lock(mutex);
+  const auto found = index.find(key);
+  if (found != index.end())
+  {
+    erase(found->second);
+  }
+
+  if (dds.size() > max_dds || 0 == max_entries)
+  {
+    return;
+  }
+
+  while (!entries.empty() && (entries.size() >= max_entries || stats.dds + dds.size() > max_dds))
+  {
+    erase(std::prev(entries.end()));
+    stats.evictions++;
+  }
+
+  Entry entry;
+  entry.key = key;
+  entry.dds = dds;
+  entry.phase = phase;
+  entry.expires_at = std::chrono::steady_clock::now() + (complete ? complete_ttl : active_ttl);
+  entries.push_front(std::move(entry));
+  index[key] = entries.begin();
+  stats.dds += dds.size();
+  stats.entries = entries.size();
+}
+
+void JobDDCache::invalidate(const std::string &jobid)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  const auto found = index.find(zjb_cache_key(jobid));
+  if (found != index.end())
+  {
+    erase(found->second);
+    stats.invalidations++;
+  }
+}
+
+JobDDCache::Stats JobDDCache::get_stats()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return stats;
+}
+
+void JobDDCache::clear()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  entries.clear();
+  index.clear();
+  stats.entries = 0;
+  stats.dds = 0;
+}
+
+void JobDDCache::erase(std::list<Entry>::iterator it)
+{
+  stats.dds -= it->dds.size();
+  index.erase(it->key);
+  entries.erase(it);
+  stats.entries = entries.size();
+}
@@ -12,10 +12,17 @@
 #ifndef ZJB_HPP
 #define ZJB_HPP
 
+#include <chrono>
+#include <cstddef>
+#include <functional>
 #include <iostream>
+#include <list>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 #include <string>
 #include "zjbtype.h"
+#include "singleton.hpp"
 
 struct ZJob
 {
@@ -151,6 +158,23 @@ int zjb_get_job_dsn_by_key(ZJB *zjb, const std::string &, int, std::string &);
  */
 int zjb_read_job_content_by_dsn(ZJB *zjb, const std::string &job_dsn, std::string &response);
 
+#ifndef SWIG
+/**
+ * @brief Read every spool file of a job, listing its files once
+ *
+ * @param zjb job returned attributes and error information
+ * @param jobid jobid or job correlator used to search
+ * @param max_bytes total size of the content passed to on_file, 0 for no limit; reading stops with
+ * RTNCD_WARNING before the first file that would exceed it, and that file and the ones after it are
+ * passed to on_file as truncated. A DD list truncated at zjb->dds_max is read as far as it goes and also
+ * returns RTNCD_WARNING.
+ * @param on_file called with each file, its content and whether it was left out (its content is then
+ * empty), in the order zjb_list_dds returns them; a non-zero return stops reading and is returned
+ * @return int 0 for success; non zero otherwise
+ */
+int zjb_read_all_jobs_output(ZJB *zjb, const std::string &jobid, size_t max_bytes, const std::function<int(const ZJobDD &, std::string &, bool)> &on_file);
+#endif
+
 int zjb_read_syslog(ZJB *zjb, std::string &response, std::string &date, std::string &timestamp, int max_lines);
 
 /**
@@ -231,4 +255,94 @@ int zjb_hold(ZJB *zjb, const std::string &jobid);
  */
 int zjb_release(ZJB *zjb, const std::string &jobid);
 
+
+#ifndef SWIG
+/**
+ * Process-wide cache of the spool data sets (DDs) listed for a job, keyed by job id or job
+ * correlator. Reading a spool file maps its key to a data set name through the DD list, which
+ * costs a full SSI query, so zjb_list_dds serves repeated lookups from here.
+ *
+ * The DDs of a job that has finished (its output is awaiting print or purge) do not change, so
+ * they are kept for the complete TTL, which bounds how long a purged job whose number JES has
+ * reused can be served stale DDs. The DDs of a job still in input or execution are kept for the
+ * active TTL only. Job ids are matched by type and number, so J123 and JOB00123 share an entry.
+ * At most `max_entries` jobs and `max_dds` DDs are kept; the least recently used job is evicted
+ * first. Thread-safe.
+ */
+class JobDDCache : public Singleton<JobDDCache>
+{
+  friend class Singleton<JobDDCache>;
+
+public:
+  struct Stats
+  {
+    unsigned long long hits;          // Lookups served from the cache
+    unsigned long long misses;        // Lookups not cached, including expired entries
+    unsigned long long expirations;   // Entries dropped after their TTL
+    unsigned long long evictions;     // Entries dropped to stay within the size bounds
+    unsigned long long invalidations; // Entries dropped because the job was cancelled, purged or unreadable
+    size_t entries;                   // Jobs currently cached
+    size_t dds;                       // DDs currently cached
+  };
+
+  static const size_t default_max_entries = 256;
+  static const size_t default_max_dds = 16384;
+  static constexpr std::chrono::seconds default_active_ttl{5};
+  static constexpr std::chrono::seconds default_complete_ttl{300};
+
+  /**
+   * @param max_entries Jobs kept; 0 disables the cache
+   * @param max_dds DDs kept across all jobs; a job with more DDs is not cached
+   * @param active_ttl Time the DDs of a job that has not finished are kept
+   * @param complete_ttl Time the DDs of a finished job are kept
+   */
+  void configure(size_t max_entries, size_t max_dds, std::chrono::milliseconds active_ttl, std::chrono::milliseconds complete_ttl);
+
+  /**
+   * Copy the cached DDs of a job
+   * @param phase Set to the phase the job was in when its DDs were listed
+   * @return false if the job is not cached or its entry expired
+   */
+  bool get(const std::string &jobid, std::vector<ZJobDD> &dds, unsigned char &phase);
+
+  /**
+   * Cache the DDs of a job
+   * @param phase Phase of the job when its DDs were listed (STAT___ equates in iazssst.h)
+   * @param complete Whether the job has finished, so that its DDs no longer change
+   */
+  void put(const std::string &jobid, const std::vector<ZJobDD> &dds, unsigned char phase, bool complete);
+
+  // Drop the DDs of a job, e.g. after it is cancelled or purged
+  void invalidate(const std::string &jobid);
+
+  Stats get_stats();
+
+  // Drop all entries
+  void clear();
+
+private:
+  struct Entry
+  {
+    std::string key;
+    std::vector<ZJobDD> dds;
+    unsigned char phase;
+    std::chrono::steady_clock::time_point expires_at;
+  };
+
+  std::mutex mutex;
+  std::list<Entry> entries; // Most recently used first
+  std::unordered_map<std::string, std::list<Entry>::iterator> index;
+  size_t max_entries = default_max_entries;
+  size_t max_dds = default_max_dds;
+  std::chrono::milliseconds active_ttl{default_active_ttl};
+  std::chrono::milliseconds complete_ttl{default_complete_ttl};
+  Stats stats = {0, 0, 0, 0, 0, 0, 0};
+
+  JobDDCache() = default;
+
+  // Remove an entry; called with the mutex held
+  void erase(std::list<Entry>::iterator it);
+};
+#endif
+
 #endif
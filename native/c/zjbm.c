@@ -509,6 +509,8 @@ int ZJBMLSDS(ZJB *PTR64 zjb, STATSEVB **PTR64 sysoutInfo, int *entries)
   STATSVHD *PTR32 statsvhdp = NULL;
   STATSEVB *PTR32 statsevbp = NULL;
 
+  zjb->job_phase = 0;
+
   // https://www.ibm.com/docs/en/zos/3.1.0?topic=sfcd-extended-status-function-call-ssi-function-code-80
   if (0 != init_ssib(&ssib))
   {
@@ -629,6 +631,7 @@ int ZJBMLSDS(ZJB *PTR64 zjb, STATSEVB **PTR64 sysoutInfo, int *entries)
   {
     statjqhdp = (STATJQHD * PTR32)((unsigned char *PTR32)statjqp + statjqp->stjqohdr);
     statjqtrp = (STATJQTR * PTR32)((unsigned char *PTR32)statjqhdp + sizeof(STATJQHD));
+    zjb->job_phase = statjqtrp->sttrphaz;
 
     while (statvop)
     {
@@ -29,6 +29,7 @@
 #define ZJB_RSNCD_MAX_JOBS_REACHED -1
 #define ZJB_RSNCD_JOBID_NOT_FOUND -2
 #define ZJB_RSNCD_CORRELATOR_NOT_FOUND -3
+#define ZJB_RSNCD_MAX_BYTES_REACHED -4
 
 #define ZJB_DEFAULT_BUFFER_SIZE 128000
 #define ZJB_DEFAULT_MAX_JOBS 1000
@@ -52,7 +53,8 @@ typedef struct
   int32_t buffer_size;
 
   int32_t buffer_size_needed; // total amount of buffer size needed to satisfy request
-  unsigned char reserve_1[4];
+  unsigned char job_phase;    // phase of the job whose DDs were listed last (STAT___ equates in iazssst.h)
+  unsigned char reserve_1[3];
 
   char correlator[64]; // job correlator
   char jobid[8];       // job id
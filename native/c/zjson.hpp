@@ -28,13 +28,17 @@
 #include <optional>
 #include <variant>
 #include <string_view>
+#include <array>
+#include <tuple>
 #include <memory>
 #include <type_traits>
 #include "zjsonm.h"
 #include "zjsontype.h"
 #include "zstd.hpp"
 #include "zlogger.hpp"
+#if defined(__MVS__) && defined(ZJSON_USE_HWTJ)
 #include <hwtjic.h> // ensure to include /usr/include
+#endif
 
 /*
  * ZJson - C++ JSON library with automatic struct serialization
@@ -43,6 +47,14 @@
  *
  * Requires ibm-clang (IBM Open XL C/C++) with C++17 support.
  *
+ * ==================== PARSER BACKEND ====================
+ *
+ * By default, from_str uses a portable single-pass recursive-descent parser
+ * that builds Value trees directly from the input buffer, and to_string
+ * writes JSON text in a single pass without an intermediate document.
+ * Define ZJSON_USE_HWTJ at compile time to parse and serialize through the
+ * z/OS JSON parser services (HWTJ) instead.
+ *
  * ==================== QUICK REFERENCE ====================
  *
  * Parsing:
@@ -52,6 +64,7 @@
  * Serialization:
  *   std::string json = zjson::to_string(obj);
  *   std::string pretty = zjson::to_string_pretty(obj);
+ *   zjson::write_to(buffer_or_stream, obj);  // append without a temporary string
  *
  * Struct Registration:
  *   ZJSON_DERIVE(StructName, field1, field2, ...)
@@ -90,6 +103,7 @@ namespace zjson
 {
 class Value;
 class Error;
+class Reader;
 template <typename T>
 struct Serializable;
 template <typename T>
@@ -229,6 +243,14 @@ template <typename T>
 struct is_optional<std::optional<T>> : std::true_type
 {
 };
+
+template <typename T>
+struct always_false : std::false_type
+{
+};
+
+template <typename Sink>
+class JsonWriter;
 } // namespace detail
 
 /**
@@ -312,6 +334,9 @@ class Value
   friend std::string value_to_json_string(const Value &value);
   friend Value parse_json_string(const std::string &json_str);
   friend Value json_handle_to_value(JSON_INSTANCE *instance, KEY_HANDLE *key_handle);
+  friend class Reader;
+  template <typename Sink>
+  friend class detail::JsonWriter;
 
   // Friend template specializations for vector serialization
   template <typename T>
@@ -487,6 +512,21 @@ public:
     return *this;
   }
 
+  // Move constructor and assignment (avoid deep copies when containers grow)
+  Value(Value &&other) noexcept
+      : data_(std::move(other.data_))
+  {
+  }
+
+  Value &operator=(Value &&other) noexcept
+  {
+    if (this != &other)
+    {
+      data_ = std::move(other.data_);
+    }
+    return *this;
+  }
+
   ~Value()
   {
   }
@@ -537,7 +577,7 @@ public:
         ss << value;
         throw Error::invalid_value("Cannot convert floating-point number " + ss.str() + " to int64");
       }
-      else if (isnan(value) || isinf(value))
+      else if (std::isnan(value) || std::isinf(value))
       {
         std::stringstream ss;
         ss << value;
@@ -586,7 +626,7 @@ public:
         ss << value;
         throw Error::invalid_value("Cannot convert floating-point number " + ss.str() + " to uint64");
       }
-      else if (isnan(value) || isinf(value))
+      else if (std::isnan(value) || std::isinf(value))
       {
         std::stringstream ss;
         ss << value;
@@ -610,7 +650,7 @@ public:
     if (is_double())
     {
       double value = get_double();
-      if (isnan(value) || isinf(value))
+      if (std::isnan(value) || std::isinf(value))
       {
         std::stringstream ss;
         ss << value;
@@ -787,7 +827,7 @@ struct Serializable
 
   static Value serialize(const T &obj)
   {
-    static_assert(Serializable<T>::value, "Type must implement Serializable trait");
+    static_assert(detail::always_false<T>::value, "Type must implement Serializable trait");
     return Value();
   }
 };
@@ -802,7 +842,7 @@ struct Deserializable
 
   static zstd::expected<T, Error> deserialize(const Value &value)
   {
-    static_assert(Deserializable<T>::value, "Type must implement Deserializable trait");
+    static_assert(detail::always_false<T>::value, "Type must implement Deserializable trait");
     return zstd::make_unexpected(Error::invalid_type("deserializable", "unknown"));
   }
 };
@@ -1276,6 +1316,306 @@ public:
   }
 };
 
+namespace detail
+{
+/**
+ * Output sinks for JsonWriter: append straight into a caller-owned string or
+ * forward to a caller-owned stream.
+ */
+struct StringSink
+{
+  std::string &out;
+
+  inline void append(const char *data, size_t length)
+  {
+    out.append(data, length);
+  }
+  inline void put(char c)
+  {
+    out.push_back(c);
+  }
+};
+
+struct StreamSink
+{
+  std::ostream &os;
+  size_t written;
+
+  inline void append(const char *data, size_t length)
+  {
+    os.write(data, static_cast<std::streamsize>(length));
+    written += length;
+  }
+  inline void put(char c)
+  {
+    os.put(c);
+    ++written;
+  }
+};
+
+/**
+ * Single-pass JSON writer. Walks a Value once and appends its text to the sink,
+ * indenting as it goes when indent > 0. Runs of string characters that need no
+ * escaping are appended in bulk.
+ */
+template <typename Sink>
+class JsonWriter
+{
+public:
+  JsonWriter(Sink sink, int indent)
+      : sink_(sink), indent_(indent)
+  {
+  }
+
+  void write(const Value &value)
+  {
+    write_value(value, 0);
+  }
+
+  const Sink &sink() const
+  {
+    return sink_;
+  }
+
+  void write_string(const std::string &str)
+  {
+    const unsigned char *table = escape_table();
+    const char *run = str.data();
+    const char *end = run + str.size();
+
+    sink_.put('"');
+    for (const char *p = run; p != end; ++p)
+    {
+      if (table[static_cast<unsigned char>(*p)])
+      {
+        if (p > run)
+        {
+          sink_.append(run, p - run);
+        }
+        write_escape(*p);
+        run = p + 1;
+      }
+    }
+    if (end > run)
+    {
+      sink_.append(run, end - run);
+    }
+    sink_.put('"');
+  }
+
+private:
+  Sink sink_;
+  int indent_;
+
+  // Characters escaped by escape_json_string, computed once per process
+  static const unsigned char *escape_table()
+  {
+    static const struct Table
+    {
+      unsigned char data[256];
+      Table()
+      {
+        for (int i = 0; i < 256; ++i)
+        {
+          const char c = static_cast<char>(i);
+          data[i] = (c == '"' || c == '\\' || iscntrl(i)) ? 1 : 0;
+        }
+      }
+    } table;
+    return table.data;
+  }
+
+  void write_escape(char c)
+  {
+    switch (c)
+    {
+    case '"':
+      sink_.append("\\\"", 2);
+      break;
+    case '\\':
+      sink_.append("\\\\", 2);
+      break;
+    case '\b':
+      sink_.append("\\b", 2);
+      break;
+    case '\f':
+      sink_.append("\\f", 2);
+      break;
+    case '\n':
+      sink_.append("\\n", 2);
+      break;
+    case '\r':
+      sink_.append("\\r", 2);
+      break;
+    case '\t':
+      sink_.append("\\t", 2);
+      break;
+    default:
+    {
+      char buf[7];
+      snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned char>(c));
+      sink_.append(buf, 6);
+      break;
+    }
+    }
+  }
+
+  void newline(int depth)
+  {
+    static const char spaces[] = "                                ";
+    if (indent_ <= 0)
+    {
+      return;
+    }
+    sink_.put('\n');
+    size_t remaining = static_cast<size_t>(depth) * indent_;
+    while (remaining > 0)
+    {
+      const size_t chunk = remaining < sizeof(spaces) - 1 ? remaining : sizeof(spaces) - 1;
+      sink_.append(spaces, chunk);
+      remaining -= chunk;
+    }
+  }
+
+  void write_value(const Value &value, int depth)
+  {
+    switch (value.get_type())
+    {
+    case Value::Null:
+      sink_.append("null", 4);
+      break;
+
+    case Value::Bool:
+      if (value.get_bool())
+        sink_.append("true", 4);
+      else
+        sink_.append("false", 5);
+      break;
+
+    case Value::Number:
+    {
+      char buf[32];
+      int length;
+      if (value.is_integer())
+      {
+        length = snprintf(buf, sizeof(buf), "%lld", value.get_long_long());
+      }
+      else if (std::isfinite(value.get_double()))
+      {
+        // Full double precision (17 significant digits)
+        length = snprintf(buf, sizeof(buf), "%.17g", value.get_double());
+      }
+      else
+      {
+        // JSON has no representation for NaN or infinity
+        sink_.append("null", 4);
+        break;
+      }
+      sink_.append(buf, static_cast<size_t>(length));
+      break;
+    }
+
+    case Value::String:
+      write_string(value.get_string());
+      break;
+
+    case Value::Array:
+    {
+      const std::vector<Value> &array = value.get_array();
+      if (array.empty())
+      {
+        sink_.append("[]", 2);
+        break;
+      }
+      sink_.put('[');
+      for (size_t i = 0; i < array.size(); ++i)
+      {
+        if (i > 0)
+        {
+          sink_.put(',');
+        }
+        newline(depth + 1);
+        write_value(array[i], depth + 1);
+      }
+      newline(depth);
+      sink_.put(']');
+      break;
+    }
+
+    case Value::Object:
+    {
+      const std::unordered_map<std::string, Value> &object = value.get_object();
+      if (object.empty())
+      {
+        sink_.append("{}", 2);
+        break;
+      }
+      sink_.put('{');
+      bool first = true;
+      for (const auto &[key, val] : object)
+      {
+        if (!first)
+        {
+          sink_.put(',');
+        }
+        first = false;
+        newline(depth + 1);
+        write_string(key);
+        sink_.put(':');
+        if (indent_ > 0)
+        {
+          sink_.put(' ');
+        }
+        write_value(val, depth + 1);
+      }
+      newline(depth);
+      sink_.put('}');
+      break;
+    }
+    }
+  }
+};
+} // namespace detail
+
+/**
+ * Append the JSON text for a Value to a caller-supplied buffer in a single pass.
+ * @param out Buffer to append to (existing content is kept)
+ * @param value Value to serialize
+ * @param indent Spaces per nesting level, or 0 for compact output
+ * @return Number of bytes appended
+ */
+inline size_t write_json(std::string &out, const Value &value, int indent = 0)
+{
+  const size_t start = out.size();
+  detail::JsonWriter<detail::StringSink>(detail::StringSink{out}, indent).write(value);
+  return out.size() - start;
+}
+
+/**
+ * Write the JSON text for a Value to a caller-supplied stream in a single pass.
+ * @param os Stream to write to
+ * @param value Value to serialize
+ * @param indent Spaces per nesting level, or 0 for compact output
+ * @return Number of bytes written
+ */
+inline size_t write_json(std::ostream &os, const Value &value, int indent = 0)
+{
+  detail::JsonWriter<detail::StreamSink> writer(detail::StreamSink{os, 0}, indent);
+  writer.write(value);
+  return writer.sink().written;
+}
+
+/**
+ * Append a string to a caller-supplied buffer as a quoted JSON string, escaped
+ * the same way as by write_json.
+ * @param out Buffer to append to (existing content is kept)
+ * @param str String to write
+ */
+inline void write_json_string(std::string &out, const std::string &str)
+{
+  detail::JsonWriter<detail::StringSink>(detail::StringSink{out}, 0).write_string(str);
+}
+
 /**
  * Main serialization and deserialization functions
  */
@@ -1286,6 +1626,11 @@ zstd::expected<std::string, Error> to_string(const T &value)
 {
   try
   {
+    if constexpr (std::is_same<T, Value>::value)
+    {
+      // Serialize the tree in place instead of copying it first
+      return value_to_json_string(value);
+    }
     Value serialized;
     if constexpr (Serializable<T>::value)
     {
@@ -1439,69 +1784,694 @@ inline std::string unescape_json_string(const std::string &s)
   return res;
 }
 
-inline Value json_handle_to_value(JSON_INSTANCE *instance, KEY_HANDLE *key_handle)
+/**
+ * Single-pass recursive-descent JSON reader over an in-memory buffer.
+ *
+ * Used as a tree parser (read_value builds a Value directly from the input) or
+ * as a pull parser, where callers walk objects and arrays with read_object and
+ * read_array and decode only what they need. String values without escape
+ * sequences are copied straight out of the input; escaped strings share
+ * unescape_json_string with the HWTJ path so both backends produce identical
+ * values. Syntax errors throw Error with the line and column of the failure.
+ */
+class Reader
 {
-  try
+public:
+  // Guards the recursion against deeply nested (or malicious) input
+  static constexpr int MAX_DEPTH = 512;
+
+  Reader(const char *data, size_t length)
+      : begin_(data), cur_(data), end_(data + length), depth_(0)
   {
-    int type = 0;
-    int rc = ZJSNGJST(instance, key_handle, &type);
-    if (rc != 0)
+  }
+
+  // The reader does not copy its input; json must outlive it
+  explicit Reader(std::string_view json)
+      : Reader(json.data(), json.size())
+  {
+  }
+
+  /**
+   * Parse the whole input as a single JSON document
+   */
+  Value parse()
+  {
+    Value result;
+    start();
+    read_value(result);
+    finish();
+    return result;
+  }
+
+  /**
+   * Ensure the input holds a document before reading it
+   */
+  void start()
+  {
+    skip_whitespace();
+    if (cur_ == end_)
     {
-      return Value(); // Return null on error
+      fail("empty input");
+    }
+  }
+
+  /**
+   * Ensure only whitespace remains after the last value
+   */
+  void finish()
+  {
+    skip_whitespace();
+    if (cur_ != end_)
+    {
+      fail("unexpected trailing characters");
     }
+  }
 
-    switch (type)
+  /**
+   * Type of the next value, without consuming it
+   */
+  Value::Type peek()
+  {
+    skip_whitespace();
+    if (cur_ == end_)
     {
-    case HWTJ_NULL_TYPE:
-      return Value();
+      fail("unexpected end of input");
+    }
 
-    case HWTJ_BOOLEAN_TYPE:
+    switch (*cur_)
     {
-      char bool_val = 0;
-      rc = ZJSMGBOV(instance, key_handle, &bool_val);
-      if (rc != 0)
+    case '{':
+      return Value::Object;
+    case '[':
+      return Value::Array;
+    case '"':
+      return Value::String;
+    case 't':
+    case 'f':
+      return Value::Bool;
+    case 'n':
+      return Value::Null;
+    default:
+      if (*cur_ == '-' || at_digit())
       {
-        return Value();
+        return Value::Number;
       }
-      return Value(bool_val == HWTJ_TRUE);
+      fail("unexpected character");
     }
+  }
 
-    case HWTJ_NUMBER_TYPE:
+  /**
+   * Current read position in the input buffer
+   */
+  const char *position() const
+  {
+    return cur_;
+  }
+
+  /**
+   * Walk the members of the next object. on_member(key) is called for each
+   * member and must consume exactly one value from this reader.
+   */
+  template <typename OnMember>
+  void read_object(OnMember &&on_member)
+  {
+    skip_whitespace();
+    expect('{', "expected object");
+    enter();
+
+    skip_whitespace();
+    if (at('}'))
     {
-      char *value_ptr = 0;
-      int value_length = 0;
-      rc = ZJSMGVAL(instance, key_handle, &value_ptr, &value_length);
-      if (rc != 0)
-      {
-        return Value();
-      }
-      try
+      ++cur_;
+      --depth_;
+      return;
+    }
+
+    std::string key;
+    while (true)
+    {
+      if (!at('"'))
       {
-        std::string str_val(value_ptr, value_length);
-        if (str_val.find('.') != std::string::npos || str_val.find('e') != std::string::npos || str_val.find('E') != std::string::npos)
-        {
-          char *endptr = nullptr;
-          double num_val = std::strtod(str_val.c_str(), &endptr);
-          if (endptr == str_val.c_str() || *endptr != '\0')
-          {
-            return Value();
-          }
-          return Value(num_val);
-        }
-        else
-        {
-          char *endptr = nullptr;
-          long long int_val = std::strtoll(str_val.c_str(), &endptr, 10);
-          if (endptr == str_val.c_str() || *endptr != '\0')
-          {
-            return Value();
-          }
-          return Value(int_val);
-        }
+        fail("expected string key");
       }
-      catch (...)
+      read_string(key);
+
+      skip_whitespace();
+      expect(':', "expected ':' after object key");
+      skip_whitespace();
+
+      on_member(key);
+
+      skip_whitespace();
+      if (at(','))
       {
-        return Value();
+        ++cur_;
+        skip_whitespace();
+        continue;
+      }
+      expect('}', "expected ',' or '}' in object");
+      break;
+    }
+    --depth_;
+  }
+
+  /**
+   * Walk the elements of the next array. on_element() is called for each
+   * element and must consume exactly one value from this reader.
+   */
+  template <typename OnElement>
+  void read_array(OnElement &&on_element)
+  {
+    skip_whitespace();
+    expect('[', "expected array");
+    enter();
+
+    skip_whitespace();
+    if (at(']'))
+    {
+      ++cur_;
+      --depth_;
+      return;
+    }
+
+    while (true)
+    {
+      on_element();
+
+      skip_whitespace();
+      if (at(','))
+      {
+        ++cur_;
+        skip_whitespace();
+        continue;
+      }
+      expect(']', "expected ',' or ']' in array");
+      break;
+    }
+    --depth_;
+  }
+
+  /**
+   * Position the reader at the value of a member of the next object, skipping
+   * the members before it. Only that value can be read afterwards.
+   * @return false if the object has no such member
+   */
+  bool find_member(std::string_view name)
+  {
+    skip_whitespace();
+    expect('{', "expected object");
+    enter();
+
+    skip_whitespace();
+    if (at('}'))
+    {
+      ++cur_;
+      --depth_;
+      return false;
+    }
+
+    std::string key;
+    while (true)
+    {
+      if (!at('"'))
+      {
+        fail("expected string key");
+      }
+      read_string(key);
+
+      skip_whitespace();
+      expect(':', "expected ':' after object key");
+      skip_whitespace();
+
+      if (key == name)
+      {
+        return true;
+      }
+      skip_value();
+
+      skip_whitespace();
+      if (at(','))
+      {
+        ++cur_;
+        skip_whitespace();
+        continue;
+      }
+      expect('}', "expected ',' or '}' in object");
+      break;
+    }
+    --depth_;
+    return false;
+  }
+
+  /**
+   * Read the next value into a Value tree
+   */
+  Value read_value()
+  {
+    Value result;
+    read_value(result);
+    return result;
+  }
+
+  void read_value(Value &out)
+  {
+    switch (peek())
+    {
+    case Value::Object:
+    {
+      out.data_ = std::unordered_map<std::string, Value>();
+      std::unordered_map<std::string, Value> &object = out.get_object();
+      read_object([&](std::string &key)
+                  {
+                    // Last occurrence wins for duplicate keys
+                    Value &slot = object[std::move(key)];
+                    slot = Value();
+                    read_value(slot); });
+      break;
+    }
+    case Value::Array:
+    {
+      out.data_ = std::vector<Value>();
+      std::vector<Value> &array = out.get_array();
+      read_array([&]()
+                 {
+                   array.emplace_back();
+                   read_value(array.back()); });
+      break;
+    }
+    case Value::String:
+    {
+      std::string str;
+      read_string(str);
+      out.data_ = std::move(str);
+      break;
+    }
+    case Value::Bool:
+      if (*cur_ == 't')
+      {
+        read_literal("true", 4);
+        out.data_ = true;
+      }
+      else
+      {
+        read_literal("false", 5);
+        out.data_ = false;
+      }
+      break;
+    case Value::Null:
+      read_literal("null", 4);
+      out.data_ = std::monostate();
+      break;
+    case Value::Number:
+      read_number(out);
+      break;
+    }
+  }
+
+  /**
+   * Read the next string value
+   */
+  void read_string(std::string &out)
+  {
+    skip_whitespace();
+    const char *start = nullptr;
+    const bool escaped = scan_string(start);
+    if (escaped)
+    {
+      out = unescape_json_string(std::string(start, cur_ - 1 - start));
+    }
+    else
+    {
+      out.assign(start, cur_ - 1 - start);
+    }
+  }
+
+  /**
+   * Validate and step over the next value without building anything
+   * @return The raw JSON text of the skipped value
+   */
+  std::string_view skip_value()
+  {
+    const Value::Type type = peek();
+    const char *start = cur_;
+    switch (type)
+    {
+    case Value::Object:
+      read_object([this](const std::string &)
+                  { skip_value(); });
+      break;
+    case Value::Array:
+      read_array([this]()
+                 { skip_value(); });
+      break;
+    case Value::String:
+    {
+      const char *content = nullptr;
+      scan_string(content);
+      break;
+    }
+    case Value::Bool:
+      if (*cur_ == 't')
+        read_literal("true", 4);
+      else
+        read_literal("false", 5);
+      break;
+    case Value::Null:
+      read_literal("null", 4);
+      break;
+    case Value::Number:
+    {
+      bool is_float = false;
+      scan_number(is_float);
+      break;
+    }
+    }
+    return std::string_view(start, cur_ - start);
+  }
+
+  [[noreturn]] void fail(const char *reason) const
+  {
+    size_t line = 1;
+    size_t column = 1;
+    for (const char *p = begin_; p < cur_; ++p)
+    {
+      if (*p == '\n')
+      {
+        ++line;
+        column = 1;
+      }
+      else
+      {
+        ++column;
+      }
+    }
+
+    std::stringstream ss;
+    ss << "Failed to parse JSON string: " << reason << " at line " << line << ", column " << column;
+    throw Error(Error::Custom, ss.str(), line, column);
+  }
+
+private:
+  const char *begin_;
+  const char *cur_;
+  const char *end_;
+  int depth_;
+
+  inline bool at(char c) const
+  {
+    return cur_ != end_ && *cur_ == c;
+  }
+
+  inline bool at_digit() const
+  {
+    return cur_ != end_ && *cur_ >= '0' && *cur_ <= '9';
+  }
+
+  inline void expect(char c, const char *reason)
+  {
+    if (!at(c))
+    {
+      fail(reason);
+    }
+    ++cur_;
+  }
+
+  inline void skip_whitespace()
+  {
+    while (cur_ != end_ && (*cur_ == ' ' || *cur_ == '\n' || *cur_ == '\r' || *cur_ == '\t'))
+    {
+      ++cur_;
+    }
+  }
+
+  inline void enter()
+  {
+    if (++depth_ > MAX_DEPTH)
+    {
+      fail("maximum nesting depth exceeded");
+    }
+  }
+
+  void read_literal(const char *literal, size_t length)
+  {
+    if (static_cast<size_t>(end_ - cur_) < length || std::memcmp(cur_, literal, length) != 0)
+    {
+      fail("invalid literal");
+    }
+    cur_ += length;
+  }
+
+  /**
+   * Step over a string, validating escape sequences. On return, start points
+   * at the first content byte and cur_ is just past the closing quote.
+   * @return true if the string contains escape sequences
+   */
+  bool scan_string(const char *&start)
+  {
+    expect('"', "expected string");
+    start = cur_;
+    bool escaped = false;
+
+    while (cur_ != end_)
+    {
+      const char c = *cur_;
+      if (c == '"')
+      {
+        ++cur_;
+        return escaped;
+      }
+      if (c == '\\')
+      {
+        escaped = true;
+        ++cur_;
+        if (cur_ == end_)
+        {
+          break;
+        }
+        switch (*cur_)
+        {
+        case '"':
+        case '\\':
+        case '/':
+        case 'b':
+        case 'f':
+        case 'n':
+        case 'r':
+        case 't':
+          ++cur_;
+          break;
+        case 'u':
+          ++cur_;
+          for (int i = 0; i < 4; ++i, ++cur_)
+          {
+            if (cur_ == end_ || !std::isxdigit(static_cast<unsigned char>(*cur_)))
+            {
+              fail("invalid unicode escape sequence");
+            }
+          }
+          break;
+        default:
+          fail("invalid escape sequence");
+        }
+      }
+      else if (static_cast<unsigned char>(c) < 0x20)
+      {
+        fail("unescaped control character in string");
+      }
+      else
+      {
+        ++cur_;
+      }
+    }
+
+    fail("unterminated string");
+  }
+
+  /**
+   * Step over a number, validating the JSON number grammar
+   * @return Pointer to the end of the integer part
+   */
+  const char *scan_number(bool &is_float)
+  {
+    is_float = false;
+    if (at('-'))
+    {
+      ++cur_;
+    }
+    if (!at_digit())
+    {
+      fail("invalid number");
+    }
+    if (at('0'))
+    {
+      ++cur_;
+    }
+    else
+    {
+      while (at_digit())
+        ++cur_;
+    }
+    const char *int_end = cur_;
+
+    if (at('.'))
+    {
+      is_float = true;
+      ++cur_;
+      if (!at_digit())
+      {
+        fail("expected digit after decimal point");
+      }
+      while (at_digit())
+        ++cur_;
+    }
+    if (at('e') || at('E'))
+    {
+      is_float = true;
+      ++cur_;
+      if (at('+') || at('-'))
+      {
+        ++cur_;
+      }
+      if (!at_digit())
+      {
+        fail("expected digit in exponent");
+      }
+      while (at_digit())
+        ++cur_;
+    }
+    return int_end;
+  }
+
+  void read_number(Value &out)
+  {
+    const char *start = cur_;
+    bool is_float = false;
+    const char *int_end = scan_number(is_float);
+
+    if (!is_float)
+    {
+      // Accumulate as a negative value so that LLONG_MIN is representable
+      const bool negative = *start == '-';
+      long long value = 0;
+      bool overflow = false;
+      for (const char *p = negative ? start + 1 : start; p < int_end; ++p)
+      {
+        const int digit = *p - '0';
+        if (value < (std::numeric_limits<long long>::min() + digit) / 10)
+        {
+          overflow = true;
+          break;
+        }
+        value = value * 10 - digit;
+      }
+
+      if (!overflow && (negative || value != std::numeric_limits<long long>::min()))
+      {
+        out.data_ = negative ? value : -value;
+        return;
+      }
+      // Out of range for long long, fall through to double
+    }
+
+    // strtod needs a terminated token; numbers are short so this stays in SSO storage
+    const std::string token(start, cur_ - start);
+    char *endptr = nullptr;
+    const double value = std::strtod(token.c_str(), &endptr);
+    if (endptr != token.c_str() + token.size())
+    {
+      fail("invalid number");
+    }
+    out.data_ = value;
+  }
+};
+
+namespace detail
+{
+// Hook for decode_struct that leaves every member to the field table
+struct NoDecodeHook
+{
+  template <typename T>
+  inline bool operator()(const std::string &key, Reader &reader, T &partial) const
+  {
+    return false;
+  }
+};
+
+template <typename T, typename = void>
+struct has_decode : std::false_type
+{
+};
+
+template <typename T>
+struct has_decode<T, decltype(void(Deserializable<T>::decode(std::declval<Reader &>(), std::declval<NoDecodeHook &>())))> : std::true_type
+{
+};
+} // namespace detail
+
+#if defined(ZJSON_USE_HWTJ)
+inline Value json_handle_to_value(JSON_INSTANCE *instance, KEY_HANDLE *key_handle)
+{
+  try
+  {
+    int type = 0;
+    int rc = ZJSNGJST(instance, key_handle, &type);
+    if (rc != 0)
+    {
+      return Value(); // Return null on error
+    }
+
+    switch (type)
+    {
+    case HWTJ_NULL_TYPE:
+      return Value();
+
+    case HWTJ_BOOLEAN_TYPE:
+    {
+      char bool_val = 0;
+      rc = ZJSMGBOV(instance, key_handle, &bool_val);
+      if (rc != 0)
+      {
+        return Value();
+      }
+      return Value(bool_val == HWTJ_TRUE);
+    }
+
+    case HWTJ_NUMBER_TYPE:
+    {
+      char *value_ptr = 0;
+      int value_length = 0;
+      rc = ZJSMGVAL(instance, key_handle, &value_ptr, &value_length);
+      if (rc != 0)
+      {
+        return Value();
+      }
+      try
+      {
+        std::string str_val(value_ptr, value_length);
+        if (str_val.find('.') != std::string::npos || str_val.find('e') != std::string::npos || str_val.find('E') != std::string::npos)
+        {
+          char *endptr = nullptr;
+          double num_val = std::strtod(str_val.c_str(), &endptr);
+          if (endptr == str_val.c_str() || *endptr != '\0')
+          {
+            return Value();
+          }
+          return Value(num_val);
+        }
+        else
+        {
+          char *endptr = nullptr;
+          long long int_val = std::strtoll(str_val.c_str(), &endptr, 10);
+          if (endptr == str_val.c_str() || *endptr != '\0')
+          {
+            return Value();
+          }
+          return Value(int_val);
+        }
+      }
+      catch (...)
+      {
+        return Value();
       }
     }
 
@@ -1627,6 +2597,7 @@ inline Value json_handle_to_value(JSON_INSTANCE *instance, KEY_HANDLE *key_handl
     return Value();
   }
 }
+#endif
 
 // from_value function - convert Value to any deserializable type
 template <typename T>
@@ -1690,6 +2661,40 @@ zstd::expected<Value, Error> to_value(const T &obj)
 template <typename T>
 zstd::expected<T, Error> from_str(const std::string &json_str)
 {
+#if !defined(ZJSON_USE_HWTJ)
+  try
+  {
+    Reader reader(json_str);
+    if constexpr (detail::has_decode<T>::value)
+    {
+      detail::NoDecodeHook hook;
+      reader.start();
+      auto result = Deserializable<T>::decode(reader, hook);
+      reader.finish();
+      return result;
+    }
+    else
+    {
+      Value parsed = reader.parse();
+      if constexpr (std::is_same<T, Value>::value)
+      {
+        return parsed;
+      }
+      else
+      {
+        return from_value<T>(parsed);
+      }
+    }
+  }
+  catch (const Error &e)
+  {
+    return zstd::make_unexpected(e);
+  }
+  catch (const std::exception &e)
+  {
+    return zstd::make_unexpected(Error(Error::Custom, e.what()));
+  }
+#else
   JSON_INSTANCE instance{};
   int rc = ZJSMINIT(&instance);
   if (rc != 0)
@@ -1725,6 +2730,37 @@ zstd::expected<T, Error> from_str(const std::string &json_str)
     ZJSMTERM(&instance);
     return zstd::make_unexpected(Error(Error::Custom, e.what()));
   }
+#endif
+}
+
+/**
+ * Decode a ZJSON_SERIALIZABLE struct straight from JSON text, letting the
+ * caller intercept members as they are read. The hook is called as
+ * hook(key, reader, partial) for each member of the top-level object and
+ * returns true if it consumed the value from the reader itself; otherwise the
+ * member is decoded through the struct's field table. Always uses the native
+ * reader, regardless of ZJSON_USE_HWTJ.
+ */
+template <typename T, typename Hook>
+zstd::expected<T, Error> from_str(const std::string &json_str, Hook &&hook)
+{
+  static_assert(detail::has_decode<T>::value, "from_str with a hook requires a ZJSON_SERIALIZABLE type");
+  try
+  {
+    Reader reader(json_str);
+    reader.start();
+    auto result = Deserializable<T>::decode(reader, hook);
+    reader.finish();
+    return result;
+  }
+  catch (const Error &e)
+  {
+    return zstd::make_unexpected(e);
+  }
+  catch (const std::exception &e)
+  {
+    return zstd::make_unexpected(Error(Error::Custom, e.what()));
+  }
 }
 
 // Convenience overload: from_str without template parameter defaults to Value
@@ -1733,6 +2769,36 @@ inline zstd::expected<Value, Error> from_str(const std::string &json_str)
   return from_str<Value>(json_str);
 }
 
+// write_to function - append JSON for any serializable type to a caller-supplied buffer or stream
+template <typename Out, typename T>
+zstd::expected<size_t, Error> write_to(Out &out, const T &value, int indent = 0)
+{
+  try
+  {
+    if constexpr (std::is_same<T, Value>::value)
+    {
+      return write_json(out, value, indent);
+    }
+    else
+    {
+      zstd::expected<Value, Error> serialized = to_value(value);
+      if (!serialized.has_value())
+      {
+        return zstd::make_unexpected(serialized.error());
+      }
+      return write_json(out, serialized.value(), indent);
+    }
+  }
+  catch (const Error &e)
+  {
+    return zstd::make_unexpected(e);
+  }
+  catch (const std::exception &e)
+  {
+    return zstd::make_unexpected(Error(Error::Custom, e.what()));
+  }
+}
+
 // Helper function to add indentation to JSON string
 inline std::string add_json_indentation(const std::string &json_str, int spaces)
 {
@@ -1806,6 +2872,15 @@ inline std::string add_json_indentation(const std::string &json_str, int spaces)
 template <typename T>
 zstd::expected<std::string, Error> to_string_pretty(const T &value)
 {
+#if !defined(ZJSON_USE_HWTJ)
+  std::string result;
+  zstd::expected<size_t, Error> written = write_to(result, value, 2);
+  if (!written.has_value())
+  {
+    return zstd::make_unexpected(written.error());
+  }
+  return result;
+#else
   zstd::expected<std::string, Error> result = to_string(value);
   if (!result.has_value())
   {
@@ -1821,8 +2896,18 @@ zstd::expected<std::string, Error> to_string_pretty(const T &value)
   {
     return zstd::make_unexpected(Error(Error::Custom, e.what()));
   }
+#endif
 }
 
+#if !defined(ZJSON_USE_HWTJ)
+// Convert Value to JSON string in a single pass
+inline std::string value_to_json_string(const Value &value)
+{
+  std::string result;
+  write_json(result, value);
+  return result;
+}
+#else
 // Helper function to add Value to JSON instance using ZJSM API
 inline int value_to_json_instance(JSON_INSTANCE *instance, KEY_HANDLE *parent_handle, const std::string &entry_name, const Value &value)
 {
@@ -2052,10 +3137,14 @@ inline std::string value_to_json_string(const Value &value)
     throw Error(Error::Custom, "Unknown exception during JSON serialization");
   }
 }
+#endif
 
-// JSON parser using zjsonm C API
+// Parse a JSON string into a Value, throwing Error on failure
 inline Value parse_json_string(const std::string &json_str)
 {
+#if !defined(ZJSON_USE_HWTJ)
+  return Reader(json_str).parse();
+#else
   JSON_INSTANCE instance{};
   int rc = ZJSMINIT(&instance);
   if (rc != 0)
@@ -2100,6 +3189,7 @@ inline Value parse_json_string(const std::string &json_str)
     ZJSMTERM(&instance);
     throw Error(Error::Custom, "Unknown exception during JSON parsing");
   }
+#endif
 }
 
 /**
@@ -2269,6 +3359,12 @@ inline Value parse_json_string(const std::string &json_str)
       }                                                                                                     \
       return result;                                                                                        \
     }                                                                                                       \
+    template <typename Hook>                                                                                \
+    static zstd::expected<StructType, Error> decode(Reader &reader, Hook &hook)                             \
+    {                                                                                                       \
+      static const auto fields = std::make_tuple(__VA_ARGS__);                                              \
+      return detail::decode_struct<StructType>(reader, hook, fields);                                       \
+    }                                                                                                       \
   };                                                                                                        \
   }                                                                                                         \
   namespace                                                                                                 \
@@ -2502,6 +3598,185 @@ zstd::expected<bool, Error> validate_no_unknown_fields(const std::unordered_map<
   return true;
 }
 
+// Decode a single value straight from the reader, with the same semantics as Deserializable<T>::deserialize
+template <typename FieldType>
+bool decode_value(Reader &reader, FieldType &out)
+{
+  if constexpr (has_decode<FieldType>::value)
+  {
+    NoDecodeHook hook;
+    auto result = Deserializable<FieldType>::decode(reader, hook);
+    if (!result.has_value())
+    {
+      return false;
+    }
+    out = std::move(result.value());
+    return true;
+  }
+  else
+  {
+    if constexpr (std::is_same<FieldType, std::string>::value)
+    {
+      if (reader.peek() == Value::String)
+      {
+        reader.read_string(out);
+        return true;
+      }
+    }
+
+    Value value;
+    reader.read_value(value);
+    auto result = Deserializable<FieldType>::deserialize(value);
+    if (!result.has_value())
+    {
+      return false;
+    }
+    out = std::move(result.value());
+    return true;
+  }
+}
+
+template <size_t I = 0, typename T, typename... Fields>
+bool decode_member(Reader &reader, T &obj, const std::tuple<Fields...> &fields, size_t index)
+{
+  if constexpr (I == sizeof...(Fields))
+  {
+    reader.skip_value();
+    return true;
+  }
+  else
+  {
+    if (index != I)
+    {
+      return decode_member<I + 1>(reader, obj, fields, index);
+    }
+
+    const auto &field = std::get<I>(fields);
+    if (field.skip_deserializing)
+    {
+      reader.skip_value();
+      return true;
+    }
+
+    using FieldType = typename std::decay<decltype(obj.*(field.member))>::type;
+    if constexpr (!Deserializable<FieldType>::value)
+    {
+      reader.skip_value();
+      return false;
+    }
+    else
+    {
+      return decode_value(reader, obj.*(field.member));
+    }
+  }
+}
+
+template <size_t I = 0, typename T, typename... Fields>
+bool decode_missing(T &obj, const std::tuple<Fields...> &fields, const bool *seen)
+{
+  if constexpr (I == sizeof...(Fields))
+  {
+    return true;
+  }
+  else
+  {
+    const auto &field = std::get<I>(fields);
+    using FieldType = typename std::decay<decltype(obj.*(field.member))>::type;
+    if (!seen[I] && !field.skip_deserializing)
+    {
+      if (field.default_value)
+      {
+        obj.*(field.member) = field.default_value();
+      }
+      else if constexpr (is_optional<FieldType>::value)
+      {
+        obj.*(field.member) = FieldType{};
+      }
+      else
+      {
+        return false;
+      }
+    }
+    return decode_missing<I + 1>(obj, fields, seen);
+  }
+}
+
+/**
+ * Decode a ZJSON_SERIALIZABLE struct directly from a Reader without building
+ * an intermediate Value tree for the object.
+ *
+ * The hook sees every member before the field table does and may consume the
+ * value itself by returning true. Structs with flattened fields fall back to
+ * Deserializable<T>::deserialize, in which case the hook is not called.
+ * Errors match Deserializable<T>::deserialize; the reader always consumes the
+ * whole value, so syntax errors later in the input still take precedence.
+ */
+template <typename T, typename Hook, typename... Fields>
+zstd::expected<T, Error> decode_struct(Reader &reader, Hook &hook, const std::tuple<Fields...> &fields)
+{
+  constexpr size_t field_count = sizeof...(Fields);
+  static const bool flattened = std::apply([](const auto &...f)
+                                           { return has_flattened_field(f...); },
+                                           fields);
+  static const std::array<std::string, field_count> names = std::apply([](const auto &...f)
+                                                                       { return std::array<std::string, field_count>{f.get_serialized_name()...}; },
+                                                                       fields);
+
+  if (flattened)
+  {
+    Value value = reader.read_value();
+    return Deserializable<T>::deserialize(value);
+  }
+
+  if (reader.peek() != Value::Object)
+  {
+    reader.skip_value();
+    return zstd::make_unexpected(Error::invalid_type("object", "other"));
+  }
+
+  T result{};
+  bool seen[field_count] = {};
+  bool ok = true;
+  std::string unknown_field;
+
+  reader.read_object([&](std::string &key)
+                     {
+                       size_t index = 0;
+                       while (index < field_count && names[index] != key)
+                       {
+                         ++index;
+                       }
+
+                       if (index == field_count)
+                       {
+                         if (!hook(key, reader, result))
+                         {
+                           if (unknown_field.empty() && StructConfig<T>::deny_unknown_fields)
+                           {
+                             unknown_field = key;
+                           }
+                           reader.skip_value();
+                         }
+                         return;
+                       }
+
+                       seen[index] = true;
+                       if (!hook(key, reader, result) && !decode_member(reader, result, fields, index))
+                       {
+                         ok = false;
+                       } });
+
+  if (!ok || !decode_missing(result, fields, seen))
+  {
+    return zstd::make_unexpected(Error::invalid_data("Failed to deserialize fields"));
+  }
+  if (!unknown_field.empty())
+  {
+    return zstd::make_unexpected(Error::unknown_field(unknown_field));
+  }
+  return result;
+}
+
 } // namespace detail
 
 // Expose helper functions
@@ -12,6 +12,7 @@
 #ifndef ZLOGGER_HPP
 #define ZLOGGER_HPP
 
+#include <atomic>
 #include <cstdio>
 #include <cstdarg>
 #include <string>
@@ -37,10 +38,12 @@ class ZLogger : public Singleton<ZLogger>
 
 private:
   bool m_initialized;
+  // Copy of the Metal C logger's level, so that disabled levels are rejected without a call
+  std::atomic<int> m_level;
 
 protected:
   ZLogger()
-      : m_initialized(false)
+      : m_initialized(false), m_level(ZLOGLEVEL_OFF)
   {
 #ifdef ZLOG_ENABLE
     initialize();
@@ -139,6 +142,7 @@ public:
       std::cerr << "Failed to initialize Metal C logger" << std::endl;
       return;
     }
+    m_level.store(initial_level, std::memory_order_relaxed);
   }
 
   /**
@@ -153,6 +157,7 @@ public:
 
     int level_value = level;
     ZLGSTLVL(&level_value);
+    m_level.store(level_value, std::memory_order_relaxed);
   }
 
   /**
@@ -168,14 +173,20 @@ public:
   }
 
   /**
-   * Log a message at the specified level
+   * Check if messages at `level` are written; a single relaxed load, so the ZLOG_* macros
+   * can skip evaluating their arguments
    */
+  auto is_enabled(LogLevel level) const -> bool
+  {
+    return level != ZLOGLEVEL_OFF && level >= m_level.load(std::memory_order_relaxed);
+  }
+
   /**
    * Internal logging function that takes va_list
    */
   auto vlog(LogLevel level, const char *format, va_list args) -> void
   {
-    if (level == ZLOGLEVEL_OFF || level < get_log_level() || !m_initialized)
+    if (!is_enabled(level))
     {
       return;
     }
@@ -259,21 +270,50 @@ public:
  * Convenience macros for easier logging usage
  * These macros are gated by ZLOG_ENABLE - if not defined during compilation,
  * all logging operations become no-ops with zero overhead.
+ * The level is checked before the arguments are evaluated, and levels below
+ * ZLOG_MIN_LEVEL (0 = TRACE, 1 = DEBUG, 2 = INFO, 3 = WARN, 4 = ERROR) are
+ * compiled out. ZLOG_FATAL is always compiled in.
  */
-#ifdef ZLOG_ENABLE
-#define ZLOG_TRACE(...) ZLogger::get_instance().trace(__VA_ARGS__)
-#define ZLOG_DEBUG(...) ZLogger::get_instance().debug(__VA_ARGS__)
-#define ZLOG_INFO(...) ZLogger::get_instance().info(__VA_ARGS__)
-#define ZLOG_WARN(...) ZLogger::get_instance().warn(__VA_ARGS__)
-#define ZLOG_ERROR(...) ZLogger::get_instance().error(__VA_ARGS__)
-#define ZLOG_FATAL(...) ZLogger::get_instance().fatal(__VA_ARGS__)
+#ifndef ZLOG_MIN_LEVEL
+#define ZLOG_MIN_LEVEL 0
+#endif
+
+#define ZLOG_IF_ENABLED(level, method, ...)                 \
+  do                                                        \
+  {                                                         \
+    if (ZLogger::get_instance().is_enabled(level))          \
+      ZLogger::get_instance().method(__VA_ARGS__);          \
+  } while (0)
+
+#if defined(ZLOG_ENABLE) && ZLOG_MIN_LEVEL <= 0
+#define ZLOG_TRACE(...) ZLOG_IF_ENABLED(ZLOGLEVEL_TRACE, trace, __VA_ARGS__)
 #else
-/* When ZLOG_ENABLE is not defined, logging macros become no-ops */
 #define ZLOG_TRACE(...) ((void)0)
+#endif
+#if defined(ZLOG_ENABLE) && ZLOG_MIN_LEVEL <= 1
+#define ZLOG_DEBUG(...) ZLOG_IF_ENABLED(ZLOGLEVEL_DEBUG, debug, __VA_ARGS__)
+#else
 #define ZLOG_DEBUG(...) ((void)0)
+#endif
+#if defined(ZLOG_ENABLE) && ZLOG_MIN_LEVEL <= 2
+#define ZLOG_INFO(...) ZLOG_IF_ENABLED(ZLOGLEVEL_INFO, info, __VA_ARGS__)
+#else
 #define ZLOG_INFO(...) ((void)0)
+#endif
+#if defined(ZLOG_ENABLE) && ZLOG_MIN_LEVEL <= 3
+#define ZLOG_WARN(...) ZLOG_IF_ENABLED(ZLOGLEVEL_WARN, warn, __VA_ARGS__)
+#else
 #define ZLOG_WARN(...) ((void)0)
+#endif
+#if defined(ZLOG_ENABLE) && ZLOG_MIN_LEVEL <= 4
+#define ZLOG_ERROR(...) ZLOG_IF_ENABLED(ZLOGLEVEL_ERROR, error, __VA_ARGS__)
+#else
 #define ZLOG_ERROR(...) ((void)0)
+#endif
+#ifdef ZLOG_ENABLE
+#define ZLOG_FATAL(...) ZLogger::get_instance().fatal(__VA_ARGS__)
+#else
+/* When ZLOG_ENABLE is not defined, logging macros become no-ops */
 #define ZLOG_FATAL(...) ((void)0)
 #endif /* ZLOG_ENABLE */
 
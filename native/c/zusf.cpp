@@ -1206,18 +1206,18 @@ static int zusf_collect_directory_entries_recursive(ZUSF *zusf, const std::strin
 }
 
 /**
- * Lists the USS file path.
+ * Lists the entries of a USS file path, in the order `ls` would show them.
  *
  * @param zusf pointer to a ZUSF object
  * @param file name of the USS file or directory
- * @param response reference to a std::string where the read data will be stored
- * @param options listing options (all_files, long_format, max_depth)
- * @param use_csv_format whether to use CSV format or ls-style format
+ * @param entries reference to a std::vector where the entries will be stored; on failure, it holds the entries listed so far
+ * @param options listing options (all_files, max_depth)
  *
  * @return RTNCD_SUCCESS on success, RTNCD_FAILURE on failure
  */
-int zusf_list_uss_file_path(ZUSF *zusf, const std::string &file, std::string &response, ListOptions options, bool use_csv_format)
+int zusf_list_uss_entries(ZUSF *zusf, const std::string &file, std::vector<ZUSFEntry> &entries, ListOptions options)
 {
+  entries.clear();
   if (!zusf_is_valid_path(file))
   {
     zusf->diag.e_msg_len = sprintf(zusf->diag.e_msg, "File path is empty or too long");
@@ -1234,8 +1234,7 @@ int zusf_list_uss_file_path(ZUSF *zusf, const std::string &file, std::string &re
   // TODO(zFernand0): Add option to list full file paths
   if (S_ISREG(file_stats.st_mode))
   {
-    const auto file_name = file.substr(file.find_last_of("/") + 1);
-    response = zusf_format_file_entry(zusf, file_stats, file, file_name, options, use_csv_format);
+    entries.push_back(ZUSFEntry{file.substr(file.find_last_of("/") + 1), file, file_stats});
     return RTNCD_SUCCESS;
   }
 
@@ -1245,13 +1244,10 @@ int zusf_list_uss_file_path(ZUSF *zusf, const std::string &file, std::string &re
     return RTNCD_FAILURE;
   }
 
-  response.clear();
-
   // Treat depth == 0 as "ls -d" behavior: show the directory itself, not its contents
   if (options.max_depth == 0)
   {
-    const auto dir_name = file.substr(file.find_last_of("/") + 1);
-    response = zusf_format_file_entry(zusf, file_stats, file, dir_name, options, use_csv_format);
+    entries.push_back(ZUSFEntry{file.substr(file.find_last_of("/") + 1), file, file_stats});
     return RTNCD_SUCCESS;
   }
 
@@ -1259,7 +1255,7 @@ int zusf_list_uss_file_path(ZUSF *zusf, const std::string &file, std::string &re
   if (options.all_files)
   {
     // Add "." entry
-    response += zusf_format_file_entry(zusf, file_stats, file, ".", options, use_csv_format);
+    entries.push_back(ZUSFEntry{".", file, file_stats});
 
     // Add ".." entry if we can stat the parent directory
     std::string parent_path = file.substr(0, file.find_last_of("/"));
@@ -1270,7 +1266,7 @@ int zusf_list_uss_file_path(ZUSF *zusf, const std::string &file, std::string &re
     struct stat parent_stats;
     if (stat(parent_path.c_str(), &parent_stats) == 0)
     {
-      response += zusf_format_file_entry(zusf, parent_stats, parent_path, "..", options, use_csv_format);
+      entries.push_back(ZUSFEntry{"..", parent_path, parent_stats});
     }
   }
 
@@ -1283,23 +1279,49 @@ int zusf_list_uss_file_path(ZUSF *zusf, const std::string &file, std::string &re
   }
 
   // Process sorted entries
+  entries.reserve(entries.size() + entry_names.size());
   for (auto i = 0u; i < entry_names.size(); i++)
   {
-    const auto name = entry_names.at(i);
-    std::string child_path = zusf_join_path(file, name);
-    struct stat child_stats;
-    if (lstat(child_path.c_str(), &child_stats) != 0)
+    ZUSFEntry entry;
+    entry.name = entry_names.at(i);
+    entry.path = zusf_join_path(file, entry.name);
+    if (lstat(entry.path.c_str(), &entry.stats) != 0)
     {
-      zusf->diag.e_msg_len = sprintf(zusf->diag.e_msg, "Could not stat child path '%s'", child_path.c_str());
+      zusf->diag.e_msg_len = sprintf(zusf->diag.e_msg, "Could not stat child path '%s'", entry.path.c_str());
       return RTNCD_FAILURE;
     }
 
-    response += zusf_format_file_entry(zusf, child_stats, child_path, name, options, use_csv_format);
+    entries.push_back(std::move(entry));
   }
 
   return RTNCD_SUCCESS;
 }
 
+/**
+ * Lists the USS file path.
+ *
+ * @param zusf pointer to a ZUSF object
+ * @param file name of the USS file or directory
+ * @param response reference to a std::string where the read data will be stored
+ * @param options listing options (all_files, long_format, max_depth)
+ * @param use_csv_format whether to use CSV format or ls-style format
+ *
+ * @return RTNCD_SUCCESS on success, RTNCD_FAILURE on failure
+ */
+int zusf_list_uss_file_path(ZUSF *zusf, const std::string &file, std::string &response, ListOptions options, bool use_csv_format)
+{
+  std::vector<ZUSFEntry> entries;
+  const int rc = zusf_list_uss_entries(zusf, file, entries, options);
+
+  response.clear();
+  for (const auto &entry : entries)
+  {
+    response += zusf_format_file_entry(zusf, entry.stats, entry.path, entry.name, options, use_csv_format);
+  }
+
+  return rc;
+}
+
 /**
  * Reads data from a USS file.
  *
@@ -1454,86 +1476,48 @@ int zusf_read_from_uss_file_streamed(ZUSF *zusf, const std::string &file, const
   const size_t chunk_size = FIFO_CHUNK_SIZE * 3 / 4;
   std::vector<char> buf(chunk_size);
   size_t bytes_read;
-  std::vector<char> temp_encoded;
-  std::vector<char> left_over;
 
-  // Open iconv descriptor once for all chunks (for stateful encodings like IBM-939)
-  iconv_t cd = (iconv_t)(-1);
+  // Lease an iconv descriptor once for all chunks (for stateful encodings like IBM-939)
   std::string source_encoding;
   if (has_encoding)
   {
     source_encoding = std::strlen(zusf->encoding_opts.source_codepage) > 0 ? std::string(zusf->encoding_opts.source_codepage) : "UTF-8";
-    cd = iconv_open(source_encoding.c_str(), encoding_to_use.c_str());
-    if (cd == (iconv_t)(-1))
-    {
-      zusf->diag.e_msg_len = sprintf(zusf->diag.e_msg, "Cannot open converter from %s to %s", encoding_to_use.c_str(), source_encoding.c_str());
-      return RTNCD_FAILURE;
-    }
   }
-
-  while ((bytes_read = fread(&buf[0], 1, chunk_size, fin)) > 0)
+  IconvGuard iconv_guard(has_encoding ? source_encoding.c_str() : nullptr, has_encoding ? encoding_to_use.c_str() : nullptr);
+  if (has_encoding && !iconv_guard.is_valid())
   {
-    int chunk_len = bytes_read;
-    const char *chunk = &buf[0];
-
-    if (has_encoding)
-    {
-      try
-      {
-        temp_encoded = zut_encode(chunk, chunk_len, cd, zusf->diag);
-        chunk = &temp_encoded[0];
-        chunk_len = temp_encoded.size();
-      }
-      catch (std::exception &e)
-      {
-        iconv_close(cd);
-        zusf->diag.e_msg_len = sprintf(zusf->diag.e_msg, "Failed to convert input data from %s to %s", encoding_to_use.c_str(), source_encoding.c_str());
-        return RTNCD_FAILURE;
-      }
-    }
-
-    *content_len += chunk_len;
-    temp_encoded = zbase64::encode(chunk, chunk_len, &left_over);
-    fwrite(&temp_encoded[0], 1, temp_encoded.size(), fout);
-    temp_encoded.clear();
+    zusf->diag.e_msg_len = sprintf(zusf->diag.e_msg, "Cannot open converter from %s to %s", encoding_to_use.c_str(), source_encoding.c_str());
+    return RTNCD_FAILURE;
   }
 
-  // Flush the shift state for stateful encodings after all chunks are processed
-  if (has_encoding && cd != (iconv_t)(-1))
+  // Transcode and Base64-encode each chunk straight into the output pipe
+  Base64ReadPipeline pipeline(fout, has_encoding ? &iconv_guard : nullptr);
+  while ((bytes_read = fread(&buf[0], 1, chunk_size, fin)) > 0)
   {
     try
     {
-      // Flush the shift state
-      std::vector<char> flush_buffer = zut_iconv_flush(cd, zusf->diag);
-      if (flush_buffer.empty() && zusf->diag.e_msg_len > 0)
-      {
-        iconv_close(cd);
-        return RTNCD_FAILURE;
-      }
-
-      // Write any shift sequence bytes that were generated
-      if (!flush_buffer.empty())
-      {
-        *content_len += flush_buffer.size();
-        temp_encoded = zbase64::encode(&flush_buffer[0], flush_buffer.size(), &left_over);
-        fwrite(&temp_encoded[0], 1, temp_encoded.size(), fout);
-      }
+      pipeline.write(&buf[0], bytes_read);
     }
     catch (std::exception &e)
     {
-      iconv_close(cd);
-      zusf->diag.e_msg_len = sprintf(zusf->diag.e_msg, "Failed to flush encoding state");
+      zusf->diag.e_msg_len = sprintf(zusf->diag.e_msg, "Failed to convert input data from %s to %s", encoding_to_use.c_str(), source_encoding.c_str());
       return RTNCD_FAILURE;
     }
-
-    iconv_close(cd);
   }
 
-  if (!left_over.empty())
+  // Flush the shift state for stateful encodings after all chunks are processed
+  try
   {
-    temp_encoded = zbase64::encode(&left_over[0], left_over.size());
-    fwrite(&temp_encoded[0], 1, temp_encoded.size(), fout);
+    pipeline.flush_transcoder();
   }
+  catch (std::exception &e)
+  {
+    zusf->diag.e_msg_len = sprintf(zusf->diag.e_msg, "Failed to flush encoding state");
+    return RTNCD_FAILURE;
+  }
+
+  pipeline.finish();
+  *content_len += pipeline.content_length();
 
   fflush(fout);
   return RTNCD_SUCCESS;
@@ -1732,41 +1716,40 @@ int zusf_write_to_uss_file_streamed(ZUSF *zusf, const std::string &file, const s
   std::vector<char> buf(FIFO_CHUNK_SIZE);
   size_t bytes_read;
   std::vector<char> temp_encoded;
-  std::vector<char> left_over;
+  zbase64::Decoder base64_decoder;
+  std::vector<char> decoded;
   bool truncated = false;
 
-  // Open iconv descriptor once for all chunks (for stateful encodings like IBM-939)
-  iconv_t cd = (iconv_t)(-1);
+  // Lease an iconv descriptor once for all chunks (for stateful encodings like IBM-939)
   std::string source_encoding;
   if (has_encoding)
   {
     source_encoding = std::strlen(zusf->encoding_opts.source_codepage) > 0 ? std::string(zusf->encoding_opts.source_codepage) : "UTF-8";
-    cd = iconv_open(encoding_to_use.c_str(), source_encoding.c_str());
-    if (cd == (iconv_t)(-1))
-    {
-      zusf->diag.e_msg_len = sprintf(zusf->diag.e_msg, "Cannot open converter from %s to %s", source_encoding.c_str(), encoding_to_use.c_str());
-      return RTNCD_FAILURE;
-    }
   }
+  IconvGuard iconv_guard(has_encoding ? encoding_to_use.c_str() : nullptr, has_encoding ? source_encoding.c_str() : nullptr);
+  if (has_encoding && !iconv_guard.is_valid())
+  {
+    zusf->diag.e_msg_len = sprintf(zusf->diag.e_msg, "Cannot open converter from %s to %s", source_encoding.c_str(), encoding_to_use.c_str());
+    return RTNCD_FAILURE;
+  }
+  iconv_t cd = iconv_guard.get();
 
   while ((bytes_read = fread(&buf[0], 1, FIFO_CHUNK_SIZE, fin)) > 0)
   {
-    temp_encoded = zbase64::decode(&buf[0], bytes_read, &left_over);
-    const char *chunk = &temp_encoded[0];
-    int chunk_len = temp_encoded.size();
+    int chunk_len = base64_decoder.update(&buf[0], bytes_read, decoded);
+    const char *chunk = decoded.data();
     *content_len += chunk_len;
 
     if (has_encoding)
     {
       try
       {
-        temp_encoded = zut_encode(chunk, chunk_len, cd, zusf->diag);
+        temp_encoded = zut_encode(chunk, chunk_len, iconv_guard, zusf->diag);
         chunk = &temp_encoded[0];
         chunk_len = temp_encoded.size();
       }
       catch (std::exception &e)
       {
-        iconv_close(cd);
         zusf->diag.e_msg_len = sprintf(zusf->diag.e_msg, "Failed to convert input data from %s to %s", source_encoding.c_str(), encoding_to_use.c_str());
         return RTNCD_FAILURE;
       }
@@ -1790,7 +1773,6 @@ int zusf_write_to_uss_file_streamed(ZUSF *zusf, const std::string &file, const s
       std::vector<char> flush_buffer = zut_iconv_flush(cd, zusf->diag);
       if (flush_buffer.empty() && zusf->diag.e_msg_len > 0)
       {
-        iconv_close(cd);
         return RTNCD_FAILURE;
       }
 
@@ -1806,12 +1788,9 @@ int zusf_write_to_uss_file_streamed(ZUSF *zusf, const std::string &file, const s
     }
     catch (std::exception &e)
     {
-      iconv_close(cd);
       zusf->diag.e_msg_len = sprintf(zusf->diag.e_msg, "Failed to flush encoding state");
       return RTNCD_FAILURE;
     }
-
-    iconv_close(cd);
   }
 
   const int flush_rc = fflush(fout);
@@ -18,6 +18,7 @@
 #include <grp.h>
 #include <pwd.h>
 #include <string>
+#include <vector>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include "zusftype.h"
@@ -49,11 +50,19 @@ struct ListOptions
   }
 };
 
+struct ZUSFEntry
+{
+  std::string name; // Name as listed, relative to the listed directory
+  std::string path; // Full path of the file
+  struct stat stats;
+};
+
 int zusf_copy_file_or_dir(ZUSF *zusf, const std::string &source_fs, const std::string &dest_fs, const CopyOptions &options);
 int zusf_create_uss_file_or_dir(ZUSF *zusf, const std::string &file, mode_t mode, bool createDir);
 int zusf_move_uss_file_or_dir(ZUSF *zusf, const std::string &source, const std::string &target, bool force = true);
 std::string zusf_format_file_entry(ZUSF *zusf, const struct stat &file_stats, const std::string &file_path, const std::string &display_name, ListOptions options, bool use_csv_format);
 int zusf_list_uss_file_path(ZUSF *zusf, const std::string &file, std::string &response, ListOptions options = ListOptions{}, bool use_csv_format = false);
+int zusf_list_uss_entries(ZUSF *zusf, const std::string &file, std::vector<ZUSFEntry> &entries, ListOptions options = ListOptions{});
 int zusf_read_from_uss_file(ZUSF *zusf, const std::string &file, std::string &response);
 int zusf_read_from_uss_file_streamed(ZUSF *zusf, const std::string &file, const std::string &pipe, size_t *content_len);
 int zusf_write_to_uss_file(ZUSF *zusf, const std::string &file, std::string &data);
@@ -69,5 +78,6 @@ int zusf_get_ccsid_from_display_name(const std::string &display_name);
 std::string zusf_get_owner_from_uid(uid_t uid);
 std::string zusf_get_group_from_gid(gid_t gid);
 std::string zusf_format_ls_time(time_t mtime, bool use_csv_format = false);
+std::string zusf_build_mode_string(mode_t mode);
 
 #endif
@@ -802,6 +802,336 @@ std::vector<char> zut_iconv_flush(iconv_t cd, ZDIAG &diag)
   return output_buffer;
 }
 
+IconvCache::~IconvCache()
+{
+  clear();
+}
+
+iconv_t IconvCache::acquire(const std::string &to_code, const std::string &from_code)
+{
+  iconv_t cd = (iconv_t)(-1);
+  iconv_t evicted = (iconv_t)(-1);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto it = idle.begin(); it != idle.end(); ++it)
+    {
+      if (it->to_code == to_code && it->from_code == from_code)
+      {
+        cd = it->cd;
+        idle.erase(it);
+        break;
+      }
+    }
+
+    if (cd != (iconv_t)(-1))
+    {
+      stats.hits++;
+    }
+    else
+    {
+      stats.misses++;
+      // Make room by closing the idle descriptor that has gone unused the longest
+      if (stats.open >= capacity && !idle.empty())
+      {
+        evicted = idle.back().cd;
+        idle.pop_back();
+        stats.open--;
+        stats.evictions++;
+      }
+    }
+  }
+
+  if (evicted != (iconv_t)(-1))
+  {
+    iconv_close(evicted);
+  }
+
+  if (cd != (iconv_t)(-1))
+  {
+    // Discard any shift state left by the previous lease
+    iconv(cd, nullptr, nullptr, nullptr, nullptr);
+    return cd;
+  }
+
+  cd = iconv_open(to_code.c_str(), from_code.c_str());
+  if (cd != (iconv_t)(-1))
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.open++;
+  }
+  return cd;
+}
+
+void IconvCache::release(const std::string &to_code, const std::string &from_code, iconv_t cd)
+{
+  if (cd == (iconv_t)(-1))
+  {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    // Descriptors opened while every cached one was leased are closed instead of kept
+    if (stats.open <= capacity)
+    {
+      idle.push_front(IdleEntry{to_code, from_code, cd});
+      return;
+    }
+    stats.open--;
+  }
+  iconv_close(cd);
+}
+
+IconvCache::Stats IconvCache::get_stats()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return stats;
+}
+
+void IconvCache::clear()
+{
+  std::list<IdleEntry> closing;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    closing.swap(idle);
+    stats.open -= closing.size();
+  }
+
+  for (const auto &entry : closing)
+  {
+    iconv_close(entry.cd);
+  }
+}
+
+size_t CodepageTable::output_size(const char *input, size_t input_size) const
+{
+  const unsigned char *src = reinterpret_cast<const unsigned char *>(input);
+  if (kind == SingleByteToUtf8)
+  {
+    size_t size = 0;
+    for (size_t i = 0; i < input_size; ++i)
+    {
+      if (length[src[i]] == 0)
+      {
+        return npos;
+      }
+      size += length[src[i]];
+    }
+    return size;
+  }
+
+  if (!complete)
+  {
+    for (size_t i = 0; i < input_size; ++i)
+    {
+      if (length[src[i]] == 0)
+      {
+        return npos;
+      }
+    }
+  }
+  return input_size;
+}
+
+void CodepageTable::convert(const char *input, size_t input_size, char *output) const
+{
+  const unsigned char *src = reinterpret_cast<const unsigned char *>(input);
+  unsigned char *dst = reinterpret_cast<unsigned char *>(output);
+  if (kind == SingleByteToUtf8)
+  {
+    for (size_t i = 0; i < input_size; ++i)
+    {
+      const unsigned char len = length[src[i]];
+      std::memcpy(dst, sequence[src[i]], len);
+      dst += len;
+    }
+    return;
+  }
+
+  // Independent lookups, 8 at a time, so the loads can overlap
+  size_t i = 0;
+  for (; i + 8 <= input_size; i += 8)
+  {
+    dst[i] = single[src[i]];
+    dst[i + 1] = single[src[i + 1]];
+    dst[i + 2] = single[src[i + 2]];
+    dst[i + 3] = single[src[i + 3]];
+    dst[i + 4] = single[src[i + 4]];
+    dst[i + 5] = single[src[i + 5]];
+    dst[i + 6] = single[src[i + 6]];
+    dst[i + 7] = single[src[i + 7]];
+  }
+  for (; i < input_size; ++i)
+  {
+    dst[i] = single[src[i]];
+  }
+}
+
+/**
+ * Maps a codepage name to its CCSID, e.g. "IBM-1047", "1047" and "CP1047" to 1047,
+ * "ISO8859-1" to 819 and "UTF-8" to 1208.
+ *
+ * @return the CCSID, or 0 if the name is not recognized
+ */
+static int codepage_ccsid(std::string name)
+{
+  std::transform(name.begin(), name.end(), name.begin(), ::toupper);
+  if (name == "UTF-8" || name == "UTF8")
+  {
+    return 1208;
+  }
+  if (name == "ISO8859-1" || name == "ISO-8859-1")
+  {
+    return 819;
+  }
+
+  for (const char *prefix : {"IBM-", "IBM", "CP"})
+  {
+    if (name.compare(0, strlen(prefix), prefix) == 0)
+    {
+      name.erase(0, strlen(prefix));
+      break;
+    }
+  }
+  if (name.empty() || name.size() > 5 || name.find_first_not_of("0123456789") != std::string::npos)
+  {
+    return 0;
+  }
+  return atoi(name.c_str());
+}
+
+/**
+ * Whether a CCSID is a stateless single-byte codepage that can be table-driven:
+ * the common EBCDIC Latin pages (with and without Euro) and ISO/PC Latin pages.
+ */
+static bool is_single_byte_ccsid(int ccsid)
+{
+  static const int single_byte_ccsids[] = {37, 273, 277, 278, 280, 284, 285, 297, 500, 871, 1047, 924,
+                                           1140, 1141, 1142, 1143, 1144, 1145, 1146, 1147, 1148, 1149,
+                                           437, 819, 850, 923, 1252};
+  for (int candidate : single_byte_ccsids)
+  {
+    if (candidate == ccsid)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+const CodepageTable *CodepageTableRegistry::find(const std::string &to_code, const std::string &from_code)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  const auto key = std::make_pair(to_code, from_code);
+  auto it = tables.find(key);
+  if (it == tables.end())
+  {
+    it = tables.emplace(key, build(to_code, from_code)).first;
+  }
+  return it->second.get();
+}
+
+std::unique_ptr<CodepageTable> CodepageTableRegistry::build(const std::string &to_code, const std::string &from_code)
+{
+  const int to_ccsid = codepage_ccsid(to_code);
+  const int from_ccsid = codepage_ccsid(from_code);
+
+  std::unique_ptr<CodepageTable> table(new CodepageTable());
+  if (is_single_byte_ccsid(from_ccsid) && is_single_byte_ccsid(to_ccsid))
+  {
+    table->kind = CodepageTable::SingleByte;
+  }
+  else if (is_single_byte_ccsid(from_ccsid) && to_ccsid == 1208)
+  {
+    table->kind = CodepageTable::SingleByteToUtf8;
+  }
+  else if (from_ccsid == 1208 && is_single_byte_ccsid(to_ccsid))
+  {
+    table->kind = CodepageTable::AsciiFromUtf8;
+  }
+  else
+  {
+    return nullptr;
+  }
+
+  iconv_t cd = iconv_open(to_code.c_str(), from_code.c_str());
+  if (cd == (iconv_t)(-1))
+  {
+    return nullptr;
+  }
+
+  // Convert each byte on its own; bytes iconv rejects stay uncovered so that input
+  // containing them still goes through iconv and fails the same way
+  const int byte_count = table->kind == CodepageTable::AsciiFromUtf8 ? 0x80 : 256;
+  const size_t max_length = table->kind == CodepageTable::SingleByteToUtf8 ? 4 : 1;
+  bool supported = true;
+  table->complete = byte_count == 256;
+  std::memset(table->length, 0, sizeof(table->length));
+  std::memset(table->single, 0, sizeof(table->single));
+  std::memset(table->sequence, 0, sizeof(table->sequence));
+  for (int byte = 0; byte < byte_count && supported; ++byte)
+  {
+    char in = static_cast<char>(byte);
+    char out[8];
+    char *in_ptr = &in;
+    char *out_ptr = out;
+    size_t in_left = 1;
+    size_t out_left = sizeof(out);
+
+    iconv(cd, nullptr, nullptr, nullptr, nullptr);
+    const size_t rc = iconv(cd, &in_ptr, &in_left, &out_ptr, &out_left);
+    if (rc == (size_t)-1 || in_left != 0 || iconv(cd, nullptr, nullptr, &out_ptr, &out_left) == (size_t)-1)
+    {
+      table->complete = false;
+      continue;
+    }
+
+    const size_t length = out_ptr - out;
+    if (length == 0 || length > max_length)
+    {
+      // Not a single-byte mapping after all
+      supported = false;
+      break;
+    }
+    table->length[byte] = static_cast<unsigned char>(length);
+    table->single[byte] = static_cast<unsigned char>(out[0]);
+    std::memcpy(table->sequence[byte], out, length);
+  }
+  iconv_close(cd);
+
+  if (!supported)
+  {
+    return nullptr;
+  }
+  return table;
+}
+
+/**
+ * Converts input with a codepage table when the table covers every input byte.
+ *
+ * @return true if the input was converted into output
+ */
+static bool zut_encode_with_table(const CodepageTable *table, const char *input_str, size_t input_size, std::vector<char> &output)
+{
+  if (table == nullptr)
+  {
+    return false;
+  }
+
+  const size_t output_size = table->output_size(input_str, input_size);
+  if (output_size == CodepageTable::npos)
+  {
+    return false;
+  }
+
+  output.resize(output_size);
+  if (output_size > 0)
+  {
+    table->convert(input_str, input_size, &output[0]);
+  }
+  return true;
+}
+
 /**
  * Converts the encoding for a string from one codepage to another.
  * @param input_str input data to convert
@@ -835,8 +1165,15 @@ std::vector<char> zut_encode(const char *input_str, const size_t input_size, con
     return std::vector<char>(input_str, input_str + input_size);
   }
 
-  iconv_t cd = iconv_open(to_encoding.c_str(), from_encoding.c_str());
-  if (cd == (iconv_t)(-1))
+  // Convert common single-byte pairs with a table, sized exactly
+  std::vector<char> table_output;
+  if (zut_encode_with_table(CodepageTableRegistry::get_instance().find(to_encoding, from_encoding), input_str, input_size, table_output))
+  {
+    return table_output;
+  }
+
+  IconvGuard iconv_guard(to_encoding.c_str(), from_encoding.c_str());
+  if (!iconv_guard.is_valid())
   {
     diag.e_msg_len = sprintf(diag.e_msg, "Cannot open converter from %s to %s", from_encoding.c_str(), to_encoding.c_str());
     return std::vector<char>();
@@ -852,8 +1189,7 @@ std::vector<char> zut_encode(const char *input_str, const size_t input_size, con
   char *output_iter = &output_buffer[0];
 
   ZConvData data = {input, input_size, max_output_size, &output_buffer[0], output_iter};
-  size_t iconv_rc = zut_iconv(cd, data, diag);
-  iconv_close(cd);
+  size_t iconv_rc = zut_iconv(iconv_guard.get(), data, diag);
   if (-1 == iconv_rc)
   {
     throw std::runtime_error(diag.e_msg);
@@ -903,6 +1239,148 @@ std::vector<char> zut_encode(const char *input_str, const size_t input_size, ico
   return output_buffer;
 }
 
+/**
+ * Converts the encoding for a string using a leased iconv descriptor, or the codepage
+ * table for the pair when it covers the input.
+ * @param input_str input data to convert
+ * @param iconv_guard leased iconv descriptor
+ * @param diag diagnostic structure to store error information
+ */
+std::string zut_encode(const std::string &input_str, const IconvGuard &iconv_guard, ZDIAG &diag)
+{
+  std::vector<char> result = zut_encode(input_str.data(), input_str.size(), iconv_guard, diag);
+  return std::string(result.begin(), result.end());
+}
+
+/**
+ * Converts the encoding for a string using a leased iconv descriptor, or the codepage
+ * table for the pair when it covers the input.
+ * @param input_str input data to convert
+ * @param input_size size of the input data in bytes
+ * @param iconv_guard leased iconv descriptor
+ * @param diag diagnostic structure to store error information
+ */
+std::vector<char> zut_encode(const char *input_str, const size_t input_size, const IconvGuard &iconv_guard, ZDIAG &diag)
+{
+  std::vector<char> output;
+  if (zut_encode_with_table(iconv_guard.table(), input_str, input_size, output))
+  {
+    return output;
+  }
+  return zut_encode(input_str, input_size, iconv_guard.get(), diag);
+}
+
+Base64ReadPipeline::Base64ReadPipeline(FILE *sink, const IconvGuard *transcoder)
+    : sink_(sink), transcoder_(transcoder), transcoded_(block_size), encoded_(zbase64::Encoder::max_output_size(block_size)), content_length_(0)
+{
+}
+
+void Base64ReadPipeline::write(const char *data, size_t size)
+{
+  if (transcoder_ == nullptr)
+  {
+    for (size_t offset = 0; offset < size; offset += block_size)
+    {
+      encode(data + offset, std::min(block_size, size - offset));
+    }
+    return;
+  }
+
+  const CodepageTable *table = transcoder_->table();
+  if (table == nullptr)
+  {
+    transcode_with_iconv(data, size);
+    return;
+  }
+
+  // Single-byte tables map and encode each byte in one pass, skipping the stage buffer
+  const unsigned char *byte_map = table->byte_map();
+  if (byte_map != nullptr)
+  {
+    for (size_t offset = 0; offset < size; offset += block_size)
+    {
+      const char *block = data + offset;
+      const size_t block_len = std::min(block_size, size - offset);
+      if (table->output_size(block, block_len) == CodepageTable::npos)
+      {
+        transcode_with_iconv(block, block_len);
+        continue;
+      }
+
+      content_length_ += block_len;
+      const size_t encoded_len = encoder_.update_mapped(block, block_len, byte_map, &encoded_[0]);
+      fwrite(&encoded_[0], 1, encoded_len, sink_);
+    }
+    return;
+  }
+
+  // Transcode each block with the table into the stage buffer, then encode it right away
+  const size_t table_block_size = block_size / table->max_expansion();
+  for (size_t offset = 0; offset < size; offset += table_block_size)
+  {
+    const char *block = data + offset;
+    const size_t block_len = std::min(table_block_size, size - offset);
+    const size_t transcoded_len = table->output_size(block, block_len);
+    if (transcoded_len == CodepageTable::npos)
+    {
+      transcode_with_iconv(block, block_len);
+      continue;
+    }
+
+    table->convert(block, block_len, &transcoded_[0]);
+    encode(&transcoded_[0], transcoded_len);
+  }
+}
+
+void Base64ReadPipeline::transcode_with_iconv(const char *data, size_t size)
+{
+  char *input = const_cast<char *>(data);
+  size_t input_left = size;
+  while (input_left > 0)
+  {
+    char *output = &transcoded_[0];
+    size_t output_left = transcoded_.size();
+    const size_t rc = iconv(transcoder_->get(), &input, &input_left, &output, &output_left);
+    const size_t transcoded_len = output - &transcoded_[0];
+
+    // E2BIG only means the stage buffer is full; encode it and convert the rest
+    if (rc == (size_t)-1 && (errno != E2BIG || transcoded_len == 0))
+    {
+      throw std::runtime_error("[Base64ReadPipeline] Error when converting characters. errno=" + std::to_string(errno));
+    }
+    encode(&transcoded_[0], transcoded_len);
+  }
+}
+
+void Base64ReadPipeline::flush_transcoder()
+{
+  if (transcoder_ == nullptr || !transcoder_->is_valid())
+  {
+    return;
+  }
+
+  char *output = &transcoded_[0];
+  size_t output_left = transcoded_.size();
+  if (iconv(transcoder_->get(), nullptr, nullptr, &output, &output_left) == (size_t)-1)
+  {
+    throw std::runtime_error("[Base64ReadPipeline] Error flushing shift state. errno=" + std::to_string(errno));
+  }
+  encode(&transcoded_[0], output - &transcoded_[0]);
+}
+
+void Base64ReadPipeline::finish()
+{
+  char tail[4];
+  fwrite(tail, 1, encoder_.finish(tail), sink_);
+}
+
+void Base64ReadPipeline::encode(const char *data, size_t size)
+{
+  content_length_ += size;
+  const size_t encoded_len = encoder_.update(data, size, &encoded_[0]);
+  fwrite(&encoded_[0], 1, encoded_len, sink_);
+}
+
 std::string &zut_rtrim(std::string &s, const char *t)
 {
   return s.erase(s.find_last_not_of(t) + 1);
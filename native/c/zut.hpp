@@ -15,9 +15,15 @@
 #include <sstream>
 #include <ostream>
 #include <iconv.h>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <string>
 #include "ztype.h"
+#include "singleton.hpp"
+#include "zbase64.h"
 
 /**
  * @struct ZConvData
@@ -251,6 +257,20 @@ std::string zut_encode(const std::string &input_str, iconv_t cd, ZDIAG &diag);
 
 std::vector<char> zut_encode(const char *input_str, const size_t input_size, iconv_t cd, ZDIAG &diag);
 
+class IconvGuard;
+
+/**
+ * @brief Encode a string using a leased iconv descriptor, converting with the codepage
+ * table for the pair when there is one
+ * @param input_str The input string
+ * @param iconv_guard Leased iconv descriptor
+ * @param diag Reference to diagnostic information structure
+ * @return The encoded string
+ */
+std::string zut_encode(const std::string &input_str, const IconvGuard &iconv_guard, ZDIAG &diag);
+
+std::vector<char> zut_encode(const char *input_str, const size_t input_size, const IconvGuard &iconv_guard, ZDIAG &diag);
+
 /**
  * @brief Format a vector of strings as a CSV line
  * @param fields Vector of fields
@@ -441,31 +461,165 @@ public:
   DiagMsgGuard &operator=(const DiagMsgGuard &) = delete;
 };
 
+/**
+ * Process-wide cache of open iconv descriptors keyed by (to, from) codepage pair.
+ * Opening a converter is far more expensive than a conversion, so descriptors are
+ * leased out reset to their initial shift state and kept open after they are returned.
+ * At most `capacity` descriptors stay open; the least recently returned idle one is
+ * closed first. Thread-safe.
+ */
+class IconvCache : public Singleton<IconvCache>
+{
+  friend class Singleton<IconvCache>;
+
+public:
+  struct Stats
+  {
+    unsigned long long hits;      // Leases served by an idle descriptor
+    unsigned long long misses;    // Leases that had to open a descriptor
+    unsigned long long evictions; // Idle descriptors closed to stay within capacity
+    size_t open;                  // Descriptors currently open, leased or idle
+  };
+
+  static const size_t capacity = 32;
+
+  /**
+   * Lease a descriptor converting from `from_code` to `to_code`
+   * @return The descriptor, or (iconv_t)(-1) if the converter cannot be opened
+   */
+  iconv_t acquire(const std::string &to_code, const std::string &from_code);
+
+  // Return a leased descriptor to the cache
+  void release(const std::string &to_code, const std::string &from_code, iconv_t cd);
+
+  Stats get_stats();
+
+  // Close all idle descriptors
+  void clear();
+
+private:
+  struct IdleEntry
+  {
+    std::string to_code;
+    std::string from_code;
+    iconv_t cd;
+  };
+
+  std::mutex mutex;
+  std::list<IdleEntry> idle; // Most recently returned first
+  Stats stats = {0, 0, 0, 0};
+
+  IconvCache() = default;
+  ~IconvCache();
+};
+
+/**
+ * Precomputed conversion for a pair of stateless codepages: single-byte to single-byte,
+ * single-byte to UTF-8, or ASCII-only UTF-8 to single-byte. Tables are built by running
+ * every byte through iconv, so the output is identical to iconv's.
+ */
+class CodepageTable
+{
+  friend class CodepageTableRegistry;
+
+public:
+  enum Kind
+  {
+    SingleByte,       // One output byte per input byte
+    SingleByteToUtf8, // One to four output bytes per input byte
+    AsciiFromUtf8     // Only input bytes below 0x80 are covered
+  };
+
+  static const size_t npos = static_cast<size_t>(-1);
+
+  /**
+   * Exact size of the converted input
+   * @return The size in bytes, or npos when the input has a byte the table does not
+   * cover and iconv must convert it instead
+   */
+  size_t output_size(const char *input, size_t input_size) const;
+
+  // Convert input into output, which must hold output_size(input, input_size) bytes
+  void convert(const char *input, size_t input_size, char *output) const;
+
+  // Most output bytes for one input byte
+  size_t max_expansion() const
+  {
+    return kind == SingleByteToUtf8 ? 4 : 1;
+  }
+
+  // Output byte for each input byte for single-byte kinds, or nullptr for SingleByteToUtf8;
+  // bytes the table does not cover map to 0, so check output_size() first
+  const unsigned char *byte_map() const
+  {
+    return kind == SingleByteToUtf8 ? nullptr : single;
+  }
+
+private:
+  Kind kind;
+  bool complete;                  // Every input byte is covered
+  unsigned char length[256];      // Output bytes for each input byte; 0 when not covered
+  unsigned char single[256];      // Output byte for single-byte kinds
+  unsigned char sequence[256][4]; // Output bytes for SingleByteToUtf8
+};
+
+/**
+ * Process-wide registry of codepage tables, built on first use for each (to, from) pair.
+ * Only stateless single-byte EBCDIC and ASCII codepages and UTF-8 are considered; DBCS
+ * and stateful codepages such as IBM-939 are always left to iconv. Thread-safe.
+ */
+class CodepageTableRegistry : public Singleton<CodepageTableRegistry>
+{
+  friend class Singleton<CodepageTableRegistry>;
+
+public:
+  // Table converting from `from_code` to `to_code`, or nullptr when iconv must be used
+  const CodepageTable *find(const std::string &to_code, const std::string &from_code);
+
+private:
+  std::mutex mutex;
+  // Pairs that need iconv are stored as nullptr so they are probed only once
+  std::map<std::pair<std::string, std::string>, std::unique_ptr<CodepageTable>> tables;
+
+  CodepageTableRegistry() = default;
+  std::unique_ptr<CodepageTable> build(const std::string &to_code, const std::string &from_code);
+};
+
 /**
  * RAII helper class to manage iconv descriptor lifecycle.
- * Automatically closes the iconv descriptor on destruction, ensuring proper cleanup
- * even in error paths.
+ * Leases the descriptor from IconvCache and returns it on destruction, ensuring proper
+ * cleanup even in error paths.
  */
 class IconvGuard
 {
   iconv_t cd_;
+  std::string to_code_;
+  std::string from_code_;
+  const CodepageTable *table_;
 
 public:
   IconvGuard()
-      : cd_((iconv_t)(-1))
+      : cd_((iconv_t)(-1)), table_(nullptr)
   {
   }
 
   explicit IconvGuard(const char *to_code, const char *from_code)
-      : cd_((to_code && from_code) ? iconv_open(to_code, from_code) : (iconv_t)(-1))
+      : cd_((iconv_t)(-1)), table_(nullptr)
   {
+    if (to_code && from_code)
+    {
+      to_code_ = to_code;
+      from_code_ = from_code;
+      cd_ = IconvCache::get_instance().acquire(to_code_, from_code_);
+      table_ = CodepageTableRegistry::get_instance().find(to_code_, from_code_);
+    }
   }
 
   ~IconvGuard()
   {
     if (cd_ != (iconv_t)(-1))
     {
-      iconv_close(cd_);
+      IconvCache::get_instance().release(to_code_, from_code_, cd_);
     }
   }
 
@@ -479,11 +633,72 @@ public:
     return cd_ != (iconv_t)(-1);
   }
 
+  // Table for the codepage pair, or nullptr when only iconv can convert it
+  const CodepageTable *table() const
+  {
+    return table_;
+  }
+
   // Non-copyable
   IconvGuard(const IconvGuard &) = delete;
   IconvGuard &operator=(const IconvGuard &) = delete;
 };
 
+/**
+ * Streaming read pipeline: source chunk -> transcode (optional) -> Base64 -> FILE sink.
+ * Stages hand data to each other through fixed buffers that are reused for every chunk,
+ * and chunks are processed in blocks small enough to stay in cache. Single-byte codepage
+ * tables are applied inside the Base64 loop, so those blocks are read once and never
+ * stored transcoded; UTF-8 tables and iconv transcode into the stage buffer first.
+ */
+class Base64ReadPipeline
+{
+public:
+  /**
+   * @param sink Stream that receives the Base64 text
+   * @param transcoder Leased converter for text data, or nullptr to encode bytes as they are
+   */
+  explicit Base64ReadPipeline(FILE *sink, const IconvGuard *transcoder = nullptr);
+
+  /**
+   * Transcode and encode one chunk from the source
+   * @throws std::runtime_error if the chunk cannot be converted
+   */
+  void write(const char *data, size_t size);
+
+  /**
+   * Encode the bytes that return a stateful converter to its initial shift state; call
+   * once after the last chunk
+   * @throws std::runtime_error if the shift state cannot be flushed
+   */
+  void flush_transcoder();
+
+  // Write the last partial Base64 group with its padding
+  void finish();
+
+  // Bytes passed to the Base64 stage so far, i.e. the size of the transcoded content
+  size_t content_length() const
+  {
+    return content_length_;
+  }
+
+private:
+  static constexpr size_t block_size = 16 * 1024;
+
+  FILE *sink_;
+  const IconvGuard *transcoder_;
+  zbase64::Encoder encoder_;
+  std::vector<char> transcoded_; // Transcode -> Base64 stage buffer
+  std::vector<char> encoded_;    // Base64 -> sink stage buffer
+  size_t content_length_;
+
+  void encode(const char *data, size_t size);
+  void transcode_with_iconv(const char *data, size_t size);
+
+  Base64ReadPipeline(const Base64ReadPipeline &) = delete;
+  Base64ReadPipeline &operator=(const Base64ReadPipeline &) = delete;
+};
+
 /**
  * Helper struct to track truncated lines with range compression.
  * Consecutive lines are compressed into ranges (e.g., "5-8, 12, 45-46").
@@ -25,6 +25,7 @@ export abstract class RpcClientApi implements IRpcClient {
 
     public core = {
         getInfo: this.rpc<core.GetInfoRequest, core.GetInfoResponse>("getInfo"),
+        getStats: this.rpc<core.GetStatsRequest, core.GetStatsResponse>("getStats"),
     };
 
     public ds = {
@@ -48,6 +49,7 @@ export abstract class RpcClientApi implements IRpcClient {
         holdJob: this.rpc<jobs.HoldJobRequest, jobs.HoldJobResponse>("holdJob"),
         listJobs: this.rpc<jobs.ListJobsRequest, jobs.ListJobsResponse>("listJobs"),
         listSpools: this.rpc<jobs.ListSpoolsRequest, jobs.ListSpoolsResponse>("listSpools"),
+        readAllSpools: this.rpc<jobs.ReadAllSpoolsRequest, jobs.ReadAllSpoolsResponse>("readAllSpools"),
         readSpool: this.rpc<jobs.ReadSpoolRequest, jobs.ReadSpoolResponse>("readSpool"),
         releaseJob: this.rpc<jobs.ReleaseJobRequest, jobs.ReleaseJobResponse>("releaseJob"),
         submitJcl: this.rpc<jobs.SubmitJclRequest, jobs.SubmitJclResponse>("submitJcl"),
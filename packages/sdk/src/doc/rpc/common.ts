@@ -357,3 +357,34 @@ export interface Spool {
      */
     procstep: string;
 }
+
+export interface CacheStats {
+    /**
+     * Cache name: "spoolFiles" (spool file lists of jobs), "iconv" (codepage converters) or "fifoPipes" (FIFO pipes of streamed requests)
+     */
+    name: string;
+    /**
+     * Lookups served from the cache
+     */
+    hits: number;
+    /**
+     * Lookups the cache could not serve
+     */
+    misses: number;
+    /**
+     * Entries dropped to stay within the size bounds of the cache, or found unusable
+     */
+    evictions: number;
+    /**
+     * Entries currently held
+     */
+    entries: number;
+    /**
+     * Entries dropped because they expired (optional)
+     */
+    expirations?: number;
+    /**
+     * Entries dropped because their source changed (optional)
+     */
+    invalidations?: number;
+}
@@ -23,3 +23,27 @@ export interface GetInfoResponse extends common.CommandResponse {
      */
     buildDate: string;
 }
+
+export interface GetStatsRequest extends common.CommandRequest<"getStats"> {}
+
+export interface GetStatsResponse extends common.CommandResponse {
+    /**
+     * Counters of the caches the server keeps across requests
+     */
+    caches: common.CacheStats[];
+}
+
+export interface SetFramingRequest extends common.CommandRequest<"setFraming"> {
+    /**
+     * How the data of inline reads and writes travels: as Base64 text in the JSON messages ("json"),
+     * or as raw bytes in binary frames tagged with the request id ("binary")
+     */
+    mode: "json" | "binary";
+}
+
+export interface SetFramingResponse extends common.CommandResponse {
+    /**
+     * The framing mode now in effect
+     */
+    mode: string;
+}
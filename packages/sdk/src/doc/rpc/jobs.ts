@@ -98,6 +98,50 @@ export interface ListSpoolsResponse extends common.CommandResponse {
     items: common.Spool[];
 }
 
+export interface ReadAllSpoolsRequest extends common.CommandRequest<"readAllSpools"> {
+    /**
+     * Desired encoding for the spool files (optional)
+     */
+    encoding?: string;
+    /**
+     * Source encoding of the spool file content (optional, defaults to UTF-8)
+     */
+    localEncoding?: string;
+    /**
+     * Total size of the spool file contents to return, in bytes (optional, defaults to 8 MB).
+     * Reading stops at the first spool file that would exceed it. That file and the ones after it are
+     * returned without contents and marked as `truncated`.
+     */
+    maxBytes?: number;
+    /**
+     * Job ID with spools to read from
+     */
+    jobId: string;
+}
+
+export interface SpoolContents extends common.Spool {
+    /**
+     * Spool contents, empty if the spool file was not read
+     */
+    data: B64String;
+    /**
+     * Whether the spool file was not read because its contents would exceed `maxBytes`; read it with `readSpool`
+     */
+    truncated: boolean;
+}
+
+export interface ReadAllSpoolsResponse extends common.CommandResponse {
+    /**
+     * Spool files of the job with their contents, in the order listSpools returns them
+     */
+    items: SpoolContents[];
+    /**
+     * Whether spool files were left out, because their contents would exceed `maxBytes` or the job has
+     * more spool files than are listed
+     */
+    truncated: boolean;
+}
+
 export interface ReadSpoolRequest extends common.CommandRequest<"readSpool"> {
     /**
      * Desired encoding for the spool file (optional)